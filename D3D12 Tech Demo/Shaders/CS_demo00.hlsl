@@ -273,14 +273,26 @@ void main(int3 sGroupTID : SV_GroupThreadID, int3 sDispatchTID : SV_DispatchThre
 			const float fRimDist = 110.8512516844081f - fMountMaxWidth;
 
 			// if camera y position is heigher than rim set this as rim
-			vOrigin += vDirect * max(fRimDist, vOrigin.y);
+			const float fRayStart = max(fRimDist, vOrigin.y);
+			vOrigin += vDirect * fRayStart;
+
+			// pixel angle by the ray of the pixel below, octaves by footprint
+			float3 vOriginY, vDirectY;
+			transform_ray(sDispatchTID.xy + uint2(0, 1), sViewport.zw, sCamPos, sWVPrInv, vOriginY, vDirectY);
+			const float fPixelAngle = length(vDirectY - vDirect);
 
 			if (vrc_fbm(
 				vOrigin,
 				normalize(vDirect),
 				fThit,
 				sAttr,
-				64))
+				64,
+				float2(.05f, 10.f),
+				1.f,
+				.7f,
+				0.f,
+				1000.f,
+				float2(fPixelAngle, fRayStart)))
 			{
 				float fFbmScale = .05f, fFbmScaleSimplex = .5f;
 				const float2 afFbmScale = float2(.05f, 10.f);
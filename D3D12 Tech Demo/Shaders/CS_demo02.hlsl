@@ -47,9 +47,15 @@ struct PosNormIx
 // hash 2 to 1
 float hash12(float2 vUv)
 {
+#if HASH_INTEGER
+	// hash of the float bits, no precision loss at large coordinates (x hashed first : the low
+	// mantissa bits are mostly zero, one linear combination of both would collide), FbmHash12() in zone_fbm.h
+	return float(hash_xx32(uint2(hash_xx32(uint2(asuint(vUv.x), 0u)), asuint(vUv.y))) >> 8) * (1.0 / 16777216.0);
+#else
 	float3 vP3 = frac(float3(vUv.xyx) * .1031);
 	vP3 += dot(vP3, vP3.yzx + 33.33);
 	return frac((vP3.x + vP3.y) * vP3.z);
+#endif
 }
 
 // simple heightmap function
@@ -60,8 +60,8 @@ void main(int3 sGroupTID : SV_GroupThreadID, int3 sDispatchTID : SV_DispatchThre
 	// the first tile is our base tile, set new position based on this tile
 	float2 sUV = sVBOut[uBaseI].sPosL.xz + avTilePos[uBufferTileI].xy;
 
-	// set terrain.. UV is our XY position
-	sVBOut[uTileI * sHexData.x + sHexData.x + uBaseI].sPosL.y = 0.f;
+	// set terrain.. UV is our XY position, y keeps the skirt depth of the base vertex
+	sVBOut[uTileI * sHexData.x + sHexData.x + uBaseI].sPosL.y = sVBOut[uBaseI].sPosL.y;
 	sVBOut[uTileI * sHexData.x + sHexData.x + uBaseI].sPosL.xz = sUV;
 
 
@@ -22,14 +22,20 @@ cbuffer sScene : register(b0)
 	float4 sCamPos;
 	/// camera velocity 3d vector (xyz - direction)
 	float4 sCamVelo;
+	/// inverse world-view-projection
+	float4x4 sWVPrInv;
+	/// hex data (x - number of vertices per hex tile, y - tiles instanced (1) or replicated (0), z - vertices packed (1), w - terrain by cpu (1))
+	uint4 sHexData;
 };
 
 Buffer<float4> avTilePos : register(t0);
+Buffer<float4> avTileTerrain : register(t1);
 
 struct In
 {
 	float3 sPosL  : POSITION;
 	float4 sCol   : COLOR;
+	uint   uTile  : TILE;
 };
 
 struct Out
@@ -40,7 +46,7 @@ struct Out
 	float3 sNormal : NORMAL;
 };
 
-Out main(in In sIn, in uint uVxIx : SV_VertexID, in uint uInstIx : SV_InstanceID)
+Out main(in In sIn, in uint uVxIx : SV_VertexID)
 {
 	Out sOut;
 
@@ -48,17 +54,39 @@ Out main(in In sIn, in uint uVxIx : SV_VertexID, in uint uInstIx : SV_InstanceID
 	// for some reason.... !!
 	//
 
+	// packed vertices (R16G16_SNORM position xz, R16G16_UNORM normalized distance, skirt) : derive color
+	if (sHexData.z)
+	{
+		float2 sXZ = sIn.sPosL.xy;
+		sIn.sPosL = float3(sXZ.x, -sIn.sCol.y, sXZ.y);
+		sIn.sCol = float4(sXZ, length(sXZ), sIn.sCol.x);
+	}
+
+	// skirt vertices (y = -1) hang below the terrain, deeper than the height step to a coarser neighbour
+	const float fSkirtDepth = .5f;
+	const float fSkirt = sIn.sPosL.y;
+
+	// instanced tiles : base tile + tile offset, tile index by instance stream (visible tiles)
+	if (sHexData.y) sIn.sPosL.xz += avTilePos[sIn.uTile].xy;
+
 	// compute terrain.. we later move that to the compute shader
 	const float2 afFbmScale = float2(.05f, 10.f);
 	float2 sUV = sIn.sPosL.xz;
 
-	// do the actual computation with fbm normal method
+	// terrain by cpu (height unscaled, normal per tile vertex) or the actual computation by analytic fbm derivatives
 	float fTerrain;
 	float3 vNormal;
-	fbm_normal(sUV * afFbmScale.x, 1.f, fTerrain, vNormal);
+	if (sHexData.w)
+	{
+		float4 sTerrain = avTileTerrain[sIn.uTile * sHexData.x + uVxIx];
+		fTerrain = sTerrain.x;
+		vNormal = sTerrain.yzw;
+	}
+	else
+		fbm_normal_der(sUV * afFbmScale.x, 1.f, fTerrain, vNormal);
 
 	// set terrain height, normal
-	sIn.sPosL.y = fTerrain * afFbmScale.y;
+	sIn.sPosL.y = fTerrain * afFbmScale.y + fSkirt * fSkirtDepth;
 	sOut.sNormal = vNormal;
 
 	// transform to homogeneous clip space, pass color
@@ -16,10 +16,31 @@
 #define PI 3.141592654f
 #define OCTAVES 6
 
-// random value
+// gradient hash : 1 - integer hash, 0 - sin hash (keep equal to FBM_HASH_INTEGER in zone_fbm.h)
+#ifndef HASH_INTEGER
+#define HASH_INTEGER 1
+#endif
+
+// xxhash32 of two words (Jarzynski, Olano : Hash Functions for GPU Rendering)
+uint hash_xx32(in uint2 vP)
+{
+	uint uH = vP.y + 374761393u + vP.x * 3266489917u;
+	uH = 668265263u * ((uH << 17) | (uH >> 15));
+	uH = 2246822519u * (uH ^ (uH >> 15));
+	uH = 3266489917u * (uH ^ (uH >> 13));
+	return uH ^ (uH >> 16);
+}
+
+// random value (vX - integral lattice coordinates)
 float2 hash(in float2 vX)
 {
+#if HASH_INTEGER
+	// 24 bit to [-1, 1), exact
+	float fH = float(hash_xx32(asuint(int2(vX))) >> 8) * (1.0 / 16777216.0);
+	return (-1.0 + 2.0 * fH).xx;
+#else
 	return -1.0 + 2.0 * frac(sin(dot(vX, float2(12.9898, 78.233))) * 43758.5453);
+#endif
 }
 
 // Simplex Noise
@@ -157,13 +178,11 @@ float3 fbm_der(in float2 vX, in float fH)
 	float fT = 0.0;
 	// derivatives value
 	float2 vD = float2(0., 0.);
-	// rotation matrix for derivatives
-	float2x2 afRot = float2x2(cos(0.5), sin(0.5), -sin(0.5), cos(0.5));
 	for (int nI = 0; nI < OCTAVES; nI++)
 	{
-		float3 vN = noised(fF * vX);
+		float3 vN = noised_der(fF * vX);
 		fT += fA * vN.x; // accumulate values
-		vD += fA * mul(vN.yz, afRot);  // accumulate derivatives
+		vD += (fA * fF) * vN.yz;  // accumulate derivatives (chain rule, octave frequency)
 		fF *= 2.0;
 		fA *= fG;
 	}
@@ -195,6 +214,104 @@ float fbm(in float2 vX, in float fH)
 	return fT;
 }
 
+// Fractional Brownian Motion, octave count at compile time (keep in sync with FbmN(), FbmDerN() in zone_fbm.h)
+//
+// FBM_OCTAVES_N(N) defines fbm_N() and fbm_der_N() : N octaves, unrolled, the last octave weighted by fLast
+//
+#define FBM_OCTAVES_N(N) \
+float fbm_##N(in float2 vX, in float fH, in float fLast) \
+{ \
+	float fG = exp2(-fH); \
+	float fF = 1.0, fA = 1.0; \
+	float fT = 0.0; \
+	[unroll] for (int nI = 0; nI < N; nI++) \
+	{ \
+		fT += ((nI == N - 1) ? fA * fLast : fA) * noised(fF * vX); \
+		fF *= 2.0; \
+		fA *= fG; \
+	} \
+	return fT; \
+} \
+float3 fbm_der_##N(in float2 vX, in float fH, in float fLast) \
+{ \
+	float fG = exp2(-fH); \
+	float fF = 1.0, fA = 1.0; \
+	float fT = 0.0; \
+	float2 vD = float2(0., 0.); \
+	[unroll] for (int nI = 0; nI < N; nI++) \
+	{ \
+		float fW = (nI == N - 1) ? fA * fLast : fA; \
+		float3 vN = noised_der(fF * vX); \
+		fT += fW * vN.x; \
+		vD += (fW * fF) * vN.yz; \
+		fF *= 2.0; \
+		fA *= fG; \
+	} \
+	return float3(fT, vD); \
+}
+
+#if OCTAVES != 6
+#error fbm.hlsli : one FBM_OCTAVES_N() and one fbm_lod() case per octave count
+#endif
+FBM_OCTAVES_N(1)
+FBM_OCTAVES_N(2)
+FBM_OCTAVES_N(3)
+FBM_OCTAVES_N(4)
+FBM_OCTAVES_N(5)
+FBM_OCTAVES_N(6)
+
+// octave count for a pixel footprint (world size of a pixel : distance * pixel angle)
+//
+// octave k has a lattice cell of 1 / (fFbmScale 2^k) world units and is kept while the cell
+// spans fCellPixels pixels or more, fractional (the last octave fades in), in [1, OCTAVES]
+//
+float fbm_octaves(in float fFootprint, in float fFbmScale, in float fCellPixels = 2.f)
+{
+	if (fFootprint <= 0.f) return OCTAVES;
+	return clamp(1.f - log2(fFbmScale * fCellPixels * fFootprint), 1.f, OCTAVES);
+}
+
+// split a fractional octave count to the specialisation (ceil) and the weight of its last octave
+//
+int fbm_octave_split(in float fOctaves, out float fLast)
+{
+	float fN = clamp(ceil(fOctaves), 1.f, OCTAVES);
+	fLast = saturate(fOctaves - (fN - 1.f));
+	return (int)fN;
+}
+
+// fbm of a fractional octave count (see fbm_octaves()), equals fbm() for OCTAVES
+//
+float fbm_lod(in float2 vX, in float fH, in float fOctaves)
+{
+	float fLast;
+	switch (fbm_octave_split(fOctaves, fLast))
+	{
+	case 1: return fbm_1(vX, fH, fLast);
+	case 2: return fbm_2(vX, fH, fLast);
+	case 3: return fbm_3(vX, fH, fLast);
+	case 4: return fbm_4(vX, fH, fLast);
+	case 5: return fbm_5(vX, fH, fLast);
+	default: return fbm_6(vX, fH, fLast);
+	}
+}
+
+// fbm and derivatives of a fractional octave count, equals fbm_der() for OCTAVES
+//
+float3 fbm_der_lod(in float2 vX, in float fH, in float fOctaves)
+{
+	float fLast;
+	switch (fbm_octave_split(fOctaves, fLast))
+	{
+	case 1: return fbm_der_1(vX, fH, fLast);
+	case 2: return fbm_der_2(vX, fH, fLast);
+	case 3: return fbm_der_3(vX, fH, fLast);
+	case 4: return fbm_der_4(vX, fH, fLast);
+	case 5: return fbm_der_5(vX, fH, fLast);
+	default: return fbm_der_6(vX, fH, fLast);
+	}
+}
+
 // heightmap normal calculation helper
 //
 void fbm_normal(in float2 vX, in float fH, out float fTerrain, out float3 vNormal, in float fSquareHalf = .02f)
@@ -212,6 +329,25 @@ void fbm_normal(in float2 vX, in float fH, out float fTerrain, out float3 vNorma
 	vNormal = normalize(cross(vTangent, vBitangent));
 }
 
+// heightmap normal by analytic derivatives (one fbm_der instead of four fbm),
+// equals fbm_normal for fSquareHalf -> 0 (fR - fL = -2s dx, fD - fU = -2s dy)
+//
+void fbm_normal_der(in float2 vX, in float fH, out float fTerrain, out float3 vNormal, in float fSquareHalf = .02f)
+{
+	float3 vT = fbm_der(vX, fH);
+	fTerrain = vT.x;
+	vNormal = normalize(float3(-fSquareHalf * vT.y, -1.0, -fSquareHalf * vT.z));
+}
+
+// fbm_normal_der() of a fractional octave count (see fbm_octaves())
+//
+void fbm_normal_der_lod(in float2 vX, in float fH, in float fOctaves, out float fTerrain, out float3 vNormal, in float fSquareHalf = .02f)
+{
+	float3 vT = fbm_der_lod(vX, fH, fOctaves);
+	fTerrain = vT.x;
+	vNormal = normalize(float3(-fSquareHalf * vT.y, -1.0, -fSquareHalf * vT.z));
+}
+
 // phong constants
 static const float4 sDiffuseAlbedo = { .9f, .9f, 1.f, 1.0f };
 static const float3 sFresnelR0 = { 0.01f, 0.01f, 0.01f };
@@ -62,6 +62,59 @@ float2 HexXY(float2 vUv)
 	return float2((vUv.x * 3.f - vUv.y * 1.5f) / sqrt(3.f), vUv.y * 1.5f);
 }
 
+// hex tile index (spiral) : 0 = origin, ring r > 0 holds 6 * r tiles starting at index 1 + 3 * r * (r - 1)
+// index = 1 + 3 * r * (r - 1) + 6 * step + side,  cube = r * direction(side) + step * direction(side + 2)
+
+/// cube directions to the 6 neighbours
+static const int3 aiHexDirections[6] = { int3(1, 0, -1), int3(0, 1, -1), int3(-1, 1, 0), int3(-1, 0, 1), int3(0, -1, 1), int3(1, -1, 0) };
+
+/// tile index to ring coordinates (x - ring, y - side, z - step), O(1)
+uint3 HexRingFromIndex(uint uIx)
+{
+	if (uIx == 0) return uint3(0, 0, 0);
+
+	// estimate ring by sqrt, correct rounding
+	uint uK = uIx - 1;
+	uint uR = uint((3.f + sqrt(9.f + 12.f * float(uK))) / 6.f);
+	if (3 * uR * (uR - 1) > uK) uR--;
+	if (3 * uR * (uR + 1) <= uK) uR++;
+
+	uint uJ = uK - 3 * uR * (uR - 1);
+	return uint3(uR, uJ % 6, uJ / 6);
+}
+
+/// ring coordinates (x - ring, y - side, z - step) to tile index
+uint HexIndexFromRing(uint3 vRing)
+{
+	return (vRing.x == 0) ? 0 : 1 + 3 * vRing.x * (vRing.x - 1) + 6 * vRing.z + vRing.y;
+}
+
+/// ring coordinates to cube coordinates
+int3 HexCubeFromRing(uint3 vRing)
+{
+	return aiHexDirections[vRing.y % 6] * int(vRing.x) + aiHexDirections[(vRing.y + 2) % 6] * int(vRing.z);
+}
+
+/// cube coordinates to ring coordinates
+uint3 HexRingFromCube(int3 vCube)
+{
+	int nR = (abs(vCube.x) + abs(vCube.y) + abs(vCube.z)) / 2;
+	if (nR == 0) return uint3(0, 0, 0);
+	if ((vCube.z == -nR) && (vCube.y < nR)) return uint3(nR, 0, vCube.y);
+	if ((vCube.y == nR) && (vCube.x > -nR)) return uint3(nR, 1, -vCube.x);
+	if ((vCube.x == -nR) && (vCube.z < nR)) return uint3(nR, 2, vCube.z);
+	if ((vCube.z == nR) && (vCube.y > -nR)) return uint3(nR, 3, -vCube.y);
+	if ((vCube.y == -nR) && (vCube.x < nR)) return uint3(nR, 4, vCube.x);
+	return uint3(nR, 5, -vCube.z);
+}
+
+/// cartesian offset of a tile by index (size = corner radius)
+float2 HexTileOffset(uint uIx, float fSize)
+{
+	int3 vCube = HexCubeFromRing(HexRingFromIndex(uIx));
+	return fSize * float2(sqrt(3.f) * (float(vCube.x) + float(vCube.y) * .5f), 1.5f * float(vCube.y));
+}
+
 // provide hex grid
 float HexGrid(float2 vPt)
 {
@@ -187,6 +240,10 @@ inline void transform_ray(in uint2 sIndex, in float2 sScreenSz, in float4 vCamPo
 }
 
 // Volume Ray Casting - Fractal Brownian Motion
+//
+// afPixel - x : pixel angle (pixel size at distance 1), y : distance of vOri to the eye,
+//           octave count by the pixel footprint along the ray (see fbm_octaves()), x = 0 : all octaves
+//
 bool vrc_fbm(
 	in float3 vOri,
 	in float3 vDir,
@@ -197,11 +254,13 @@ bool vrc_fbm(
 	in const float fH = 1.f,
 	in const float fStepAdjust = .7f,
 	in const float fTMin = 0.f,
-	in const float fTMax = 1000.f)
+	in const float fTMax = 1000.f,
+	in const float2 afPixel = float2(0.f, 0.f))
 {
 	const float fThreshold = 0.00001;
 	float fT = fTMin;
-	float fStep = vOri.y - (fbm(vOri.xz * afFbmScale.x, fH) * afFbmScale.y);
+	float fOctaves = fbm_octaves((afPixel.y + fT) * afPixel.x, afFbmScale.x);
+	float fStep = vOri.y - (fbm_lod(vOri.xz * afFbmScale.x, fH, fOctaves) * afFbmScale.y);
 	float3 vPos = vOri;
 	
 	// march through the AABB
@@ -209,7 +268,8 @@ bool vrc_fbm(
 	while (uI++ < uMax && fT <= fTMax)
 	{
 		vPos += fStep * vDir;
-		float fDist = vPos.y - (fbm(vPos.xz * afFbmScale.x, fH) * afFbmScale.y);
+		fOctaves = fbm_octaves((afPixel.y + fT) * afPixel.x, afFbmScale.x);
+		float fDist = vPos.y - (fbm_lod(vPos.xz * afFbmScale.x, fH, fOctaves) * afFbmScale.y);
 
 		// intersection ?
 		if (fDist <= fThreshold * fT)
@@ -226,7 +286,7 @@ bool vrc_fbm(
 
 				// calculate normal
 				float3 vNormal;
-				fbm_normal(vPos.xz * afFbmScale.x, fH, vPos.y, sAttr.vNormal);
+				fbm_normal_der_lod(vPos.xz * afFbmScale.x, fH, fOctaves, vPos.y, sAttr.vNormal);
 				vPos.y *= afFbmScale.y;
 
 				// set position
@@ -9,8 +9,14 @@
 #include <stdio.h>
 #include <string>
 #include <thread>
-#include <future>
+#include <vector>
 #include <array>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include "app_jobs.h"
+#include "app_timer.h"
 
 typedef unsigned uint;
 typedef struct { float x, y; } float2;
@@ -35,151 +41,27 @@ constexpr std::wstring_view s_atAppname = L"D3D12 Tech Demo";
 #define APP_PAUSE S_FALSE
 #define APP_QUIT E_ABORT
 #define APP_ERROR E_FAIL
+#elif defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#define TRACE_UINT(a) { fprintf(stderr, "%s:%u:0x%x\n", #a, (unsigned)(a), (unsigned)(a)); }
+#define TRACE_HEX(a) { fprintf(stderr, "%s:%x\n", #a, (unsigned)(a)); }
+#define TRACE_ERROR(a) { fprintf(stderr, "Error %s:%x\n", #a, (unsigned)(a)); }
+#define TRACE_FLOAT(a) { fprintf(stderr, "%s:%f\n", #a, (double)(a)); }
+#define TRACE_CODE { fprintf(stderr, "(%u) : %s\n", (unsigned)__LINE__, __func__); }
+// same values as the HRESULT codes on Windows
+#define APP_FORWARD 0
+#define APP_PAUSE 1
+#define APP_QUIT ((signed)0x80004004)
+#define APP_ERROR ((signed)0x80004005)
+/// <summary>debug output (stderr)</summary>
+inline void OutputDebugStringA(const char* atText) { fputs(atText, stderr); }
 #else 
 #error "OS not supported!"
 #endif
 
-#ifdef _WIN64
-#define GameTimer game_timer
-
-/// <summary>Game Time simple helper</summary>
-class game_timer
-{
-public:
-	/// <summary>get the frequency here</summary>
-	game_timer()
-	{
-		// get timer frequency
-		__int64 n64Frequency;
-		QueryPerformanceFrequency((LARGE_INTEGER*)&n64Frequency);
-		m_dTicksInSeconds = 1.0 / (double)n64Frequency;
-
-		// init timer
-		__int64 nCurrTime;
-		QueryPerformanceCounter((LARGE_INTEGER*)&nCurrTime);
-
-		m_nBaseTime = nCurrTime;
-		m_nPrevTime = nCurrTime;
-		m_nStopTime = 0;
-		m_bStopped = false;
-
-	}
-
-	/// <summary>Restart</summary>
-	void restart()
-	{
-		__int64 nStartTime;
-		QueryPerformanceCounter((LARGE_INTEGER*)&nStartTime);
-
-		if (m_bStopped)
-		{
-			m_nPausedTime += (nStartTime - m_nStopTime);
-
-			m_nPrevTime = nStartTime;
-			m_nStopTime = 0;
-			m_bStopped = false;
-		}
-	}
-	/// <summary>Pause</summary>
-	void pause()
-	{
-		if (!m_bStopped)
-		{
-			__int64 nCurrTime;
-			QueryPerformanceCounter((LARGE_INTEGER*)&nCurrTime);
-
-			m_nStopTime = nCurrTime;
-			m_bStopped = true;
-		}
-	}
-	/// <summary>New frame</summary>
-	void tick()
-	{
-		static int s_nFramesThisSecond = 0;
-		static int s_nFramesTotal = 0;
-		static float s_fSecondsCounter = 0.0f;
-
-		// increment frame counter for this second
-		s_nFramesThisSecond++;
-
-		// stopped ?
-		if (m_bStopped)
-		{
-			m_dDelta = 0.0;
-			m_fTotal = (float)(((m_nStopTime - m_nPausedTime) - m_nBaseTime) * m_dTicksInSeconds);
-			return;
-		}
-
-		// get counter
-		__int64 nCurrTime;
-		QueryPerformanceCounter((LARGE_INTEGER*)&nCurrTime);
-		m_nCurrTime = nCurrTime;
-
-		// set total
-		m_fTotal = (float)(((m_nCurrTime - m_nPausedTime) - m_nBaseTime) * m_dTicksInSeconds);
-
-		// set delta
-		m_dDelta = (m_nCurrTime - m_nPrevTime) * m_dTicksInSeconds;
-		m_fDelta = (float)m_dDelta;
-
-		// set previous frame time
-		m_nPrevTime = m_nCurrTime;
-
-		// clamp positive
-		if (m_dDelta < 0.0)	m_dDelta = 0.0;
-
-		// set fps if new second
-		if ((m_fTotal - s_fSecondsCounter) >= 1.0f)
-		{
-			// set total frames
-			s_nFramesTotal += s_nFramesThisSecond;
-
-			// calc fps
-			m_fFPSTotal = (float)s_nFramesThisSecond;
-			m_fFPS = s_nFramesThisSecond / (m_fTotal - s_fSecondsCounter);
-
-			// reset
-			s_nFramesThisSecond = 0;
-			s_fSecondsCounter += 1.0f;
-		}
-	}
-
-	/// <summary>Total time</summary>
-	float total() { return m_fTotal; }
-	/// <summary>Timer delta in seconds</summary>
-	float delta() { return m_fDelta; }
-	/// <summary>Frames per second, total</summary>
-	float fps_total() { return m_fFPSTotal; }
-	/// <summary>Frames per second</summary>
-	float fps() { return m_fFPS; }
-
-private:
-	/// <summary>Total time</summary>
-	float m_fTotal;
-	/// <summary>Timer delta in seconds</summary>
-	float m_fDelta;
-	/// <summary>Frames per second, total</summary>
-	float m_fFPSTotal;
-	/// <summary>Frames per second</summary>
-	float m_fFPS;
-	/// <summary>Ticks in seconds game timer helper</summary>
-	double m_dTicksInSeconds;
-	/// <summary>Timer delta (double)</summary>
-	double m_dDelta;
-	/// <summary>Timer base.</summary>
-	__int64 m_nBaseTime;
-	/// <summary>Timer pause time helper.</summary>
-	__int64 m_nPausedTime;
-	/// <summary>Timer stop time helper.</summary>
-	__int64 m_nStopTime;
-	/// <summary>Timer previous time helper.</summary>
-	__int64 m_nPrevTime;
-	/// <summary>Timer current time helper.</summary>
-	__int64 m_nCurrTime;
-	/// <summary>True if the timer is stopped.</summary>
-	bool m_bStopped;
-};
+#include "app_input.h"
 
+#ifdef _WIN64
 /// <summary>Trace error</summary>
 inline signed ThrowIfFailed(HRESULT nHr)
 {
@@ -190,9 +72,6 @@ inline signed ThrowIfFailed(HRESULT nHr)
 	}
 	return APP_FORWARD;
 }
-
-#else 
-#error "OS not supported!"
 #endif
 
 /// <summary>
@@ -208,11 +87,58 @@ struct AppData
 	float fFPSTotal;
 	/// <summary>Frames per second</summary>
 	float fFPS;
+	/// <summary>Frame number</summary>
+	uint64_t uFrame;
+	/// <summary>Job system, tasks may spawn jobs or execute parallel loops</summary>
+	App_Jobsystem* pcJobs;
 };
 
 #define FUNC_GAME_TASK(task) static signed task(AppData& sData)
 typedef signed(*GAME_TASK)(AppData& sData);
 
+/// <summary>
+/// Resources shared by game tasks, a task declares the resources it reads and writes.
+/// </summary>
+enum AppResource : unsigned
+{
+	APP_RES_NONE = 0,
+	/// <summary>scene state (camera, demo mode, tile positions)</summary>
+	APP_RES_SCENE = 1 << 0,
+	/// <summary>render frame : shader constants, upload buffers and the scene state handed over to render</summary>
+	APP_RES_CONSTANTS = 1 << 1,
+	/// <summary>command list, command queue, swapchain</summary>
+	APP_RES_CMDLIST = 1 << 2,
+	/// <summary>os message queue and window</summary>
+	APP_RES_OSQUEUE = 1 << 3,
+	/// <summary>audio output</summary>
+	APP_RES_AUDIO = 1 << 4,
+};
+
+/// <summary>
+/// Game task and its dependencies (resources read/written).
+/// A plain GAME_TASK converts to a task without declared resources.
+/// </summary>
+struct AppTask
+{
+	AppTask(GAME_TASK pfTask, unsigned uRd = APP_RES_NONE, unsigned uWr = APP_RES_NONE, bool bMain = false)
+		: pfTask(pfTask), uRd(uRd), uWr(uWr), bMain(bMain) {}
+
+	/// <summary>true if one of both tasks writes a resource the other one reads or writes</summary>
+	bool Conflicts(const AppTask& sOther) const
+	{
+		return ((sOther.uWr & (uRd | uWr)) != 0) || ((sOther.uRd & uWr) != 0);
+	}
+	/// <summary>true if no resources declared</summary>
+	bool Undeclared() const { return !(uRd | uWr); }
+
+	/// <summary>task function</summary>
+	GAME_TASK pfTask;
+	/// <summary>resources read, resources written (AppResource flags)</summary>
+	unsigned uRd, uWr;
+	/// <summary>true if the task has to execute on the main thread (window owner)</summary>
+	bool bMain;
+};
+
 /// <summary>
 /// App Basics Parent Class.
 /// </summary>
@@ -222,15 +148,17 @@ public:
 	static constexpr unsigned INIT = 0;
 	static constexpr unsigned RUNTIME = 1;
 	static constexpr unsigned DESTROY = 2;
+	/// <summary>maximum number of runtime frames executed simultanely</summary>
+	static constexpr unsigned FRAMES_IN_FLIGHT = 2;
 
 	explicit App_Taskhandler(
-		std::vector<std::vector<GAME_TASK>>& aavTasks_Init,
-		std::vector<std::vector<GAME_TASK>>& aavTasks_Runtime,
-		std::vector<std::vector<GAME_TASK>>& aavTasks_Destroy
+		std::vector<std::vector<AppTask>>& aasTasks_Init,
+		std::vector<std::vector<AppTask>>& aasTasks_Runtime,
+		std::vector<std::vector<AppTask>>& aasTasks_Destroy
 	)
 	{
 		// add tasks
-		Add(aavTasks_Init, aavTasks_Runtime, aavTasks_Destroy);
+		Add(aasTasks_Init, aasTasks_Runtime, aasTasks_Destroy);
 	}
 	virtual ~App_Taskhandler() {}
 
@@ -241,56 +169,35 @@ protected:
 	/// </summary>
 	/// <param name="bInsertFirst">true if taskblocks should be inserted at begin</param>
 	void Add(
-		std::vector<std::vector<GAME_TASK>>& aavTasks_Init,
-		std::vector<std::vector<GAME_TASK>>& aavTasks_Runtime,
-		std::vector<std::vector<GAME_TASK>>& aavTasks_Destroy,
+		std::vector<std::vector<AppTask>>& aasTasks_Init,
+		std::vector<std::vector<AppTask>>& aasTasks_Runtime,
+		std::vector<std::vector<AppTask>>& aasTasks_Destroy,
 		bool bInsertFirst = false
 	)
 	{
-		// pointer helpers for following operation
-		std::vector<std::vector<GAME_TASK>>* paav = nullptr;
-		std::vector<std::vector<std::packaged_task<signed(AppData&)>>>* paac = nullptr;
+		// pointer helper for following operation
+		std::vector<std::vector<AppTask>>* paas = nullptr;
 
-		// create lists of task blocks
+		// add task blocks to the lists
 		for (unsigned uIx : {INIT, RUNTIME, DESTROY})
 		{
-			// set helper pointers
+			// set helper pointer
 			switch (uIx)
 			{
-			case INIT:
-				paav = &aavTasks_Init;
-				paac = &m_aacTasks_Init;
-				break;
-			case RUNTIME:
-				paav = &aavTasks_Runtime;
-				paac = &m_aacTasks_Runtime;
-				break;
-			case DESTROY:
-				paav = &aavTasks_Destroy;
-				paac = &m_aacTasks_Destroy;
-				break;
+			case INIT: paas = &aasTasks_Init; break;
+			case RUNTIME: paas = &aasTasks_Runtime; break;
+			case DESTROY: paas = &aasTasks_Destroy; break;
 			default: continue; break;
 			}
 
-			// loop through task functions
-			for (std::vector<GAME_TASK>& av : *paav)
-			{
-
-				// create task block and add to list
-				std::vector<std::packaged_task<signed(AppData&)>> acTaskblock;
-				for (GAME_TASK& v : av)
-					acTaskblock.push_back(std::packaged_task<signed(AppData&)>(v));
-
-				// add the block at begin (?)
-				if (bInsertFirst)
-					paac->insert(paac->begin(), std::move(acTaskblock));
-				else
-					paac->push_back(std::move(acTaskblock));
-			}
+			// add the blocks at begin (?), graph needs to be rebuilt
+			Graph& sGraph = m_asGraphs[uIx];
+			sGraph.aasBlocks.insert(bInsertFirst ? sGraph.aasBlocks.begin() : sGraph.aasBlocks.end(), paas->begin(), paas->end());
+			sGraph.asNodes.clear();
 		}
-		aavTasks_Init.clear();
-		aavTasks_Runtime.clear();
-		aavTasks_Destroy.clear();
+		aasTasks_Init.clear();
+		aasTasks_Runtime.clear();
+		aasTasks_Destroy.clear();
 	}
 
 	/// <summary>
@@ -298,100 +205,416 @@ protected:
 	/// </summary>
 	void Run()
 	{
-		AppData sAppData = {};
-		std::vector<std::vector<std::packaged_task<signed(AppData&)>>>* paac = nullptr;
 		signed nFuture = APP_FORWARD;
 
 		// restart the game timer
 		m_cTimer.restart();
 
-		// execute lists of task blocks
+		// execute task graphs
 		for (unsigned uIx : {INIT, RUNTIME, DESTROY})
 		{
 			// any error present ?
 			if (nFuture != APP_ERROR) nFuture = APP_FORWARD;
 
-			// set helper pointer
-			switch (uIx)
+			// measure the runtime list
+			const uint64_t uFrameIx = m_uFrameIx;
+			const int64_t nStart = GameTimer::now();
+			nFuture = Execute(uIx, nFuture);
+			if (uIx == RUNTIME)
 			{
-			case INIT: paac = &m_aacTasks_Init; break;
-			case RUNTIME: paac = &m_aacTasks_Runtime; break;
-			case DESTROY: paac = &m_aacTasks_Destroy; break;
-			default: continue; break;
+				m_uRuntimeFrameN = m_uFrameIx - uFrameIx;
+				m_dRuntimeSec = (double)(GameTimer::now() - nStart) * 1e-9;
+			}
+		}
+
+		// fixed timestep ? trace throughput
+		if (m_uFixedFrameN)
+		{
+			GameTimer::frame_stats sStats = m_cTimer.stats();
+			char atBuf[256];
+			snprintf(atBuf, sizeof(atBuf), "App_Taskhandler : %llu frames in %.3f s, %.1f frames/s (frame time p50 %.3f ms p99 %.3f ms)\n",
+				(unsigned long long)m_uRuntimeFrameN, m_dRuntimeSec, Throughput(), sStats.fP50, sStats.fP99);
+			OutputDebugStringA(atBuf);
+		}
+	}
+
+	/// <summary>
+	/// Fixed timestep mode (deterministic, call before Run()) : each frame advances the app time
+	/// by fDelta, the runtime list quits after uFrameN frames, frames are not paced.
+	/// uFrameN = 0 : wall clock time (default)
+	/// </summary>
+	void FixedStep(float fDelta, uint64_t uFrameN)
+	{
+		m_fFixedDelta = fDelta;
+		m_uFixedFrameN = uFrameN;
+	}
+
+	/// <summary>throughput of the last runtime list : frames per second (wall clock)</summary>
+	double Throughput() const { return (m_dRuntimeSec > 0.) ? (double)m_uRuntimeFrameN / m_dRuntimeSec : 0.; }
+
+	/// <summary>critical path (longest chain of dependent tasks) of the last frame executed, in milliseconds</summary>
+	double CriticalPath_Ms(unsigned uIx) const
+	{
+		const Graph& sGraph = m_asGraphs[uIx % 3];
+		std::vector<double> adEnd(sGraph.asNodes.size(), 0.);
+		double dPath = 0.;
+		for (size_t uI(0); uI < sGraph.asNodes.size(); uI++)
+		{
+			// predecessors are always declared before (lower index)
+			adEnd[uI] += sGraph.asNodes[uI].dMs;
+			for (unsigned uS : sGraph.asNodes[uI].auSucc)
+				adEnd[uS] = (std::max)(adEnd[uS], adEnd[uI]);
+			dPath = (std::max)(dPath, adEnd[uI]);
+		}
+		return dPath;
+	}
+
+	/// <summary>provide job system</summary>
+	const App_Jobsystem& Jobs() const { return m_cJobs; }
+	/// <summary>provide game timer (frame time statistics)</summary>
+	const GameTimer& Timer() const { return m_cTimer; }
+
+private:
+	/// <summary>task graph node</summary>
+	struct Node
+	{
+		AppTask sTask;
+		/// <summary>task block index</summary>
+		unsigned uBlock;
+		/// <summary>number of predecessors in the same frame, in the previous frame</summary>
+		unsigned uPredN, uPrevN;
+		/// <summary>successors in the same frame, successors in the next frame</summary>
+		std::vector<unsigned> auSucc, auNext;
+		/// <summary>execution time of the last frame</summary>
+		double dMs;
+	};
+	/// <summary>task blocks and the dependency graph built of them</summary>
+	struct Graph
+	{
+		std::vector<std::vector<AppTask>> aasBlocks;
+		std::vector<Node> asNodes;
+	};
+	/// <summary>task slot of a frame, preallocated per list</summary>
+	struct Slot
+	{
+		/// <summary>unfinished predecessors</summary>
+		std::atomic<unsigned> uWait = 0;
+		/// <summary>handover to the next frame, the second one to increment releases the successors</summary>
+		std::atomic<unsigned> uHandover = 0;
+		/// <summary>true if blocked by a predecessor (paused, skipped)</summary>
+		std::atomic<bool> bBlocked = false;
+		/// <summary>task result</summary>
+		signed nResult = APP_FORWARD;
+	};
+	/// <summary>frame in flight</summary>
+	struct Frame
+	{
+		/// <summary>app data of this frame</summary>
+		AppData sData = {};
+		std::atomic<bool> bActive = false;
+		/// <summary>number of slots done</summary>
+		std::atomic<unsigned> uDoneN = 0;
+		std::unique_ptr<Slot[]> asSlots;
+	};
+	/// <summary>slot of a frame</summary>
+	struct FrameNode { unsigned uF, uN; };
+
+	/// <summary>
+	/// Build the dependency graph of a task list.
+	/// Each task block waits for the whole previous block, tasks within a block are
+	/// ordered by their declaration if they conflict (one writes what the other one
+	/// reads or writes). The first task of each block executes on the main thread.
+	/// In the next frame a task waits for itself and all conflicting tasks of the previous frame,
+	/// if more than one block or undeclared tasks are present the next frame waits for the whole frame.
+	/// </summary>
+	static void Build(Graph& sGraph)
+	{
+		if (!sGraph.asNodes.empty()) return;
+
+		// flatten the blocks
+		bool bBarrier = (sGraph.aasBlocks.size() > 1);
+		for (unsigned uB(0); uB < (unsigned)sGraph.aasBlocks.size(); uB++)
+			for (size_t uI(0); uI < sGraph.aasBlocks[uB].size(); uI++)
+			{
+				Node sNode = { sGraph.aasBlocks[uB][uI], uB, 0, 0, {}, {}, 0. };
+				sNode.sTask.bMain |= (uI == 0);
+				bBarrier |= sNode.sTask.Undeclared();
+				sGraph.asNodes.push_back(sNode);
 			}
 
-			do
+		// add edges
+		for (unsigned uJ(0); uJ < (unsigned)sGraph.asNodes.size(); uJ++)
+		{
+			Node& sJ = sGraph.asNodes[uJ];
+			for (unsigned uI(0); uI < (unsigned)sGraph.asNodes.size(); uI++)
 			{
-				// update game timer and app data
-				m_cTimer.tick();
-				sAppData.fDelta = m_cTimer.delta();
-				sAppData.fFPS = m_cTimer.fps();
-				sAppData.fFPSTotal = m_cTimer.fps_total();
-				sAppData.fTotal = m_cTimer.total();
-
-				// loop through task blocks
-				for (std::vector<std::packaged_task<signed(AppData&)>>& aac : *paac)
+				Node& sI = sGraph.asNodes[uI];
+				if ((uI < uJ) && ((sI.uBlock < sJ.uBlock) || sI.sTask.Conflicts(sJ.sTask)))
 				{
-					// pause this task block ?
-					if (nFuture == APP_PAUSE) continue;
-
-					// error or quit ?
-					if (((nFuture == APP_ERROR) || (nFuture == APP_QUIT)) && (uIx != DESTROY)) continue;
-
-					// loop through tasks
-					std::vector<std::future<signed>> acFutures;
-					for (std::packaged_task<signed(AppData&)>& ac : aac)
-					{
-						// reset task, add future
-						ac.reset();
-						acFutures.push_back(ac.get_future());
-
-						// execute
-						ac(sAppData);
-					}
-
-					// loop through futures to synchronize
-					for (std::future<signed>& cFuture : acFutures)
-					{
-						signed nFutureCurrent = cFuture.get();
-						switch (nFutureCurrent)
-						{
-						case APP_FORWARD: break;
-						case APP_PAUSE:
-							if ((nFuture != APP_ERROR) && (nFuture != APP_QUIT))
-								nFuture = nFutureCurrent;
-							break;
-						case APP_QUIT:
-							if (nFuture != APP_ERROR)
-								nFuture = nFutureCurrent;
-							break;
-						case APP_ERROR:
-							nFuture = nFutureCurrent;
-							break;
-						default: break;
-						}
-					}
+					sI.auSucc.push_back(uJ);
+					sJ.uPredN++;
 				}
+				if (bBarrier || (uI == uJ) || sI.sTask.Conflicts(sJ.sTask))
+				{
+					sI.auNext.push_back(uJ);
+					sJ.uPrevN++;
+				}
+			}
+		}
+	}
 
-				// end pause
-				if (nFuture == APP_PAUSE) nFuture = APP_FORWARD;
+	/// <summary>
+	/// Execute the task graph of a list (INIT, RUNTIME : until quit or error, DESTROY).
+	/// Tasks start as soon as their predecessors are done, tasks of the next runtime frame
+	/// may start while the current frame executes.
+	/// A task returning APP_PAUSE skips its successors in this frame,
+	/// APP_QUIT or APP_ERROR skip all pending tasks (not in DESTROY list).
+	/// Slots are allocated here, the frame loop itself does not allocate.
+	/// </summary>
+	signed Execute(unsigned uIx, signed nStatus)
+	{
+		Graph& sGraph = m_asGraphs[uIx];
+		Build(sGraph);
+		const unsigned uNodeN = (unsigned)sGraph.asNodes.size();
+		if (!uNodeN) return nStatus;
+
+		// prepare frames and main thread queue
+		m_psGraph = &sGraph;
+		m_uList = uIx;
+		m_uFrameN = (uIx == RUNTIME) ? FRAMES_IN_FLIGHT : 1;
+		m_uActiveN = 0;
+		m_nStatus = nStatus;
+		m_bStop = (nStatus == APP_QUIT) || (nStatus == APP_ERROR);
+		for (Frame& sF : m_asFrames)
+		{
+			sF.bActive = false;
+			sF.asSlots = std::make_unique<Slot[]>(uNodeN);
+		}
+		m_uMainSz = FRAMES_IN_FLIGHT * uNodeN;
+		m_asMain = std::make_unique<FrameNode[]>(m_uMainSz);
+		m_uMainHead = m_uMainTail = 0;
+
+		// runtime list : until quit, error or the fixed number of frames is started
+		unsigned uFrameCnt = 0;
+		auto fRunning = [&]() { return !m_bStop.load() && (!m_uFixedFrameN || (uFrameCnt < m_uFixedFrameN)); };
+		for (;;)
+		{
+			// start next frame(s), INIT and DESTROY list execute once
+			while (((uIx == RUNTIME) ? fRunning() : (uFrameCnt == 0)) && !m_asFrames[m_uFrameIx % m_uFrameN].bActive)
+			{
+				Begin(m_uFrameIx % m_uFrameN);
+				m_uFrameIx++;
+				uFrameCnt++;
+			}
 
-			} while ((uIx == RUNTIME) && (nFuture != APP_QUIT) && (nFuture != APP_ERROR));
+			// execute main thread task or help out
+			FrameNode sFN = {};
+			if (PopMain(sFN))
+				Process(sFN);
+			else if (!m_uActiveN && ((uIx == RUNTIME) ? !fRunning() : (uFrameCnt > 0)))
+				break;
+			else if (!m_cJobs.Help())
+				std::this_thread::yield();
 		}
+
+		m_cJobs.Wait(m_uPending);
+		return m_nStatus;
 	}
 
-private:
+	/// <summary>start a frame (main thread)</summary>
+	void Begin(unsigned uF)
+	{
+		Frame& sF = m_asFrames[uF];
+		Frame& sPrev = m_asFrames[(uF + m_uFrameN - 1) % m_uFrameN];
+		const std::vector<Node>& asNodes = m_psGraph->asNodes;
+		const bool bPrev = (m_uFrameN > 1) && sPrev.bActive.load(std::memory_order_acquire);
+
+		// update game timer and app data (fixed timestep : simulated time, the timer keeps the wall clock statistics)
+		m_cTimer.tick();
+		if (m_uFixedFrameN)
+		{
+			sF.sData.fDelta = m_fFixedDelta;
+			sF.sData.fFPS = sF.sData.fFPSTotal = 1.f / m_fFixedDelta;
+			sF.sData.fTotal = (float)((double)m_uFrameIx * (double)m_fFixedDelta);
+		}
+		else
+		{
+			sF.sData.fDelta = m_cTimer.delta();
+			sF.sData.fFPS = m_cTimer.fps();
+			sF.sData.fFPSTotal = m_cTimer.fps_total();
+			sF.sData.fTotal = m_cTimer.total();
+		}
+		sF.sData.uFrame = m_uFrameIx;
+		sF.sData.pcJobs = &m_cJobs;
+
+		// init slots, one additional count keeps them waiting until the frame is set up
+		for (size_t uN(0); uN < asNodes.size(); uN++)
+		{
+			Slot& sSlot = sF.asSlots[uN];
+			sSlot.uWait.store(asNodes[uN].uPredN + (bPrev ? asNodes[uN].uPrevN : 0) + 1, std::memory_order_relaxed);
+			sSlot.uHandover.store(0, std::memory_order_relaxed);
+			sSlot.bBlocked.store(false, std::memory_order_relaxed);
+			sSlot.nResult = APP_FORWARD;
+		}
+		sF.uDoneN.store(0, std::memory_order_relaxed);
+		sF.bActive.store(true, std::memory_order_release);
+		m_uActiveN++;
+
+		// nodes of the previous frame already done ? release here, otherwise they release on finish
+		if (bPrev)
+			for (size_t uN(0); uN < asNodes.size(); uN++)
+				if (sPrev.asSlots[uN].uHandover.fetch_add(1, std::memory_order_acq_rel) == 1)
+					for (unsigned uS : asNodes[uN].auNext)
+						Release(uF, uS);
+
+		// start
+		for (unsigned uN(0); uN < (unsigned)asNodes.size(); uN++)
+			Release(uF, uN);
+	}
+
+	/// <summary>count down the predecessors of a slot</summary>
+	void Release(unsigned uF, unsigned uN)
+	{
+		if (m_asFrames[uF].asSlots[uN].uWait.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			Ready(uF, uN);
+	}
+
+	/// <summary>slot is ready, skip or dispatch</summary>
+	void Ready(unsigned uF, unsigned uN)
+	{
+		if (m_asFrames[uF].asSlots[uN].bBlocked.load(std::memory_order_acquire) || (m_bStop && (m_uList != DESTROY)))
+			Finish(uF, uN, APP_FORWARD, true);
+		else if (m_psGraph->asNodes[uN].sTask.bMain)
+			PushMain({ uF, uN });
+		else
+			m_cJobs.Spawn(&ProcessJob, this, uF, uN, m_uPending);
+	}
+
+	/// <summary>slot is done, release successors</summary>
+	void Finish(unsigned uF, unsigned uN, signed nResult, bool bSkipped)
+	{
+		Frame& sF = m_asFrames[uF];
+		const Node& sNode = m_psGraph->asNodes[uN];
+		sF.asSlots[uN].nResult = nResult;
+
+		// quit or error ? skip pending tasks
+		if ((nResult == APP_QUIT) || (nResult == APP_ERROR)) m_bStop = true;
+
+		// successors in this frame
+		const bool bBlock = bSkipped || (nResult == APP_PAUSE) ||
+			((m_uList != DESTROY) && ((nResult == APP_QUIT) || (nResult == APP_ERROR)));
+		for (unsigned uS : sNode.auSucc)
+		{
+			if (bBlock) sF.asSlots[uS].bBlocked.store(true, std::memory_order_relaxed);
+			Release(uF, uS);
+		}
+
+		// successors in the next frame, if already started
+		if ((m_uFrameN > 1) && (sF.asSlots[uN].uHandover.fetch_add(1, std::memory_order_acq_rel) == 1))
+			for (unsigned uS : sNode.auNext)
+				Release((uF + 1) % m_uFrameN, uS);
+
+		// last slot ?
+		if (sF.uDoneN.fetch_add(1, std::memory_order_acq_rel) + 1 == (unsigned)m_psGraph->asNodes.size())
+			End(uF);
+	}
+
+	/// <summary>frame is done, merge results in task order</summary>
+	void End(unsigned uF)
+	{
+		Frame& sF = m_asFrames[uF];
+		signed nFuture = APP_FORWARD;
+		for (size_t uN(0); uN < m_psGraph->asNodes.size(); uN++)
+		{
+			signed nFutureCurrent = sF.asSlots[uN].nResult;
+			switch (nFutureCurrent)
+			{
+			case APP_QUIT:
+				if (nFuture != APP_ERROR)
+					nFuture = nFutureCurrent;
+				break;
+			case APP_ERROR:
+				nFuture = nFutureCurrent;
+				break;
+			default: break;
+			}
+		}
+
+		// quit or error ? store, error stays
+		signed nStatus = m_nStatus.load();
+		while (((nFuture == APP_QUIT) || (nFuture == APP_ERROR)) && (nStatus != APP_ERROR) &&
+			!m_nStatus.compare_exchange_weak(nStatus, nFuture)) {}
+
+		sF.bActive.store(false, std::memory_order_release);
+		m_uActiveN--;
+	}
+
+	/// <summary>execute slot, release successors</summary>
+	void Process(FrameNode sFN)
+	{
+		Node& sNode = m_psGraph->asNodes[sFN.uN];
+		auto cStart = std::chrono::steady_clock::now();
+		signed nResult = sNode.sTask.pfTask(m_asFrames[sFN.uF].sData);
+		sNode.dMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cStart).count();
+		Finish(sFN.uF, sFN.uN, nResult, false);
+	}
+	/// <summary>job function, frame index as begin, node index as end</summary>
+	static void ProcessJob(void* pvCtx, size_t uF, size_t uN)
+	{
+		static_cast<App_Taskhandler*>(pvCtx)->Process({ (unsigned)uF, (unsigned)uN });
+	}
+
+	/// <summary>main thread queue (fixed ring, each slot is queued once per frame)</summary>
+	void PushMain(FrameNode sFN)
+	{
+		std::lock_guard<std::mutex> cLock(m_cMainMutex);
+		m_asMain[m_uMainTail++ % m_uMainSz] = sFN;
+	}
+	bool PopMain(FrameNode& sFN)
+	{
+		std::lock_guard<std::mutex> cLock(m_cMainMutex);
+		if (m_uMainHead == m_uMainTail) return false;
+		sFN = m_asMain[m_uMainHead++ % m_uMainSz];
+		return true;
+	}
+
+	/// <summary>
+	/// Task graphs for Initialization, Runtime and Application End
+	/// </summary>
+	std::array<Graph, 3> m_asGraphs;
 	/// <summary>
-	/// Task blocks for Initialization, Runtime and Application End
-	/// Each vector of tasks (=taskblock) will be executed simultanely.
-	/// Each vector of vectors will be executed sequentually.
+	/// Frames in flight, the app data of the first frame is valid during Run()
 	/// </summary>
-	std::vector<std::vector<std::packaged_task<signed(AppData&)>>>
-		m_aacTasks_Init, m_aacTasks_Runtime, m_aacTasks_Destroy;
+	std::array<Frame, FRAMES_IN_FLIGHT> m_asFrames;
+	/// <summary>
+	/// Execution state of the current list
+	/// </summary>
+	Graph* m_psGraph = nullptr;
+	unsigned m_uList = INIT, m_uFrameN = 1;
+	uint64_t m_uFrameIx = 0;
+	std::atomic<unsigned> m_uActiveN = 0;
+	std::atomic<signed> m_nStatus = APP_FORWARD;
+	std::atomic<bool> m_bStop = false;
+	/// <summary>slots ready to be executed on the main thread</summary>
+	std::mutex m_cMainMutex;
+	std::unique_ptr<FrameNode[]> m_asMain;
+	size_t m_uMainSz = 0, m_uMainHead = 0, m_uMainTail = 0;
+	/// <summary>slots spawned to the job system</summary>
+	std::atomic<size_t> m_uPending = 0;
+	/// <summary>fixed timestep delta and number of frames (0 = wall clock)</summary>
+	float m_fFixedDelta = 1.f / 60.f;
+	uint64_t m_uFixedFrameN = 0;
+	/// <summary>frames and wall time of the last runtime list</summary>
+	uint64_t m_uRuntimeFrameN = 0;
+	double m_dRuntimeSec = 0.;
 	/// <summary>
 	/// Game Timer (platform dependent)
 	/// </summary>
 	GameTimer m_cTimer;
+	/// <summary>
+	/// Job system (persistent worker threads), executing all tasks not bound to the main thread
+	/// </summary>
+	App_Jobsystem m_cJobs;
 };
 
 #ifdef _WIN64
@@ -404,12 +627,15 @@ class App_Windows : protected App_Taskhandler
 {
 public:
 	explicit App_Windows(
-		std::vector<std::vector<GAME_TASK>>& aavTasks_Init,
-		std::vector<std::vector<GAME_TASK>>& aavTasks_Runtime,
-		std::vector<std::vector<GAME_TASK>>& aavTasks_Destroy
-	) : App_Taskhandler(aavTasks_Init, aavTasks_Runtime, aavTasks_Destroy) {}
+		std::vector<std::vector<AppTask>>& aasTasks_Init,
+		std::vector<std::vector<AppTask>>& aasTasks_Runtime,
+		std::vector<std::vector<AppTask>>& aasTasks_Destroy
+	) : App_Taskhandler(aasTasks_Init, aasTasks_Runtime, aasTasks_Destroy) {}
 	virtual ~App_Windows() {}
 
+	/// <summary>provide input layer (live, record, replay)</summary>
+	static App_Input& Input() { return m_cInput; }
+
 protected:
 
 	/// <summary>
@@ -458,18 +684,12 @@ protected:
 	/// <summary></summary>
 	FUNC_GAME_TASK(OsUpdate)
 	{
-		std::wstring atFps = std::to_wstring(sData.fFPS);
-		std::wstring atFpsTotal = std::to_wstring(sData.fFPSTotal);
-		std::wstring atTime = std::to_wstring(sData.fTotal);
-		std::wstring atDelta = std::to_wstring(sData.fDelta);
+		// format to a fixed buffer, no allocations per frame
+		wchar_t atWinText[256];
+		swprintf(atWinText, 256, L"%ls   fps: %f   fps total: %f   time: %f   delta: %f",
+			s_atAppname.data(), sData.fFPS, sData.fFPSTotal, sData.fTotal, sData.fDelta);
 
-		std::wstring atWinText = std::wstring(s_atAppname) +
-			L"   fps: " + atFps +
-			L"   fps total: " + atFpsTotal +
-			L"   time: " + atTime +
-			L"   delta: " + atDelta;
-
-		SetWindowText(m_pHwnd, atWinText.c_str());
+		SetWindowText(m_pHwnd, atWinText);
 
 		return APP_FORWARD;
 	}
@@ -536,7 +756,81 @@ protected:
 
 	static HWND m_pHwnd;
 	static struct Client { int nW, nH; } m_sClientSize;
+	static inline App_Input m_cInput;
+
+};
+
+#elif defined(__unix__) || defined(__APPLE__)
+#define APP_Os App_Posix
+
+/// <summary>
+/// POSIX app skeleton, headless (no window, virtual client size).
+/// Runs the task handler and all CPU side scene logic, quits on SIGINT / SIGTERM.
+/// </summary>
+class App_Posix : protected App_Taskhandler
+{
+public:
+	explicit App_Posix(
+		std::vector<std::vector<AppTask>>& aasTasks_Init,
+		std::vector<std::vector<AppTask>>& aasTasks_Runtime,
+		std::vector<std::vector<AppTask>>& aasTasks_Destroy
+	) : App_Taskhandler(aasTasks_Init, aasTasks_Runtime, aasTasks_Destroy) {}
+	virtual ~App_Posix() {}
+
+	/// <summary>set the virtual client size (call before OsInit)</summary>
+	static void ClientSize(int nW, int nH) { m_sClientSize = { nW, nH }; }
+	/// <summary>provide input layer (live : no controller, record, replay)</summary>
+	static App_Input& Input() { return m_cInput; }
+
+protected:
+
+	/// <summary>
+	/// Init headless, quit signals
+	/// </summary>
+	FUNC_GAME_TASK(OsInit)
+	{
+		OutputDebugStringA("App_Posix::OsInit\n");
+		s_bQuit = 0;
+		std::signal(SIGINT, OnSignal);
+		std::signal(SIGTERM, OnSignal);
+		return APP_FORWARD;
+	}
+	/// <summary>no window title to update</summary>
+	FUNC_GAME_TASK(OsUpdate)
+	{
+		return APP_FORWARD;
+	}
+	/// <summary>Handle quit signal</summary>
+	FUNC_GAME_TASK(OsFrame)
+	{
+		if (s_bQuit) return APP_QUIT;
+		return APP_FORWARD;
+	}
+	/// <summary></summary>
+	FUNC_GAME_TASK(OsPreRelease)
+	{
+		OutputDebugStringA("App_Posix::OsPreRelease\n");
+		return APP_FORWARD;
+	}
+	/// <summary></summary>
+	FUNC_GAME_TASK(OsRelease)
+	{
+		OutputDebugStringA("App_Posix::OsRelease\n");
+		std::signal(SIGINT, SIG_DFL);
+		std::signal(SIGTERM, SIG_DFL);
+		return APP_FORWARD;
+	}
+
+	/// <summary>signal handler, request quit</summary>
+	static void OnSignal(int) { s_bQuit = 1; }
 
+	/// <summary>virtual client size (default : full HD)</summary>
+	struct Client { int nW, nH; };
+	static inline Client m_sClientSize = { 1920, 1080 };
+	/// <summary>true if a quit signal was received</summary>
+	static inline volatile std::sig_atomic_t s_bQuit = 0;
+	/// <summary>input layer</summary>
+	static inline App_Input m_cInput;
 };
 
 #else
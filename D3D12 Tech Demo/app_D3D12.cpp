@@ -20,6 +20,7 @@ HWND App_Windows::m_pHwnd = nullptr;
 App_Windows::Client App_Windows::m_sClientSize;
 App_D3D12::D3D12_Fields App_D3D12::m_sD3D;
 App_D3D12::SceneData App_D3D12::m_sScene;
+App_D3D12::FrameData App_D3D12::m_sFrame;
 
 XMFLOAT2 operator+(const XMFLOAT2& sSummand0, const XMFLOAT2& sSummand1) {
 	return XMFLOAT2(sSummand0.x + sSummand1.x, sSummand0.y + sSummand1.y);
@@ -117,7 +118,7 @@ signed App_D3D12::InitDirect3D(AppData& sData)
 	CreateSceneDHeaps();
 	CreateConstantBuffers();
 	CreateRootSignatures();
-	BuildGeometry();
+	BuildGeometry(sData);
 
 	// build d3d tools and resources
 	CreateShaders();
@@ -125,6 +126,7 @@ signed App_D3D12::InitDirect3D(AppData& sData)
 
 	// init  scene constants and set basic hex tile offsets
 	UpdateConstants(sData);
+	UploadConstants();
 	OffsetTiles(m_sD3D.psCmdList.Get(), m_sD3D.psRootSignCS.Get(), m_sD3D.psPsoCsHexTrans.Get());
 
 	// execute initialization
@@ -329,32 +331,21 @@ signed App_D3D12::UpdateConstants(const AppData& sData)
 	static float s_fTmp = 0.f;
 	s_fTmp += fTimeEl;
 	static WORD uButtonOld = 0;
+	XMFLOAT4X4 sWVPc = {};
 
 	/// world - view - projection
 	{
-		// get controller 0 state
-		XINPUT_STATE sState = {};
-		uint32_t uR = XInputGetState(0, &sState);
-		if (uR == ERROR_SUCCESS)
-		{
-			// position xz
-			float fThX = ((float)sState.Gamepad.sThumbLX / 32767.f) * fTimeEl * m_sScene.fAccelTran();
-			float fThY = ((float)sState.Gamepad.sThumbLY / 32767.f) * fTimeEl * m_sScene.fAccelTran();
-			m_sScene.sCamVelo.x += fThX * cosf(m_sScene.fYaw) - fThY * sinf(m_sScene.fYaw);
-			m_sScene.sCamVelo.z += fThX * sinf(m_sScene.fYaw) + fThY * cosf(m_sScene.fYaw);
-
-			// height y
-			m_sScene.sCamVelo.y += ((float)sState.Gamepad.bRightTrigger / 256.f) * fTimeEl * m_sScene.fAccelTran();
-			m_sScene.sCamVelo.y -= ((float)sState.Gamepad.bLeftTrigger / 256.f) * fTimeEl * m_sScene.fAccelTran();
-
-			// yaw, pitch
-			m_sScene.fYaw -= ((float)sState.Gamepad.sThumbRX / 32767.f) * fTimeEl * m_sScene.fAccelRot();
-			m_sScene.fYaw = fmod(m_sScene.fYaw, XM_2PI);
-			m_sScene.fPitch = ((float)sState.Gamepad.sThumbRY / 32767.f) * XM_PIDIV2;
-		}
+		// get controller 0 state (live, recorded or replayed with its frame delta), replay ended ? quit
+		InputFrame sFrame = {};
+		if (!m_cInput.Next(sFrame, fTimeEl)) return APP_QUIT;
+		fTimeEl = sFrame.fDelta;
+		CameraInput sInput = CameraInputFrom(sFrame);
+
+		// accelerate, move, decelerate
+		CameraIntegrate(m_sScene.sCam, sInput, fTimeEl, m_sScene.fAccelTran(), m_sScene.fAccelRot(), m_sScene.fDrag);
 
 		// switch mode ? use START button
-		if ((sState.Gamepad.wButtons & 0x0010) && !(uButtonOld & 0x0010)) 
+		if ((sFrame.uButtons & 0x0010) && !(uButtonOld & 0x0010)) 
 		{
 			// DXR support ? all demos, otherwise only rasterization demos
 			uint uDmN = m_sD3D.bDXRSupport ? uDemoN : uDemoRasN;
@@ -365,12 +356,9 @@ signed App_D3D12::UpdateConstants(const AppData& sData)
 				m_sScene.eMode = (Demos)0;
 
 			// init scene
-			m_sScene.sCamPos = m_sScene.sCamInit();
-			m_sScene.sCamVelo = {};
-			m_sScene.fPitch = 0.f;
-			m_sScene.fYaw = 0.f;
+			m_sScene.sCam = { m_sScene.sCamInit(), {}, 0.f, 0.f };
 		} 
-		uButtonOld = sState.Gamepad.wButtons;
+		uButtonOld = sFrame.uButtons;
 
 		// word view projection...
 		XMFLOAT4X4 sWorld, sView, sProj;
@@ -378,23 +366,22 @@ signed App_D3D12::UpdateConstants(const AppData& sData)
 		XMMATRIX sP = XMMatrixPerspectiveFovLH(0.25f * XM_PI, static_cast<float>(m_sClientSize.nW) / static_cast<float>(m_sClientSize.nH), 1.0f, 1000.0f);
 		XMStoreFloat4x4(&sProj, sP);
 
-		// add velo, clamp y, translate, decelerate		
-		m_sScene.sCamPos = m_sScene.sCamPos + m_sScene.sCamVelo;
-		if (m_sScene.sCamPos.y < 0.f) m_sScene.sCamPos.y = 0.f;
+		// translate
+		const Camera& sCam = m_sScene.sCam;
 		XMMATRIX sV =
-			XMMatrixTranslation(-m_sScene.sCamPos.x, -m_sScene.sCamPos.y, -m_sScene.sCamPos.z) *
-			XMMatrixRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), m_sScene.fYaw) *
-			XMMatrixRotationAxis(XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), m_sScene.fPitch);
+			XMMatrixTranslation(-sCam.sPos.x, -sCam.sPos.y, -sCam.sPos.z) *
+			XMMatrixRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), sCam.fYaw) *
+			XMMatrixRotationAxis(XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), sCam.fPitch);
 		XMStoreFloat4x4(&sView, sV);
-		m_sScene.sCamVelo = m_sScene.sCamVelo * m_sScene.fDrag;
-		XMVECTOR sCamPos = XMVectorSet(m_sScene.sCamPos.x, m_sScene.sCamPos.y, m_sScene.sCamPos.z, 0.f);
-		XMVECTOR sCamVelo = XMVectorSet(m_sScene.sCamVelo.x, m_sScene.sCamVelo.y, m_sScene.sCamVelo.z, 0.f);
+		XMVECTOR sCamPos = XMVectorSet(sCam.sPos.x, sCam.sPos.y, sCam.sPos.z, 0.f);
+		XMVECTOR sCamVelo = XMVectorSet(sCam.sVelo.x, sCam.sVelo.y, sCam.sVelo.z, 0.f);
 		XMStoreFloat4(&m_sScene.sConstants.sCamPos, sCamPos);
 		XMStoreFloat4(&m_sScene.sConstants.sCamVelo, sCamVelo);
 
 		XMMATRIX sW = XMLoadFloat4x4(&sWorld);
 		XMMATRIX sPr = XMLoadFloat4x4(&sProj);
 		XMMATRIX sWVP = sW * sV * sPr;
+		XMStoreFloat4x4(&sWVPc, sWVP);
 
 		// store world view projection and inverse
 		XMStoreFloat4x4(&m_sScene.sConstants.sWVP, XMMatrixTranspose(sWVP));
@@ -421,67 +408,40 @@ signed App_D3D12::UpdateConstants(const AppData& sData)
 
 	/// hex uv
 	{
-		// get position xz
-		XMFLOAT2 sXY = XMFLOAT2{ m_sScene.sCamPos.x, m_sScene.sCamPos.z };
-
-		// get uv
-		XMFLOAT2 sUV = m_sScene.sHexUV = HexUV(sXY.x, sXY.y);
-
-		// get rounded uv = hex center (not fully mathematically correct but enough for our purpose)
-		float fUc = m_sScene.sHexUVc.x = round(sUV.x);
-		float fVc = m_sScene.sHexUVc.y = round(sUV.y);
-
-		// get cartesian hex center
-		sXY = HexXY(fUc, fVc);
+		// get uv, rounded uv and cartesian hex center of position xz
+		float2 sXY = HexTilesCenter(m_sScene.sCam.sPos.x, m_sScene.sCam.sPos.z, m_sScene.sHexUV, m_sScene.sHexUVc);
+		float2 sUV = m_sScene.sHexUV;
 
 		// store to constants
 		XMVECTOR sUVv = XMVectorSet(sXY.x, sXY.y, sUV.x, sUV.y);
 		XMStoreFloat4(&m_sScene.sConstants.sHexUV, sUVv);
 
-		// loop through tiles by index
-		for (unsigned uIx(0); uIx < min(m_sScene.uInstN, (unsigned)m_sScene.aafTilePos.size()); uIx++)
-		{
-			// get tile uv relative to new center
-			XMFLOAT2 sTileXY = XMFLOAT2{ m_sScene.aafTilePos[uIx].x - sXY.x, m_sScene.aafTilePos[uIx].y - sXY.y };
-			XMFLOAT2 sTileUV = HexUV(sTileXY.x, sTileXY.y);
-
-			// convert axial (uv) to cube coords (qrs)
-			float fQ = round(sTileUV.x);
-			float fR = -round(sTileUV.y);
-			float fS = -fQ - fR;
-
-			// get cube distance
-			float fDistCube = (abs(fQ) + abs(fR) + abs(fS)) / 2.f;
-
-			// off rim ?
-			if (fDistCube > float(m_sScene.uAmbitN))
-			{
-				// get offset to old center
-				sTileXY = XMFLOAT2{ m_sScene.aafTilePos[uIx].x - m_sScene.sHexXYc.x, m_sScene.aafTilePos[uIx].y - m_sScene.sHexXYc.y };
-
-				// negate tile offset
-				sTileXY.x *= -1.f;
-				sTileXY.y *= -1.f;
-
-				// set new to rim
-				m_sScene.aafTilePos[uIx].x = m_sScene.sHexXYc.x + sTileXY.x;
-				m_sScene.aafTilePos[uIx].y = m_sScene.sHexXYc.y + sTileXY.y;
-				m_sScene.aafTilePos[uIx].x += sXY.x - m_sScene.sHexXYc.x;
-				m_sScene.aafTilePos[uIx].y += sXY.y - m_sScene.sHexXYc.y;
-
-				// add to update tiles
-				m_sScene.aafTilePosUpdate.push_back(m_sScene.aafTilePos[uIx]);
-			}
-		}
+		// move tiles off rim (entering ring segment on hex crossing), generate their terrain
+		const size_t uUpdate0 = m_sScene.aafTilePosUpdate.size();
+		m_sScene.cTileRecycler.Recycle(m_sScene.aafTilePos, m_sScene.aafTilePosUpdate, sXY);
+		if (m_sScene.bTerrainCpu)
+			m_sScene.cTileTerrain.Update(m_sScene.aafTilePosUpdate, *sData.pcJobs, uUpdate0);
 
 		// set hex center as old for next frame
 		m_sScene.sHexXYc = sXY;
 
-		XMVECTOR sHexData = XMVectorSet((float)m_sScene.uBaseVtcN, 0, 0, 0);
+		// cull the tiles, visible tile indices (front to back) uploaded by UploadConstants()
+		if (m_sScene.bTilesCulled)
+			m_sScene.uVisibleN = m_sScene.cTileCuller.Cull(m_sScene.aafTilePos, m_sScene.uInstN, m_sScene.cTileRecycler.Center(), &sWVPc.m[0][0]);
+
+		XMVECTOR sHexData = XMVectorSet((float)m_sScene.uBaseVtcN, m_sScene.bTilesInstanced ? 1.f : 0.f, VertexCodec<VertexTile>::bPacked ? 1.f : 0.f,
+			m_sScene.bTerrainCpu ? 1.f : 0.f);
 		XMStoreUInt4(&m_sScene.sConstants.sHexData, sHexData);
 	}
 
-	// and update
+	s_fTimeOld = sData.fTotal;
+
+	return APP_FORWARD;
+}
+
+signed App_D3D12::UploadConstants()
+{
+	// scene constants
 	{
 		BYTE* ptData = nullptr;
 		ThrowIfFailed(m_sD3D.psBufferUp->Map(0, nullptr, reinterpret_cast<void**>(&ptData)));
@@ -489,7 +449,21 @@ signed App_D3D12::UpdateConstants(const AppData& sData)
 		if (m_sD3D.psBufferUp != nullptr) m_sD3D.psBufferUp->Unmap(0, nullptr);
 	}
 
-	s_fTimeOld = sData.fTotal;
+	// visible tile indices (front to back) to the instance stream
+	if (m_sScene.bTilesCulled)
+	{
+		UINT32* puVisible = nullptr;
+		ThrowIfFailed(m_sD3D.psTileVisible->Map(0, nullptr, reinterpret_cast<void**>(&puVisible)));
+		memcpy(puVisible, m_sScene.cTileCuller.Visible().data(), m_sScene.uVisibleN * sizeof(UINT32));
+		m_sD3D.psTileVisible->Unmap(0, nullptr);
+	}
+
+	// moved tiles to the upload buffers, append to the render frame (a skipped render keeps its tiles)
+	MirrorHexTiles(m_sScene.aafTilePosUpdate);
+	m_sFrame.aafTilePosUpdate.insert(m_sFrame.aafTilePosUpdate.end(), m_sScene.aafTilePosUpdate.begin(), m_sScene.aafTilePosUpdate.end());
+	m_sScene.aafTilePosUpdate.clear();
+	m_sFrame.eMode = m_sScene.eMode;
+	m_sFrame.uVisibleN = m_sScene.uVisibleN;
 
 	return APP_FORWARD;
 }
@@ -548,6 +522,13 @@ void App_D3D12::OffsetTiles(ID3D12GraphicsCommandList* psCmdList,
 	ID3D12RootSignature* psRootSign,
 	ID3D12PipelineState* psPSO)
 {
+	// instanced tiles are offset in vertex shader
+	if (m_sScene.bTilesInstanced)
+	{
+		m_sFrame.aafTilePosUpdate.clear();
+		return;
+	}
+
 	// transit to unordered access
 	CD3DX12_RB_TRANSITION::ResourceBarrier(psCmdList, m_sD3D.pcHexMesh->Vertex_Buffer(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 
@@ -562,11 +543,11 @@ void App_D3D12::OffsetTiles(ID3D12GraphicsCommandList* psCmdList,
 	psCmdList->SetComputeRootDescriptorTable(2, m_sD3D.asCbvSrvUavGpuH[(uint)CbvSrvUav_Heap_Idc::MeshVtcUav]);
 
 	// dispatch
-	UINT uNumGroupsX = (UINT)m_sScene.aafTilePosUpdate.size() * m_sScene.uBaseVtcN;
+	UINT uNumGroupsX = (UINT)m_sFrame.aafTilePosUpdate.size() * m_sScene.uBaseVtcN;
 	psCmdList->Dispatch(uNumGroupsX, 1, 1);
 
 	// once dispatched we clear the update vector
-	m_sScene.aafTilePosUpdate.clear();
+	m_sFrame.aafTilePosUpdate.clear();
 
 	// transit second map to generic read
 	CD3DX12_RB_TRANSITION::ResourceBarrier(psCmdList, m_sD3D.pcHexMesh->Vertex_Buffer(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
@@ -579,7 +560,9 @@ signed App_D3D12::CreateSceneDHeaps()
 		const int nConstantsDcN = 1;
 		const int nPostDcN = 4;
 
-		D3D12_DESCRIPTOR_HEAP_DESC sCbvHeapDesc = { D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, nConstantsDcN + nPostDcN + 1, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE, 0 };
+		const int nTileDcN = 3;
+
+		D3D12_DESCRIPTOR_HEAP_DESC sCbvHeapDesc = { D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, nConstantsDcN + nPostDcN + nTileDcN, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE, 0 };
 		ThrowIfFailed(m_sD3D.psDevice->CreateDescriptorHeap(&sCbvHeapDesc, IID_PPV_ARGS(m_sD3D.psHeapSRV.ReleaseAndGetAddressOf())));
 		m_sD3D.psHeapSRV->SetName(L"constant SRV heap");
 
@@ -633,8 +616,9 @@ signed App_D3D12::CreateRootSignatures()
 		CD3DX12_DESCRIPTOR_RANGE sCbvTable;
 		sCbvTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
 
+		// tile offsets (t0), tile terrain (t1)
 		CD3DX12_DESCRIPTOR_RANGE sSrvTable;
-		sSrvTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
+		sSrvTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 2, 0);
 
 		// param
 		CD3DX12_ROOT_PARAMETER asSlotRootPrm[6];
@@ -719,11 +703,9 @@ signed App_D3D12::CreateShaders()
 		ThrowIfFailed(D3DReadFileToBlob(L"VS_phong.cso", &psVsByteCode));
 		ThrowIfFailed(D3DReadFileToBlob(L"PS_phong.cso", &psPsByteCode));
 
-		asLayout =
-		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-			{ "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-		};
+		// tile vertex, tile index per instance (slot 1)
+		asLayout = VertexLayout<VertexTile>();
+		asLayout.push_back({ "TILE", 0, DXGI_FORMAT_R32_UINT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 });
 
 		m_sD3D.psPSO = std::make_shared<D3D12_PSO>(
 			m_sD3D.psDevice,
@@ -864,140 +846,51 @@ signed App_D3D12::CreateTextures()
 	return APP_FORWARD;
 }
 
-signed App_D3D12::BuildGeometry()
+signed App_D3D12::BuildGeometry(const AppData& sData)
 {
 	// base hexagon
 	{
-		// create basic hexagon with 6 triangles
-		// (each triangle one side and center)
-		// set normalized distance (= size unit = 1.f) to y
-		std::vector<XMFLOAT3> asHexVtc =
-		{
-			{                  0.0f, 0.0f,  0.0f }, // center
-			{                  0.0f, 1.0f, -1.0f }, // top
-			{  m_sScene.fMinW * .5f, 1.0f, -0.5f }, // top right
-			{  m_sScene.fMinW * .5f, 1.0f,  0.5f }, // bottom right
-			{                  0.0f, 1.0f,  1.0f }, // bottom
-			{ -m_sScene.fMinW * .5f, 1.0f,  0.5f }, // bottom left
-			{ -m_sScene.fMinW * .5f, 1.0f, -0.5f }, // top left
-		};
-		std::vector<std::uint32_t> auHexIdc =
-		{
-			1, 0, 2, // top-center-top right
-			2, 0, 3, // top right-center-bottom right
-			3, 0, 4, // ....
-			4, 0, 5,
-			5, 0, 6,
-			6, 0, 1
-		};
-
-		// subdivide each triangle to 3 triangles
-		for (unsigned uI(0); uI < 6; uI++)
-		{
-			// move the last triangle
-			std::array<uint32_t, 3> auTriangle;
-			for (unsigned uJ : {2, 1, 0})
-			{
-				auTriangle[uJ] = auHexIdc.back();
-				auHexIdc.pop_back();
-			}
-
-			// create the new vertices
-			std::array<XMFLOAT3, 3> asNewVtc;
-			for (unsigned uJ : {0, 1, 2})
-			{
-				asNewVtc[uJ] = {
-					0.5f * (asHexVtc[auTriangle[uJ]].x + asHexVtc[auTriangle[(uJ + 1) % 3]].x),
-					0.5f * (asHexVtc[auTriangle[uJ]].y + asHexVtc[auTriangle[(uJ + 1) % 3]].y),
-					0.5f * (asHexVtc[auTriangle[uJ]].z + asHexVtc[auTriangle[(uJ + 1) % 3]].z)
-				};
-			}
-
-			// create new indices, push back non-existing vertices
-			std::array<uint32_t, 3> auNewIdc;
-			for (unsigned uJ : {0, 1, 2})
-			{
-				unsigned uK(0);
-				bool bExists = false;
-				for (XMFLOAT3& sV : asHexVtc)
-				{
-					if ((sV.x == asNewVtc[uJ].x) &&
-						(sV.y == asNewVtc[uJ].y) &&
-						(sV.z == asNewVtc[uJ].z))
-					{
-						// vertex already exists, set index
-						auNewIdc[uJ] = uK;
-						bExists = true;
-						break;
-					}
-					uK++;
-				}
-
-				// not existing ? set index, add to vertices
-				if (!bExists)
-				{
-					auNewIdc[uJ] = (uint32_t)asHexVtc.size();
-					asHexVtc.push_back(asNewVtc[uJ]);
-				}
-
-			}
-
-			// create the new triangles
-			auHexIdc.insert(auHexIdc.begin(), auNewIdc[2]);
-			auHexIdc.insert(auHexIdc.begin(), auNewIdc[1]);
-			auHexIdc.insert(auHexIdc.begin(), auNewIdc[0]);
-			auHexIdc.insert(auHexIdc.begin(), auTriangle[2]);
-			auHexIdc.insert(auHexIdc.begin(), auNewIdc[1]);
-			auHexIdc.insert(auHexIdc.begin(), auNewIdc[2]);
-			auHexIdc.insert(auHexIdc.begin(), auNewIdc[1]);
-			auHexIdc.insert(auHexIdc.begin(), auTriangle[1]);
-			auHexIdc.insert(auHexIdc.begin(), auNewIdc[0]);
-			auHexIdc.insert(auHexIdc.begin(), auNewIdc[2]);
-			auHexIdc.insert(auHexIdc.begin(), auNewIdc[0]);
-			auHexIdc.insert(auHexIdc.begin(), auTriangle[0]);
-		}
-
-		// convert to d3d vertex
-		std::vector<VertexPosCol> asHexagonVtc;
+		// create basic hexagon with 6 triangles (each triangle one side and center),
+		// subdivided (each triangle to 4 triangles per level), normalized distance (= size unit = 1.f) in y
+		std::vector<XMFLOAT3> asHexVtc;
+		std::vector<std::uint32_t> auHexIdc;
+		HexMeshTile(m_sScene.uTileLevel, asHexVtc, auHexIdc);
+
+		// triangle order for the post-transform vertex cache (before replication)
+		MeshCacheOptimize(auHexIdc, asHexVtc.size());
+
+		// convert to d3d vertex, sV.y is the preliminary normalized distance (-1 skirt vertex)
+		// color values : xy - local position; z - distance to mesh center; w - normalized distance to mesh center ( = hexagon )
+		std::vector<VertexTile> asHexagonVtc;
+		std::vector<float2> asBaseXZ;
+		asHexagonVtc.reserve(asHexVtc.size());
 		for (XMFLOAT3& sV : asHexVtc)
 		{
-			// color values : xy - local position; z - distance to mesh center; w - normalized distance to mesh center ( = hexagon )
-			XMFLOAT4 sCol = { sV.x, sV.z, sqrt(sV.x * sV.x + sV.z * sV.z), sV.y };
-
-			// sV.y (preliminary normalized dist) to zero
-			sV.y = 0.f;
-
-			asHexagonVtc.push_back({ sV, sCol });
+			asHexagonVtc.push_back(VertexCodec<VertexTile>::Encode(sV.x, sV.z, sV.y));
+			asBaseXZ.push_back(float2{ sV.x, sV.z });
 		}
 
 		// get number of hexagons
-		unsigned uAmbitTileN = 6;
-		for (unsigned uI(0); uI < m_sScene.uAmbitN; uI++)
-		{
-			m_sScene.uInstN += uAmbitTileN;
-			uAmbitTileN += 6;
-		}
+		m_sScene.uInstN = HexTilesN(m_sScene.uAmbitN);
 
-		// add the hexagons to the vertices/indices, first hex stays as base
+		// replicated : add the hexagons to the vertices/indices, first hex stays as base
+		// we simply add the vertices with zero xy offset, this will be set by compute shader eventually
+		// (indices for one batch of tiles only, drawn per batch with base vertex offset)
+		// instanced : base hex only, offset per instance
 		m_sScene.uBaseVtcN = (unsigned)asHexagonVtc.size();
 		m_sScene.uBaseIdcN = (unsigned)auHexIdc.size();
-		for (unsigned uI(0); uI < m_sScene.uInstN; uI++)
-		{
-			// we simply add the vertices with zero xy offset, this will be set by compute shader eventually
-			for (unsigned uJ(0); uJ < m_sScene.uBaseVtcN; uJ++)
-				asHexagonVtc.push_back(asHexagonVtc[uJ]);
-
-			// we add the base number of vertices to the new index
-			for (unsigned uJ(0); uJ < m_sScene.uBaseIdcN; uJ++)
-				auHexIdc.push_back(auHexIdc[uJ] + (uI + 1) * m_sScene.uBaseVtcN);
-		}
+		m_sScene.uTileBatchN = HexTilesBatchN(m_sScene.uBaseVtcN, m_sScene.uInstN);
+		// cpu terrain, fbm scale as the vertex shader, height scaled in the vertex shader
+		m_sScene.cTileTerrain.Init(asBaseXZ, m_sScene.uInstN, 2 * m_sScene.uInstN, .05f, 1.f);
+		if (!m_sScene.bTilesInstanced)
+			HexTilesReplicate(asHexagonVtc, auHexIdc, m_sScene.uBaseVtcN, m_sScene.uBaseIdcN, m_sScene.uInstN, *sData.pcJobs, m_sScene.uTileBatchN);
 
 		// get uav handles, create mesh
 		m_sD3D.asCbvSrvUavCpuH[(uint)CbvSrvUav_Heap_Idc::MeshVtcUav] =
 			CD3DX12_CPU_DESCRIPTOR_HANDLE(m_sD3D.psHeapSRV->GetCPUDescriptorHandleForHeapStart(), (uint)CbvSrvUav_Heap_Idc::MeshVtcUav, m_sD3D.uCbvSrvUavDcSz);
 		m_sD3D.asCbvSrvUavGpuH[(uint)CbvSrvUav_Heap_Idc::MeshVtcUav] =
 			CD3DX12_GPU_DESCRIPTOR_HANDLE(m_sD3D.psHeapSRV->GetGPUDescriptorHandleForHeapStart(), (uint)CbvSrvUav_Heap_Idc::MeshVtcUav, m_sD3D.uCbvSrvUavDcSz);
-		m_sD3D.pcHexMesh = std::make_unique<Mesh_PosCol>(m_sD3D.psDevice.Get(), m_sD3D.psCmdList.Get(), asHexagonVtc, auHexIdc,
+		m_sD3D.pcHexMesh = std::make_unique<Mesh_Vtc<VertexTile>>(m_sD3D.psDevice.Get(), m_sD3D.psCmdList.Get(), asHexagonVtc, auHexIdc,
 			m_sD3D.asCbvSrvUavCpuH[(uint)CbvSrvUav_Heap_Idc::MeshVtcUav], m_sScene.uInstN, "hexagon");
 	}
 
@@ -1035,40 +928,54 @@ signed App_D3D12::BuildGeometry()
 			IID_PPV_ARGS(m_sD3D.psTileLayoutUp.ReleaseAndGetAddressOf())));
 
 		// create the tile offsets, const tile size 1.f
-		for (unsigned uInstIx(0); uInstIx < Align8Bit(m_sScene.uInstN); uInstIx++)
-		{
-			XMFLOAT2 sInstOffset = XMFLOAT2{ 0.f, 0.f };
-			if ((uInstIx > 0) && (uInstIx < m_sScene.uInstN))
-			{
-				unsigned uMul = (uInstIx - 1) / 6;
-				unsigned uOffset = (uInstIx - 1) % 6;
-
-				// get the ambit (TODO find a more elegant way here...)
-				unsigned uAmTN = 6;
-				unsigned uAmbit = 1;
-				unsigned uIx = (uInstIx - 1);
-				while (uAmTN <= uIx)
-				{
-					uIx -= uAmTN;
-					uAmTN += 6;
-					uAmbit++;
-				}
-
-				// move
-				sInstOffset = HexNext(m_sScene.fTileSz, uOffset) * (float)uAmbit;
-				if (uIx > uOffset)
-					sInstOffset = sInstOffset + HexNext(m_sScene.fTileSz, uOffset + 2) * (float)(uIx / 6);
-			}
-
-			// store the tile index in z register as float for compute shader
-			m_sScene.aafTilePos.push_back(XMFLOAT4(sInstOffset.x, sInstOffset.y, (float)uInstIx, 0.f));
-		}
+		HexTilesLayout(m_sScene.aafTilePos, m_sScene.uInstN, Align8Bit(m_sScene.uInstN), m_sScene.fTileSz, *sData.pcJobs);
+		m_sScene.cTileRecycler.Init(m_sScene.aafTilePos, m_sScene.sHexXYc, m_sScene.uAmbitN, m_sScene.uInstN);
+
+		// initially we need to update all tile positions (without the alignment padding)
+		m_sScene.aafTilePosUpdate.insert(m_sScene.aafTilePosUpdate.begin(), m_sScene.aafTilePos.begin(), m_sScene.aafTilePos.begin() + m_sScene.uInstN);
+
+		// terrain buffer and upload buffer (cpu terrain, height and normal per tile vertex)
+		sBufDc.Width = Align8Bit(m_sScene.uInstN * m_sScene.uBaseVtcN * m_sScene.uVec4Sz);
+		sPrps.Type = D3D12_HEAP_TYPE_DEFAULT;
+		ThrowIfFailed(m_sD3D.psDevice->CreateCommittedResource(
+			&sPrps,
+			D3D12_HEAP_FLAG_NONE,
+			&sBufDc,
+			D3D12_RESOURCE_STATE_COPY_DEST,
+			nullptr,
+			IID_PPV_ARGS(m_sD3D.psTileTerrain.ReleaseAndGetAddressOf())));
+		sPrps.Type = D3D12_HEAP_TYPE_UPLOAD;
+		ThrowIfFailed(m_sD3D.psDevice->CreateCommittedResource(
+			&sPrps,
+			D3D12_HEAP_FLAG_NONE,
+			&sBufDc,
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(m_sD3D.psTileTerrainUp.ReleaseAndGetAddressOf())));
+		if (m_sScene.bTerrainCpu)
+			m_sScene.cTileTerrain.Update(m_sScene.aafTilePosUpdate, *sData.pcJobs);
 
-		// initially we need to update all tile positions
-		m_sScene.aafTilePosUpdate.insert(m_sScene.aafTilePosUpdate.begin(), m_sScene.aafTilePos.begin(), m_sScene.aafTilePos.end());
+		// and update the offsets and terrain buffers
+		MirrorHexTiles(m_sScene.aafTilePosUpdate);
+		UpdateHexOffsets(D3D12_RESOURCE_STATE_COPY_DEST, m_sScene.aafTilePosUpdate);
+		UpdateHexTerrain(D3D12_RESOURCE_STATE_COPY_DEST, m_sScene.aafTilePosUpdate);
 
-		// and update the constant buffer
-		UpdateHexOffsets(D3D12_RESOURCE_STATE_COPY_DEST);
+		// visible tile index buffer (upload heap, all tiles until culled), culler (tile box height by the fbm bound, scale as the vertex shader)
+		sBufDc.Width = Align8Bit(m_sScene.uInstN * sizeof(UINT32));
+		ThrowIfFailed(m_sD3D.psDevice->CreateCommittedResource(
+			&sPrps,
+			D3D12_HEAP_FLAG_NONE,
+			&sBufDc,
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(m_sD3D.psTileVisible.ReleaseAndGetAddressOf())));
+		UINT32* puVisible = nullptr;
+		ThrowIfFailed(m_sD3D.psTileVisible->Map(0, nullptr, reinterpret_cast<void**>(&puVisible)));
+		for (UINT32 uI(0); uI < m_sScene.uInstN; uI++) puVisible[uI] = uI;
+		m_sD3D.psTileVisible->Unmap(0, nullptr);
+		m_sScene.uVisibleN = m_sScene.uInstN;
+		const float fHeightMax = FbmBound(1.f) * 10.f;
+		m_sScene.cTileCuller.Init(m_sScene.uAmbitN, m_sScene.fTileSz, -fHeightMax, fHeightMax);
 
 		// get handle
 		m_sD3D.asCbvSrvUavCpuH[(uint)CbvSrvUav_Heap_Idc::TileOffsetSrv] =
@@ -1076,15 +983,23 @@ signed App_D3D12::BuildGeometry()
 		m_sD3D.asCbvSrvUavGpuH[(uint)CbvSrvUav_Heap_Idc::TileOffsetSrv] =
 			CD3DX12_GPU_DESCRIPTOR_HANDLE(m_sD3D.psHeapSRV->GetGPUDescriptorHandleForHeapStart(), (uint)CbvSrvUav_Heap_Idc::TileOffsetSrv, m_sD3D.uCbvSrvUavDcSz);
 
-		// create SRV
+		// create SRV (typed, Buffer<float4> in shaders)
 		D3D12_SHADER_RESOURCE_VIEW_DESC sSrvDc = {
-			DXGI_FORMAT_UNKNOWN,
+			DXGI_FORMAT_R32G32B32A32_FLOAT,
 			D3D12_SRV_DIMENSION_BUFFER,
 			D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING, {}
 		};
-		sSrvDc.Buffer = { 0, m_sScene.uInstN, m_sScene.uVec4Sz, D3D12_BUFFER_SRV_FLAG_NONE };
+		sSrvDc.Buffer = { 0, m_sScene.uInstN, 0, D3D12_BUFFER_SRV_FLAG_NONE };
 		CD3DX12_CPU_DESCRIPTOR_HANDLE sSrvHeapHandle(m_sD3D.psHeapRTV->GetCPUDescriptorHandleForHeapStart());
 		m_sD3D.psDevice->CreateShaderResourceView(m_sD3D.psTileLayout.Get(), &sSrvDc, m_sD3D.asCbvSrvUavCpuH[(uint)CbvSrvUav_Heap_Idc::TileOffsetSrv]);
+
+		// terrain SRV (next to the offsets SRV, one table)
+		m_sD3D.asCbvSrvUavCpuH[(uint)CbvSrvUav_Heap_Idc::TileTerrainSrv] =
+			CD3DX12_CPU_DESCRIPTOR_HANDLE(m_sD3D.psHeapSRV->GetCPUDescriptorHandleForHeapStart(), (uint)CbvSrvUav_Heap_Idc::TileTerrainSrv, m_sD3D.uCbvSrvUavDcSz);
+		m_sD3D.asCbvSrvUavGpuH[(uint)CbvSrvUav_Heap_Idc::TileTerrainSrv] =
+			CD3DX12_GPU_DESCRIPTOR_HANDLE(m_sD3D.psHeapSRV->GetGPUDescriptorHandleForHeapStart(), (uint)CbvSrvUav_Heap_Idc::TileTerrainSrv, m_sD3D.uCbvSrvUavDcSz);
+		sSrvDc.Buffer = { 0, m_sScene.uInstN * m_sScene.uBaseVtcN, 0, D3D12_BUFFER_SRV_FLAG_NONE };
+		m_sD3D.psDevice->CreateShaderResourceView(m_sD3D.psTileTerrain.Get(), &sSrvDc, m_sD3D.asCbvSrvUavCpuH[(uint)CbvSrvUav_Heap_Idc::TileTerrainSrv]);
 	}
 
 	// axis-aligned bounding box for sweets
@@ -1197,11 +1112,11 @@ signed App_D3D12::CreateDXRAcceleration()
 
 		sGeoDc.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
 		sGeoDc.Triangles.IndexBuffer = sIBV.BufferLocation;
-		sGeoDc.Triangles.IndexCount = static_cast<UINT>(sIBV.SizeInBytes) / sizeof(UINT16);
+		sGeoDc.Triangles.IndexCount = static_cast<UINT>(sIBV.SizeInBytes) / ((sIBV.Format == DXGI_FORMAT_R16_UINT) ? sizeof(UINT16) : sizeof(UINT32));
 		sGeoDc.Triangles.IndexFormat = sIBV.Format;
 		sGeoDc.Triangles.Transform3x4 = 0;
-		sGeoDc.Triangles.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
-		sGeoDc.Triangles.VertexCount = static_cast<UINT>(sVBV.SizeInBytes) / sizeof(VertexPosCol);
+		sGeoDc.Triangles.VertexFormat = VertexLayout<VertexTile>()[0].Format;
+		sGeoDc.Triangles.VertexCount = static_cast<UINT>(sVBV.SizeInBytes) / sizeof(VertexTile);
 		sGeoDc.Triangles.VertexBuffer.StartAddress = sVBV.BufferLocation;
 		sGeoDc.Triangles.VertexBuffer.StrideInBytes = sVBV.StrideInBytes;
 
@@ -1385,6 +1300,13 @@ signed App_D3D12::Draw_Demo_00(const AppData& sData)
 	ThrowIfFailed(m_sD3D.psCmdListAlloc->Reset());
 	ThrowIfFailed(m_sD3D.psCmdList->Reset(m_sD3D.psCmdListAlloc.Get(), m_sD3D.psPSO->Get()));
 
+	// update the hex tiles before the draw (the visible tile stream is this frame's) : first the offsets
+	// and terrain, then the tiles (replicated, compute), back to the graphics pipeline state
+	UpdateHexOffsets(D3D12_RESOURCE_STATE_GENERIC_READ, m_sFrame.aafTilePosUpdate);
+	UpdateHexTerrain(D3D12_RESOURCE_STATE_GENERIC_READ, m_sFrame.aafTilePosUpdate);
+	OffsetTiles(m_sD3D.psCmdList.Get(), m_sD3D.psRootSignCS.Get(), m_sD3D.psPsoCsHexTrans.Get());
+	m_sD3D.psCmdList->SetPipelineState(m_sD3D.psPSO->Get());
+
 	// transit to render target
 	CD3DX12_RB_TRANSITION::ResourceBarrier(m_sD3D.psCmdList.Get(), m_sD3D.apsBufferSC[m_sD3D.nBackbufferI].Get(),
 		D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
@@ -1406,19 +1328,26 @@ signed App_D3D12::Draw_Demo_00(const AppData& sData)
 	m_sD3D.psCmdList->SetDescriptorHeaps(_countof(apsDHeaps), apsDHeaps);
 	m_sD3D.psCmdList->SetGraphicsRootSignature(m_sD3D.psRootSign.Get());
 
-	// vertex, index buffer - topology,... and draw skipping base hex tile
+	// vertex, index buffer - topology,... and draw : instanced base tile or replicated skipping base hex tile
 	D3D12_VERTEX_BUFFER_VIEW sVBV = m_sD3D.pcHexMesh->ViewV();
 	D3D12_INDEX_BUFFER_VIEW sIBV = m_sD3D.pcHexMesh->ViewI();
+	D3D12_VERTEX_BUFFER_VIEW sTileVBV = { m_sD3D.psTileVisible->GetGPUVirtualAddress(), m_sScene.uInstN * (UINT)sizeof(UINT32), (UINT)sizeof(UINT32) };
 	m_sD3D.psCmdList->IASetVertexBuffers(0, 1, &sVBV);
+	m_sD3D.psCmdList->IASetVertexBuffers(1, 1, &sTileVBV);
 	m_sD3D.psCmdList->IASetIndexBuffer(&sIBV);
 	m_sD3D.psCmdList->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	m_sD3D.psCmdList->SetGraphicsRootDescriptorTable(0, m_sD3D.asCbvSrvUavGpuH[(uint)CbvSrvUav_Heap_Idc::SceneConstants]);
 	m_sD3D.psCmdList->SetGraphicsRootDescriptorTable(1, m_sD3D.asCbvSrvUavGpuH[(uint)CbvSrvUav_Heap_Idc::TileOffsetSrv]);
-	m_sD3D.psCmdList->DrawIndexedInstanced(m_sD3D.pcHexMesh->Indices_N(), 1, m_sScene.uBaseIdcN, 0, 0);
-
-	// update the hex tiles, first the offsets, then the tiles ( move that later... )
-	UpdateHexOffsets(D3D12_RESOURCE_STATE_GENERIC_READ);
-	OffsetTiles(m_sD3D.psCmdList.Get(), m_sD3D.psRootSignCS.Get(), m_sD3D.psPsoCsHexTrans.Get());
+	if (m_sScene.bTilesInstanced)
+		m_sD3D.psCmdList->DrawIndexedInstanced(m_sScene.uBaseIdcN, m_sFrame.uVisibleN, 0, 0, 0);
+	else
+	{
+		for (unsigned uFirst(0); uFirst < m_sScene.uInstN; uFirst += m_sScene.uTileBatchN)
+		{
+			const unsigned uTileN = (std::min)(m_sScene.uTileBatchN, m_sScene.uInstN - uFirst);
+			m_sD3D.psCmdList->DrawIndexedInstanced(uTileN * m_sScene.uBaseIdcN, 1, m_sScene.uBaseIdcN, (INT)(uFirst * m_sScene.uBaseVtcN), 0);
+		}
+	}
 
 	// execute volume ray cast
 	ExecuteCompute(m_sD3D.psCmdList.Get(), m_sD3D.psRootSignCS.Get(),
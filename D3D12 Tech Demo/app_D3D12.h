@@ -7,6 +7,12 @@
 #include "app.h"
 #include "mesh.h"
 #include "pso.h"
+#include "zone_tiles.h"
+#include "zone_mesh.h"
+#include "mesh_cache.h"
+#include "zone_camera.h"
+#include "zone_terrain.h"
+#include "zone_cull.h"
 
 #ifndef _APP_D3D12_GENERIC
 #define _APP_D3D12_GENERIC
@@ -25,6 +31,12 @@ static constexpr uint uDemoN = 3;
 
 #ifdef _WIN64
 
+/// <summary>
+/// hex tile vertex format (see mesh_vertex.h) : VertexPacked (8 bytes, instanced tiles only)
+/// or VertexPosCol (28 bytes, instanced or replicated tiles)
+/// </summary>
+typedef VertexPacked VertexTile;
+
 /// <summary>
 /// D3D12 application
 /// </summary>
@@ -32,10 +44,10 @@ class App_D3D12 : protected App_Windows
 {
 public:
 	explicit App_D3D12(
-		std::vector<std::vector<GAME_TASK>>& aavTasks_Init,
-		std::vector<std::vector<GAME_TASK>>& aavTasks_Runtime,
-		std::vector<std::vector<GAME_TASK>>& aavTasks_Destroy
-	) : App_Windows(aavTasks_Init, aavTasks_Runtime, aavTasks_Destroy) {}
+		std::vector<std::vector<AppTask>>& aasTasks_Init,
+		std::vector<std::vector<AppTask>>& aasTasks_Runtime,
+		std::vector<std::vector<AppTask>>& aasTasks_Destroy
+	) : App_Windows(aasTasks_Init, aasTasks_Runtime, aasTasks_Destroy) {}
 	virtual ~App_D3D12() {}
 
 protected:
@@ -57,8 +69,10 @@ protected:
 	static signed CreateMainDHeaps();
 	/// <summary>Create depth stencil, viewport</summary>
 	static signed OnResize();
-	/// <summary>Update constants</summary>
+	/// <summary>Update the scene (camera, tiles, culling) and its constants on CPU</summary>
 	static signed UpdateConstants(const AppData& sData);
+	/// <summary>Upload the scene constants and moved tiles, hand the scene state over to the render frame</summary>
+	static signed UploadConstants();
 	/// <summary>clear render target</summary>
 	static void SetAndClearTarget();
 	/// <summary>Compute shader execution method</summary>
@@ -78,7 +92,7 @@ protected:
 	/// <summary>Create post processing targets</summary>
 	static signed CreateTextures();
 	/// <summary>Build the geometry of the scene</summary>
-	static signed BuildGeometry();
+	static signed BuildGeometry(const AppData& sData);
 	/// <summary>Create a pipeline state object for DXR</summary>
 	static signed CreateDXRStateObject();
 	/// <summary>Create the acceleration structures for DXR</summary>
@@ -89,7 +103,7 @@ protected:
 	static void DoRaytracing();
 	/// <summary>copy RenderMap0 to render target (back buffer)</summary>
 	static void RenderMap2Backbuffer();
-	/// <summary>translate hex tiles by compute shader</summary>
+	/// <summary>translate hex tiles by compute shader (moved tiles of the render frame)</summary>
 	static void OffsetTiles(ID3D12GraphicsCommandList* psCmdList,
 		ID3D12RootSignature* psRootSign,
 		ID3D12PipelineState* psPSO);
@@ -123,7 +137,7 @@ protected:
 		/// <summary>the scissor rectangle</summary>
 		D3D12_RECT sScissorRc;
 		/// <summary>base hexagon mesh</summary>
-		std::unique_ptr<Mesh_PosCol> pcHexMesh = nullptr;
+		std::unique_ptr<Mesh_Vtc<VertexTile>> pcHexMesh = nullptr;
 		/// <summary>shaders root signature</summary>
 		ComPtr<ID3D12RootSignature> psRootSign = nullptr;
 		/// <summary>shaders root signature</summary>
@@ -168,6 +182,10 @@ protected:
 		ComPtr<ID3D12Resource> psRenderMap0 = nullptr, psRenderMap1 = nullptr;
 		/// <summary>Buffer containing the terrain (hex) tiles xy position + upload buffer</summary>
 		ComPtr<ID3D12Resource> psTileLayout = nullptr, psTileLayoutUp = nullptr;
+		/// <summary>Buffer containing the terrain (height, normal) per tile vertex + upload buffer (mirror)</summary>
+		ComPtr<ID3D12Resource> psTileTerrain = nullptr, psTileTerrainUp = nullptr;
+		/// <summary>Buffer containing the visible tile indices (per instance vertex stream, upload heap, written each frame)</summary>
+		ComPtr<ID3D12Resource> psTileVisible = nullptr;
 		/// <summary>all resource view handles (GPU), enumerated in CbvSrvUav_Heap_Idc</summary>
 		std::vector<CD3DX12_GPU_DESCRIPTOR_HANDLE> asCbvSrvUavGpuH = std::vector<CD3DX12_GPU_DESCRIPTOR_HANDLE>(uSrvN);
 		/// <summary>all resource view handles (CPU), enumerated in CbvSrvUav_Heap_Idc</summary>
@@ -200,16 +218,14 @@ protected:
 	{
 		/// <summary>current demo mode</summary>
 		Demos eMode;
-		/// <summary>camera position</summary>
-		XMFLOAT3 sCamPos = sCamInit();
-		/// <summary>camera velocity</summary>
-		XMFLOAT3 sCamVelo = {};
+		/// <summary>camera position, velocity, yaw, pitch</summary>
+		Camera sCam = { sCamInit(), {}, 0.f, 0.f };
 		/// <summary>hexagonal coordinates (camera)</summary>
-		XMFLOAT2 sHexUV = {};
+		float2 sHexUV = {};
 		/// <summary>hexagonal coordinates next tile center (camera)</summary>
-		XMFLOAT2 sHexUVc = {};
+		float2 sHexUVc = {};
 		/// <summary>hexagonal coordinates next tile center cardesian (camera)</summary>
-		XMFLOAT2 sHexXYc = {};
+		float2 sHexXYc = {};
 		/// <summary>constant up vector</summary>
 		const XMVECTOR sUp = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
 		/// <summary>acceleration for translation</summary>
@@ -237,21 +253,19 @@ protected:
 			return 0.f;
 		}
 		/// <summary>start camera position</summary>
-		constexpr XMFLOAT3 sCamInit()
+		constexpr float3 sCamInit()
 		{
 			switch (eMode)
 			{
-			case Demos::Procedural_heightmap: return XMFLOAT3(0.f, 10.f, 0.f);
-			case Demos::Candy_cane: return XMFLOAT3(0.f, 1.f, -15.f);
-			case Demos::Hex_voxel_city: return XMFLOAT3(1000.f, 12.f, 1000.f);
+			case Demos::Procedural_heightmap: return float3{ 0.f, 10.f, 0.f };
+			case Demos::Candy_cane: return float3{ 0.f, 1.f, -15.f };
+			case Demos::Hex_voxel_city: return float3{ 1000.f, 12.f, 1000.f };
 			default: break;
 			}
-			return XMFLOAT3(0.f, 0.f, 0.f);
+			return float3{ 0.f, 0.f, 0.f };
 		}
 		/// <summary>resistance to velocity</summary>
 		const float fDrag = .995f;
-		/// <summary>camera pitch, yaw</summary>
-		float fYaw = 0.f, fPitch = 0.f;
 		/// <summary>number of hex ambits (or "circles") around the main hexagon</summary>
 		const unsigned uAmbitN = 72;
 		/// <summary>number of hex tiles (or instances), to be computed</summary>
@@ -264,6 +278,33 @@ protected:
 		std::vector<XMFLOAT4> aafTilePos;
 		/// <summary>hex tiles positions (to be updated)</summary>
 		std::vector<XMFLOAT4> aafTilePosUpdate;
+		/// <summary>
+		/// tiles instanced (base tile + offset per instance, a moved tile updates its offset) or
+		/// replicated (base tile copied per tile, a moved tile is rewritten by compute shader)
+		/// </summary>
+		static constexpr bool bTilesInstanced = true;
+		/// <summary>subdivision level of the base hex tile (see zone_mesh.h)</summary>
+		const unsigned uTileLevel = 1;
+		/// <summary>replicated tiles per draw (16 bit indices, base vertex per batch)</summary>
+		unsigned uTileBatchN;
+		/// <summary>
+		/// terrain height and normal generated on CPU when a tile is placed (instanced tiles only),
+		/// otherwise evaluated per vertex in the vertex shader each frame
+		/// </summary>
+		static constexpr bool bTerrainCpu = true;
+		/// <summary>tile terrain (generated at recycle time, lru cached by axial coordinate)</summary>
+		HexTileTerrain cTileTerrain;
+		/// <summary>hex tiles recycler (incremental, by hex crossing)</summary>
+		HexTilesRecycler cTileRecycler;
+		/// <summary>
+		/// tiles frustum culled on CPU (instanced tiles only), visible tiles drawn front to back by ring,
+		/// the tile index per instance is a vertex stream
+		/// </summary>
+		static constexpr bool bTilesCulled = true;
+		/// <summary>hex tiles culler</summary>
+		HexTilesCuller cTileCuller;
+		/// <summary>number of visible tiles (instances drawn)</summary>
+		unsigned uVisibleN = 0;
 		/// <summary>constant hex tile size</summary>
 		const float fTileSz = 1.f;
 		/// <summary>constant hex tile minimum width</summary>
@@ -273,6 +314,22 @@ protected:
 		/// <summary>constants upload struture</summary>
 		ConstantsScene sConstants = {};
 	} m_sScene;
+	/// <summary>
+	/// Render frame : the scene state the render tasks read, handed over by UploadConstants(), so the
+	/// update of the next frame may change the scene while this frame renders
+	/// </summary>
+	static struct FrameData
+	{
+		/// <summary>demo mode</summary>
+		Demos eMode;
+		/// <summary>number of visible tiles (instances drawn)</summary>
+		unsigned uVisibleN = 0;
+		/// <summary>moved tiles not yet copied, offsets and terrain are in the upload buffers</summary>
+		std::vector<XMFLOAT4> aafTilePosUpdate;
+	} m_sFrame;
+	static_assert(!VertexCodec<VertexTile>::bPacked || SceneData::bTilesInstanced, "packed tile vertices are tile local, replicated tiles need VertexPosCol");
+	static_assert(!SceneData::bTerrainCpu || SceneData::bTilesInstanced, "cpu terrain is indexed by instance");
+	static_assert(!SceneData::bTilesCulled || SceneData::bTilesInstanced, "culled tiles are drawn as instances");
 
 private:
 
@@ -285,24 +342,81 @@ private:
 		PostMap1Srv = 3,
 		PostMap1Uav = 4,
 		TileOffsetSrv = 5,
-		MeshVtcUav = 6
+		TileTerrainSrv = 6,
+		MeshVtcUav = 7
 	};
-	static constexpr unsigned uSrvN = 7;
+	static constexpr unsigned uSrvN = 8;
 
-	/// <summary>upload hex tiles xy vector offsets to constant buffer</summary>
-	static void UpdateHexOffsets(D3D12_RESOURCE_STATES eState)
+	/// <summary>
+	/// write the offsets and terrain (cpu terrain) of moved tiles to the upload buffers, which mirror the
+	/// offset and terrain buffers (instanced tiles, reads the scene)
+	/// </summary>
+	static void MirrorHexTiles(const std::vector<XMFLOAT4>& aafUpdate)
+	{
+		if (!m_sScene.bTilesInstanced || aafUpdate.empty()) return;
+
+		XMFLOAT4* psMirror = nullptr;
+		ThrowIfFailed(m_sD3D.psTileLayoutUp->Map(0, nullptr, reinterpret_cast<void**>(&psMirror)));
+		for (const XMFLOAT4& sTile : aafUpdate)
+			if ((unsigned)sTile.z < m_sScene.uInstN) psMirror[(unsigned)sTile.z] = sTile;
+		m_sD3D.psTileLayoutUp->Unmap(0, nullptr);
+
+		if (!m_sScene.bTerrainCpu) return;
+		const UINT64 uTileB = (UINT64)m_sScene.uBaseVtcN * m_sScene.uVec4Sz;
+		BYTE* ptMirror = nullptr;
+		ThrowIfFailed(m_sD3D.psTileTerrainUp->Map(0, nullptr, reinterpret_cast<void**>(&ptMirror)));
+		for (const XMFLOAT4& sTile : aafUpdate)
+			if ((unsigned)sTile.z < m_sScene.uInstN)
+				memcpy(&ptMirror[(unsigned)sTile.z * uTileB], m_sScene.cTileTerrain.Tile((unsigned)sTile.z), (size_t)uTileB);
+		m_sD3D.psTileTerrainUp->Unmap(0, nullptr);
+	}
+
+	/// <summary>upload hex tiles xy vector offsets to constant buffer (instanced : copy the mirrored offsets)</summary>
+	static void UpdateHexOffsets(D3D12_RESOURCE_STATES eState, const std::vector<XMFLOAT4>& aafUpdate)
 	{
-		// update the constant buffer for the tiles offsets
-		D3D12_SUBRESOURCE_DATA sSubData = { m_sScene.aafTilePosUpdate.data(), (LONG_PTR)(m_sScene.aafTilePosUpdate.size() * m_sScene.uVec4Sz), (LONG_PTR)(m_sScene.aafTilePosUpdate.size() * m_sScene.uVec4Sz) };
 		const CD3DX12_RB_TRANSITION sResBr0(m_sD3D.psTileLayout.Get(), eState, D3D12_RESOURCE_STATE_COPY_DEST);
 		const CD3DX12_RB_TRANSITION sResBr1(m_sD3D.psTileLayout.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ);
 
+		// instanced : offsets by tile index, the upload buffer mirrors the layout, copy the moved tiles only
+		if (m_sScene.bTilesInstanced)
+		{
+			if (eState != D3D12_RESOURCE_STATE_COPY_DEST)
+				m_sD3D.psCmdList->ResourceBarrier(1, &sResBr0);
+			HexTilesUpdateRuns(aafUpdate, m_sScene.uInstN, 16, [](unsigned uFirst, unsigned uN)
+				{
+					m_sD3D.psCmdList->CopyBufferRegion(m_sD3D.psTileLayout.Get(), (UINT64)uFirst * m_sScene.uVec4Sz,
+						m_sD3D.psTileLayoutUp.Get(), (UINT64)uFirst * m_sScene.uVec4Sz, (UINT64)uN * m_sScene.uVec4Sz);
+				});
+			m_sD3D.psCmdList->ResourceBarrier(1, &sResBr1);
+			return;
+		}
+
+		// update the constant buffer for the tiles offsets
+		D3D12_SUBRESOURCE_DATA sSubData = { aafUpdate.data(), (LONG_PTR)(aafUpdate.size() * m_sScene.uVec4Sz), (LONG_PTR)(aafUpdate.size() * m_sScene.uVec4Sz) };
+
 		// schedule update to command list
 		if (eState != D3D12_RESOURCE_STATE_COPY_DEST)
 			m_sD3D.psCmdList->ResourceBarrier(1, &sResBr0);
 		UpdateSubresources<1>(m_sD3D.psCmdList.Get(), m_sD3D.psTileLayout.Get(), m_sD3D.psTileLayoutUp.Get(), 0, 0, 1, &sSubData);
 		m_sD3D.psCmdList->ResourceBarrier(1, &sResBr1);
 	}
+
+	/// <summary>upload the terrain of the moved tiles (cpu terrain), copy the mirrored terrain</summary>
+	static void UpdateHexTerrain(D3D12_RESOURCE_STATES eState, const std::vector<XMFLOAT4>& aafUpdate)
+	{
+		if (!m_sScene.bTerrainCpu) return;
+		const CD3DX12_RB_TRANSITION sResBr0(m_sD3D.psTileTerrain.Get(), eState, D3D12_RESOURCE_STATE_COPY_DEST);
+		const CD3DX12_RB_TRANSITION sResBr1(m_sD3D.psTileTerrain.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ);
+		const UINT64 uTileB = (UINT64)m_sScene.uBaseVtcN * m_sScene.uVec4Sz;
+
+		if (eState != D3D12_RESOURCE_STATE_COPY_DEST)
+			m_sD3D.psCmdList->ResourceBarrier(1, &sResBr0);
+		HexTilesUpdateRuns(aafUpdate, m_sScene.uInstN, 0, [uTileB](unsigned uFirst, unsigned uN)
+			{
+				m_sD3D.psCmdList->CopyBufferRegion(m_sD3D.psTileTerrain.Get(), uFirst * uTileB, m_sD3D.psTileTerrainUp.Get(), uFirst * uTileB, uN * uTileB);
+			});
+		m_sD3D.psCmdList->ResourceBarrier(1, &sResBr1);
+	}
 };
 
 #else
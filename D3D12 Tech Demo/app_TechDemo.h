@@ -11,8 +11,11 @@
 class App_TechDemo : protected APP_GfxLib
 {
 public:
-	App_TechDemo() : APP_GfxLib(m_aavTasks_Init, m_aavTasks_Runtime, m_aavTasks_Destroy)
+	/// <param name="uFixedFrameN">number of frames in fixed timestep mode (60 Hz, deterministic), 0 = wall clock</param>
+	explicit App_TechDemo(uint64_t uFixedFrameN = 0) : APP_GfxLib(m_aasTasks_Init, m_aasTasks_Runtime, m_aasTasks_Destroy)
 	{
+		if (uFixedFrameN) FixedStep(1.f / 60.f, uFixedFrameN);
+
 		// .. and execute the app
 		Run();
 	}
@@ -27,9 +30,13 @@ public:
 	{
 		return APP_GfxLib::UpdateConstants(sData);
 	}
+	FUNC_GAME_TASK(OnUpload)
+	{
+		return APP_GfxLib::UploadConstants();
+	}
 	FUNC_GAME_TASK(OnRenderPipeline0)
 	{
-		switch (m_sScene.eMode)
+		switch (m_sFrame.eMode)
 		{
 		case Demos::Procedural_heightmap:
 			return APP_GfxLib::Draw_Demo_00(sData);
@@ -63,18 +70,29 @@ public:
 		return APP_FORWARD;
 	}
 
-	static std::vector<std::vector<GAME_TASK>> m_aavTasks_Init;
-	static std::vector<std::vector<GAME_TASK>> m_aavTasks_Runtime;
-	static std::vector<std::vector<GAME_TASK>> m_aavTasks_Destroy;
+	static std::vector<std::vector<AppTask>> m_aasTasks_Init;
+	static std::vector<std::vector<AppTask>> m_aasTasks_Runtime;
+	static std::vector<std::vector<AppTask>> m_aasTasks_Destroy;
 };
 
-/// The concurrent scheme of the App 
-std::vector<std::vector<GAME_TASK>> App_TechDemo::m_aavTasks_Init = { { APP_Os::OsInit }, { APP_GfxLib::GxInit },  { App_TechDemo::OnInit } };
-std::vector<std::vector<GAME_TASK>> App_TechDemo::m_aavTasks_Runtime = {
-	{ App_TechDemo::OnUpdate, APP_Os::OsUpdate }, { APP_Os::OsFrame },
-	{ App_TechDemo::OnRenderPipeline0, App_TechDemo::OnRenderPipeline1, App_TechDemo::OnRenderPipeline2, App_TechDemo::OnRenderAudio },
-	{ App_TechDemo::OnPostRender }
-};
-std::vector<std::vector<GAME_TASK>> App_TechDemo::m_aavTasks_Destroy = {
+/// The concurrent scheme of the App (first task of a block executes on the main thread)
+/// Runtime tasks declare the resources they read and write (see App_Taskhandler::Build()),
+/// a task starts as soon as its inputs are ready, the next frame may start while the current one renders.
+/// Update writes the scene only, upload hands it over to the render frame (constants, upload buffers, FrameData),
+/// render reads the render frame only : the update of frame N + 1 runs while frame N renders,
+/// the upload of frame N + 1 waits for the render of frame N.
+std::vector<std::vector<AppTask>> App_TechDemo::m_aasTasks_Init = { { APP_Os::OsInit }, { APP_GfxLib::GxInit },  { App_TechDemo::OnInit } };
+std::vector<std::vector<AppTask>> App_TechDemo::m_aasTasks_Runtime = { {
+	{ APP_Os::OsUpdate, APP_RES_NONE, APP_RES_OSQUEUE, true },
+	{ App_TechDemo::OnUpdate, APP_RES_NONE, APP_RES_SCENE },
+	{ App_TechDemo::OnUpload, APP_RES_SCENE, APP_RES_CONSTANTS },
+	{ APP_Os::OsFrame, APP_RES_NONE, APP_RES_OSQUEUE, true },
+	{ App_TechDemo::OnRenderPipeline0, APP_RES_CONSTANTS | APP_RES_OSQUEUE, APP_RES_CMDLIST, true },
+	{ App_TechDemo::OnRenderPipeline1, APP_RES_CONSTANTS | APP_RES_OSQUEUE },
+	{ App_TechDemo::OnRenderPipeline2, APP_RES_CONSTANTS | APP_RES_OSQUEUE },
+	{ App_TechDemo::OnRenderAudio, APP_RES_SCENE, APP_RES_AUDIO },
+	{ App_TechDemo::OnPostRender, APP_RES_CMDLIST }
+} };
+std::vector<std::vector<AppTask>> App_TechDemo::m_aasTasks_Destroy = {
 	{ APP_Os::OsPreRelease }, { APP_GfxLib::GxRelease }, { App_TechDemo::OnRelease }, { APP_Os::OsRelease }
 };
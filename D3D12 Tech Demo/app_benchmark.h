@@ -0,0 +1,2050 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _APP_BENCHMARK
+#define _APP_BENCHMARK
+
+#include "app.h"
+#include "zone_tiles.h"
+#include "zone_camera.h"
+#include "zone_lod.h"
+#include "zone_mesh.h"
+#include "mesh_cache.h"
+#include "mesh_vertex.h"
+#include "zone_terrain.h"
+#include "zone_cull.h"
+#include "zone_index.h"
+#include "zone_bake.h"
+#include <chrono>
+#include <cstdarg>
+#include <cstdlib>
+#include <new>
+
+/// <summary>
+/// Number of heap allocations, counted by the replaced global operator new
+/// (benchmark build only, this header is included by main.cpp only).
+/// </summary>
+inline std::atomic<size_t> s_uAllocN = 0;
+
+// gcc inlines the replacements into the callers and then takes malloc()/free() for mismatched new/delete
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(size_t uSz)
+{
+	s_uAllocN.fetch_add(1, std::memory_order_relaxed);
+	if (void* pv = malloc(uSz ? uSz : 1)) return pv;
+	throw std::bad_alloc();
+}
+void* operator new[](size_t uSz) { return operator new(uSz); }
+void operator delete(void* pv) noexcept { free(pv); }
+void operator delete(void* pv, size_t) noexcept { free(pv); }
+void operator delete[](void* pv) noexcept { free(pv); }
+void operator delete[](void* pv, size_t) noexcept { free(pv); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+/// <summary>
+/// Benchmark application, executes synthetic task blocks and traces the timings.
+/// Compile with APP_BENCHMARK defined to run this instead of the demo.
+/// </summary>
+class App_Benchmark
+{
+public:
+	App_Benchmark()
+	{
+		TaskScaling();
+		TaskGraph();
+		FrameAllocations();
+		TileLoops();
+		FrameTimes();
+		SceneLoop();
+		HexMath();
+		TileIndex();
+		TileRecycle();
+		TileLod();
+		TileMemory();
+		TileMesh();
+		TileCache();
+		TileVertex();
+		TileTerrain();
+		TileCull();
+		TileQuery();
+		FbmKernels();
+		FbmHashes();
+		FbmNormals();
+		TerrainBake();
+		FbmOctaves();
+	}
+
+	/// <summary>trace a formatted line of benchmark output</summary>
+	static void Trace(const char* atFormat, ...)
+	{
+		char atBuf[512];
+		va_list pArgs;
+		va_start(pArgs, atFormat);
+		int nL = vsnprintf(atBuf, sizeof(atBuf) - 1, atFormat, pArgs);
+		va_end(pArgs);
+		nL = (std::min)((std::max)(nL, 0), (int)sizeof(atBuf) - 2);
+		atBuf[nL] = '\n'; atBuf[nL + 1] = 0;
+		OutputDebugStringA(atBuf);
+	}
+
+	/// <summary>wall time per frame by number of independent tasks in one block</summary>
+	/// <param name="uFrameN">number of frames per measurement</param>
+	/// <param name="fWorkMs">busy time of each task in milliseconds</param>
+	static void TaskScaling(unsigned uFrameN = 200, float fWorkMs = 1.f)
+	{
+		s_uFrameN = uFrameN;
+		s_fWorkMs = fWorkMs;
+		Trace("App_Benchmark::TaskScaling : %u frames, %.2f ms per task", uFrameN, fWorkMs);
+
+		for (unsigned uTaskN : { 1u, 2u, 4u, 8u, 16u })
+		{
+			// one block of independent tasks, one block counting frames
+			std::vector<std::vector<AppTask>> aasInit = {};
+			std::vector<std::vector<AppTask>> aasRuntime = { std::vector<AppTask>(uTaskN, Workload), { FrameCount } };
+			std::vector<std::vector<AppTask>> aasDestroy = {};
+			Taskhandler cHandler(aasInit, aasRuntime, aasDestroy);
+
+			// execute and measure
+			s_uFrameCnt = 0;
+			auto cStart = std::chrono::steady_clock::now();
+			cHandler.Execute();
+			double dMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cStart).count();
+
+			Trace("tasks %2u : %8.3f ms/frame (serial %8.3f ms/frame, workers %u)",
+				uTaskN, dMs / (double)uFrameN, (double)uTaskN * fWorkMs, cHandler.Workers_N());
+		}
+	}
+
+	/// <summary>
+	/// headless frame scheduler check : a synthetic frame (os, update, upload, render, pipeline, audio, post render)
+	/// as dependency graph and as sequential blocks, checks the execution order of all dependent tasks
+	/// (also across frames), checks pause semantics, reports the critical path length and how often
+	/// the update of frame N+1 overlaps the render of frame N (graph only, the demo's task layout)
+	/// </summary>
+	/// <param name="uFrameN">number of frames per run (os task quits then)</param>
+	static signed TaskGraph(unsigned uFrameN = 64)
+	{
+		s_uFrameN = (std::min)(uFrameN, s_uGraphFrameMax);
+		Trace("App_Benchmark::TaskGraph : %u frames, pause every %u frames", s_uFrameN, s_uGraphPause);
+
+		// os, update, upload, render, pipeline, audio, post render : as the demo, update writes the scene only,
+		// upload hands it over to the constants, render reads the constants
+		const std::vector<AppTask> asFrame = {
+			{ GraphTask<0>, APP_RES_NONE, APP_RES_OSQUEUE, true },
+			{ GraphTask<1>, APP_RES_NONE, APP_RES_SCENE },
+			{ GraphTask<2>, APP_RES_SCENE, APP_RES_CONSTANTS },
+			{ GraphTask<3>, APP_RES_CONSTANTS | APP_RES_OSQUEUE, APP_RES_CMDLIST, true },
+			{ GraphTask<4>, APP_RES_CONSTANTS | APP_RES_OSQUEUE },
+			{ GraphTask<5>, APP_RES_NONE, APP_RES_AUDIO },
+			{ GraphTask<6>, APP_RES_CMDLIST },
+		};
+		double dSerialMs = 0.;
+		for (float fMs : s_afGraphMs) dSerialMs += (double)fMs;
+
+		signed nResult = APP_FORWARD;
+		for (bool bBlocks : { true, false })
+		{
+			// same tasks as blocks {os, update, upload} {render, pipeline, audio} {post render} or as one graph
+			std::vector<std::vector<AppTask>> aasRuntime;
+			if (bBlocks)
+				aasRuntime = { { GraphTask<0>, GraphTask<1>, GraphTask<2> }, { GraphTask<3>, GraphTask<4>, GraphTask<5> }, { GraphTask<6> } };
+			else
+				aasRuntime = { asFrame };
+			const std::vector<std::vector<AppTask>> aasCheck = aasRuntime;
+			std::vector<std::vector<AppTask>> aasInit = {}, aasDestroy = {};
+			Taskhandler cHandler(aasInit, aasRuntime, aasDestroy);
+
+			// execute and measure
+			for (auto& asLog : s_aasGraphLog) for (GraphLog& sLog : asLog) sLog = {};
+			s_cGraphStart = std::chrono::steady_clock::now();
+			double dMs = Measure([&]() { cHandler.Execute(); });
+
+			// flatten, blocks barrier across frames if more than one block
+			std::vector<std::pair<AppTask, unsigned>> asTasks;
+			for (unsigned uB(0); uB < (unsigned)aasCheck.size(); uB++)
+				for (const AppTask& sTask : aasCheck[uB]) asTasks.push_back({ sTask, uB });
+			const bool bBarrier = (aasCheck.size() > 1);
+
+			// check order within frame and to the next frame
+			unsigned uViolationN = 0, uPauseN = 0, uOverlapN = 0, uRenderN = 0;
+			for (unsigned uF(0); uF + 1 < s_uFrameN; uF++)
+			{
+				// update N+1 started before render N ended
+				const GraphLog& sRender = s_aasGraphLog[uF][3], & sUpdate = s_aasGraphLog[uF + 1][1];
+				if (sRender.bDone && sUpdate.bDone)
+				{
+					if (sUpdate.dStart < sRender.dEnd) uOverlapN++;
+					uRenderN++;
+				}
+
+				for (size_t uI(0); uI < asTasks.size(); uI++)
+					for (size_t uJ(0); uJ < asTasks.size(); uJ++)
+					{
+						const unsigned uTi = TaskIndex(asTasks[uI].first), uTj = TaskIndex(asTasks[uJ].first);
+						const bool bConflict = asTasks[uI].first.Conflicts(asTasks[uJ].first);
+						const GraphLog& sI = s_aasGraphLog[uF][uTi];
+						if ((uI < uJ) && ((asTasks[uI].second < asTasks[uJ].second) || bConflict))
+						{
+							const GraphLog& sJ = s_aasGraphLog[uF][uTj];
+							if (sI.bDone && sJ.bDone && (sI.dEnd > sJ.dStart)) uViolationN++;
+						}
+						if (bBarrier || (uI == uJ) || bConflict)
+						{
+							const GraphLog& sJ = s_aasGraphLog[uF + 1][uTj];
+							if (sI.bDone && sJ.bDone && (sI.dEnd > sJ.dStart)) uViolationN++;
+						}
+					}
+
+				// paused frame : update executes, render must not
+				if ((uF % s_uGraphPause) == (s_uGraphPause - 1))
+				{
+					if (!s_aasGraphLog[uF][1].bDone || s_aasGraphLog[uF][3].bDone) uViolationN++;
+					uPauseN++;
+				}
+			}
+
+			Trace("%s : %7.3f ms/frame (serial %6.3f ms, critical path %6.3f ms) %u paused, %s",
+				bBlocks ? "blocks" : "graph ", dMs / (double)s_uFrameN, dSerialMs, cHandler.CriticalPath_Ms(), uPauseN,
+				uViolationN ? "ORDER VIOLATION" : "order ok");
+			Trace("         update N+1 overlaps render N in %u of %u frames%s", uOverlapN, uRenderN,
+				(!bBlocks && !uOverlapN) ? ", NO OVERLAP" : "");
+			GameTimer::frame_stats sStats = cHandler.Stats();
+			Trace("         frame time min %6.3f mean %6.3f p50 %6.3f p95 %6.3f p99 %6.3f max %6.3f ms, hitches %u (> 2x p50)",
+				sStats.fMin, sStats.fMean, sStats.fP50, sStats.fP95, sStats.fP99, sStats.fMax, sStats.uHitchRelN);
+			if (uViolationN || (!bBlocks && !uOverlapN)) nResult = APP_ERROR;
+		}
+		return nResult;
+	}
+
+	/// <summary>
+	/// allocation check : executes the synthetic frame graph (no task work) and fails
+	/// if any frame after the warm-up allocates heap memory (scheduler, job system, timer)
+	/// </summary>
+	/// <param name="uFrameN">number of frames</param>
+	/// <param name="uWarmupN">number of warm-up frames, allowed to allocate</param>
+	static signed FrameAllocations(unsigned uFrameN = 256, unsigned uWarmupN = 16)
+	{
+		s_uFrameN = (std::min)(uFrameN, s_uGraphFrameMax);
+		uWarmupN = (std::min)(uWarmupN, s_uFrameN - 2);
+		Trace("App_Benchmark::FrameAllocations : %u frames, %u warm-up", s_uFrameN, uWarmupN);
+
+		const std::vector<AppTask> asFrame = {
+			{ GraphTask<0>, APP_RES_NONE, APP_RES_OSQUEUE, true },
+			{ GraphTask<1>, APP_RES_NONE, APP_RES_SCENE },
+			{ GraphTask<2>, APP_RES_SCENE, APP_RES_CONSTANTS },
+			{ GraphTask<3>, APP_RES_CONSTANTS | APP_RES_OSQUEUE, APP_RES_CMDLIST, true },
+			{ GraphTask<4>, APP_RES_CONSTANTS | APP_RES_OSQUEUE },
+			{ GraphTask<5>, APP_RES_NONE, APP_RES_AUDIO },
+			{ GraphTask<6>, APP_RES_CMDLIST },
+		};
+		std::vector<std::vector<AppTask>> aasInit = {}, aasRuntime = { asFrame }, aasDestroy = {};
+		Taskhandler cHandler(aasInit, aasRuntime, aasDestroy);
+
+		for (auto& asLog : s_aasGraphLog) for (GraphLog& sLog : asLog) sLog = {};
+		s_fGraphScale = 0.f;
+		cHandler.Execute();
+		s_fGraphScale = 1.f;
+
+		// allocations between the start of the first frame after warm-up and the start of the last frame
+		const size_t uAllocN = s_aasGraphLog[s_uFrameN - 1][0].uAllocN - s_aasGraphLog[uWarmupN][0].uAllocN;
+		Trace("allocations : %zu in %u frames, %s", uAllocN, s_uFrameN - 1 - uWarmupN, uAllocN ? "FAILED" : "ok");
+		return uAllocN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// speedup of the hex tile loops (layout, replication, recycling) by number of threads,
+	/// results are compared against the single threaded run
+	/// </summary>
+	/// <param name="uFrameN">number of recycle frames (camera steps) per measurement</param>
+	static void TileLoops(unsigned uFrameN = 100)
+	{
+		const unsigned uThreadMax = (std::max)(std::thread::hardware_concurrency(), 4u);
+		Trace("App_Benchmark::TileLoops : %u recycle frames, up to %u threads", uFrameN, uThreadMax);
+
+		for (unsigned uAmbitN : { 72u, 256u })
+		{
+			const unsigned uInstN = HexTilesN(uAmbitN);
+			const unsigned uAlignedN = (uInstN + 255) & ~255;
+			double adMs1[3] = {};
+			uint64_t uHash1 = 0;
+
+			for (unsigned uThreadN = 1; uThreadN <= uThreadMax; uThreadN *= 2)
+			{
+				App_Jobsystem cJobs(uThreadN - 1);
+				double adMs[3] = {};
+
+				// tile offsets
+				std::vector<float4> asTilePos, asUpdate;
+				std::vector<uint8_t> auRecycled;
+				adMs[0] = Measure([&]() { HexTilesLayout(asTilePos, uInstN, uAlignedN, 1.f, cJobs); });
+
+				// replicate a base tile (19 vertices, 72 indices as the demo hexagon)
+				struct Vertex { float afPos[3], afCol[4]; };
+				std::vector<Vertex> asVtc(19);
+				std::vector<uint32_t> auIdc(72);
+				for (uint32_t uI(0); uI < 72; uI++) auIdc[uI] = uI % 19;
+				adMs[1] = Measure([&]() { HexTilesReplicate(asVtc, auIdc, 19, 72, uInstN, cJobs); });
+
+				// walk the camera and recycle
+				float2 sXYc = { 0.f, 0.f };
+				adMs[2] = Measure([&]()
+					{
+						for (unsigned uF(0); uF < uFrameN; uF++)
+						{
+							asUpdate.clear();
+							float2 sXY = HexTilesNext(1.f, uF / 16);
+							sXY = float2{ sXYc.x + sXY.x, sXYc.y + sXY.y };
+							HexTilesRecycle(asTilePos, asUpdate, auRecycled, sXY, sXYc, uAmbitN, uInstN, cJobs);
+							sXYc = sXY;
+						}
+					}) / (double)uFrameN;
+
+				// hash the results, compare to single thread
+				uint64_t uHash = 1469598103934665603ull;
+				auto fHash = [&uHash](const void* pvData, size_t uSz)
+				{
+					for (size_t uI(0); uI < uSz; uI++) uHash = (uHash ^ ((const uint8_t*)pvData)[uI]) * 1099511628211ull;
+				};
+				fHash(asTilePos.data(), asTilePos.size() * sizeof(float4));
+				fHash(asUpdate.data(), asUpdate.size() * sizeof(float4));
+				fHash(auIdc.data(), auIdc.size() * sizeof(uint32_t));
+				if (uThreadN == 1) { uHash1 = uHash; for (unsigned uI(0); uI < 3; uI++) adMs1[uI] = adMs[uI]; }
+
+				Trace("ambits %3u tiles %6u threads %2u : layout %7.3f ms (x%.2f) replicate %7.3f ms (x%.2f) recycle %7.3f ms/frame (x%.2f) %s",
+					uAmbitN, uInstN, uThreadN,
+					adMs[0], adMs1[0] / adMs[0], adMs[1], adMs1[1] / adMs[1], adMs[2], adMs1[2] / adMs[2],
+					(uHash == uHash1) ? "ok" : "MISMATCH");
+			}
+		}
+	}
+
+	/// <summary>
+	/// game timer check : two timers ticked by a synthetic frame time pattern, the
+	/// statistics (percentiles, hitches) must match the pattern and the timers must not share state
+	/// </summary>
+	static signed FrameTimes()
+	{
+		Trace("App_Benchmark::FrameTimes : %u frames", GameTimer::uHistoryN);
+
+		// 1100 frames of 10 ms, every 50th frame 50 ms (hitch), timer B ticks at 1 ms
+		GameTimer cTimerA, cTimerB;
+		int64_t nTimeA = GameTimer::now(), nTimeB = nTimeA;
+		cTimerA.tick(nTimeA); cTimerB.tick(nTimeB);
+		for (unsigned uF(0); uF < 1100; uF++)
+		{
+			nTimeA += ((uF % 50) == 49) ? 50000000 : 10000000;
+			nTimeB += 1000000;
+			cTimerA.tick(nTimeA);
+			cTimerB.tick(nTimeB);
+		}
+
+		// the last 1024 frames of A contain 21 hitches (22 in total), 1003 frames of 10 ms
+		GameTimer::frame_stats sA = cTimerA.stats(), sB = cTimerB.stats();
+		auto fNear = [](float fA, float fB, float fEps) { return std::abs(fA - fB) < fEps; };
+		const float fMeanA = (float)((1003 * 10.0 + 21 * 50.0) / 1024.0);
+		const bool bOk =
+			(sA.uFrameN == GameTimer::uHistoryN) && fNear(sA.fMin, 10.f, .001f) && fNear(sA.fMax, 50.f, .001f) &&
+			fNear(sA.fP50, 10.f, .001f) && fNear(sA.fP95, 10.f, .001f) && fNear(sA.fP99, 50.f, .001f) && fNear(sA.fMean, fMeanA, .001f) &&
+			(sA.uHitchRelN == 21) && (sA.uHitchN == 21) && (cTimerA.hitches() == 22) &&
+			fNear(sB.fMin, 1.f, .001f) && fNear(sB.fMax, 1.f, .001f) && fNear(sB.fP99, 1.f, .001f) && !sB.uHitchRelN && !sB.uHitchN &&
+			fNear(cTimerA.total(), 11.88f, .01f) && fNear(cTimerB.total(), 1.1f, .01f) && fNear(cTimerB.fps(), 1000.f, 2.f);
+
+		Trace("timer A : min %6.3f mean %6.3f p50 %6.3f p95 %6.3f p99 %6.3f max %6.3f ms, hitches %u/%u (%llu total) fps %.1f",
+			sA.fMin, sA.fMean, sA.fP50, sA.fP95, sA.fP99, sA.fMax, sA.uHitchRelN, sA.uHitchN, (unsigned long long)cTimerA.hitches(), cTimerA.fps());
+		Trace("timer B : min %6.3f mean %6.3f p50 %6.3f p95 %6.3f p99 %6.3f max %6.3f ms, hitches %u/%u fps %.1f, %s",
+			sB.fMin, sB.fMean, sB.fP50, sB.fP95, sB.fP99, sB.fMax, sB.uHitchRelN, sB.uHitchN, cTimerB.fps(), bOk ? "ok" : "FAILED");
+		return bOk ? APP_FORWARD : APP_ERROR;
+	}
+
+	/// <summary>
+	/// CPU side scene loop on the OS backend (headless on POSIX) : camera integration and hex tile
+	/// recycling of the demo, scripted flight (circle) in fixed timestep mode (60 Hz).
+	/// Executed twice, the first run records the input, the second run replays it (no controller),
+	/// camera trajectory and recycled tiles must be identical.
+	/// </summary>
+	/// <param name="uFrameN">number of frames</param>
+	/// <param name="uAmbitN">number of hex ambits around the center tile</param>
+	static signed SceneLoop(unsigned uFrameN = 2000, unsigned uAmbitN = 72)
+	{
+		Trace("App_Benchmark::SceneLoop : %u frames, %u ambits", uFrameN, uAmbitN);
+		SceneApp::s_uAmbitN = uAmbitN;
+
+		const char* atStream = "App_Benchmark_input.bin";
+		uint64_t auHash[2] = {}, auMovedN[2] = {};
+		bool bStream = true;
+		for (unsigned uRun : { 0u, 1u })
+		{
+			// record scripted input, replay
+			App_Input& cInput = SceneApp::Input();
+			cInput.Source(uRun ? nullptr : SceneApp::Script);
+			bStream &= uRun ? (cInput.Replay(atStream) && (cInput.Replay_N() == uFrameN)) : cInput.Record(atStream);
+
+			SceneApp::s_uMovedN = 0;
+			SceneApp::s_uHash = 1469598103934665603ull;
+			SceneApp cApp(uFrameN);
+			cApp.Execute();
+			cInput.Close();
+			cInput.Source(nullptr);
+			auHash[uRun] = SceneApp::s_uHash;
+			auMovedN[uRun] = SceneApp::s_uMovedN;
+
+			const SceneApp::Scene& sScene = SceneApp::s_sScene;
+			GameTimer::frame_stats sStats = cApp.Stats();
+			Trace("run %u : %9.1f frames/s, %u tiles, %.2f tiles recycled/frame, camera (%.1f, %.1f, %.1f) hash %016llx",
+				uRun, cApp.Throughput(), sScene.uInstN, (double)auMovedN[uRun] / (double)uFrameN,
+				sScene.sCam.sPos.x, sScene.sCam.sPos.y, sScene.sCam.sPos.z, (unsigned long long)auHash[uRun]);
+			Trace("        frame time min %6.3f mean %6.3f p50 %6.3f p95 %6.3f p99 %6.3f max %6.3f ms, hitches %u (> 2x p50)",
+				sStats.fMin, sStats.fMean, sStats.fP50, sStats.fP95, sStats.fP99, sStats.fMax, sStats.uHitchRelN);
+		}
+
+		remove(atStream);
+		const bool bOk = bStream && (auHash[0] == auHash[1]) && (auMovedN[0] == auMovedN[1]);
+		Trace("input stream %u bytes, trajectory and recycled tiles %s", (unsigned)(12 + uFrameN * sizeof(InputFrame)),
+			bOk ? "identical, ok" : "DIFFER");
+		return bOk ? APP_FORWARD : APP_ERROR;
+	}
+
+	/// <summary>
+	/// hex library : exactness of the cube rounding against the nearest hex center (double) and against
+	/// the former independent uv rounding, batch equals scalar, timings of the conversions and tables
+	/// </summary>
+	/// <param name="uPointN">number of random points</param>
+	static signed HexMath(unsigned uPointN = 1 << 20)
+	{
+		static_assert(HexCubeAt(0.f, 0.f) == HexCube{ 0, 0, 0 }, "hex : constexpr origin");
+		static_assert(HexCubeAt(HexCubeToXY<float>(HexCube{ 3, -5, 2 }).x, HexCubeToXY<float>(HexCube{ 3, -5, 2 }).y) == HexCube{ 3, -5, 2 }, "hex : constexpr center");
+		static_assert(HexCubeDistance(HexCube{ 3, -5, 2 }, HexCube{ -1, 0, 1 }) == 5, "hex : constexpr distance");
+		Trace("App_Benchmark::HexMath : %u points", uPointN);
+
+		// random points
+		std::vector<float> afX(uPointN), afY(uPointN);
+		uint32_t uSeed = 12345;
+		auto fRand = [&uSeed]() { uSeed = uSeed * 1664525u + 1013904223u; return (float)(uSeed >> 8) * (1.f / 16777216.f); };
+		for (unsigned uI(0); uI < uPointN; uI++) { afX[uI] = fRand() * 200.f - 100.f; afY[uI] = fRand() * 200.f - 100.f; }
+
+		// former conversion : uv (sqrt per call), independent rounding
+		auto fLegacy = [](float fX, float fY)
+		{
+			float fU = std::round((std::sqrt(3.f) * fX + fY) / 3.f), fV = std::round(fY / 1.5f);
+			return HexCube{ (int32_t)(fU - fV), (int32_t)fV, (int32_t)-fU };
+		};
+		// reference : nearest center (double) of the hex and its neighbours
+		auto fNearest = [](float fX, float fY, const HexCube& sC)
+		{
+			HexCube sBest = sC;
+			double dBest = 1e30;
+			for (unsigned uI(0); uI < 7; uI++)
+			{
+				HexCube sN = uI ? HexCubeNext(sC, uI - 1) : sC;
+				HexVec<double> sXY = HexCubeToXY<double>(sN);
+				double dD = (sXY.x - fX) * (sXY.x - fX) + (sXY.y - fY) * (sXY.y - fY);
+				if (dD < dBest) { dBest = dD; sBest = sN; }
+			}
+			return sBest;
+		};
+
+		std::vector<HexCube> asLegacy(uPointN), asScalar(uPointN), asBatch(uPointN);
+		double dLegacy = Measure([&]() { for (unsigned uI(0); uI < uPointN; uI++) asLegacy[uI] = fLegacy(afX[uI], afY[uI]); });
+		double dScalar = Measure([&]() { for (unsigned uI(0); uI < uPointN; uI++) asScalar[uI] = HexCubeAt(afX[uI], afY[uI]); });
+		double dBatch = Measure([&]() { HexCubeAtBatch(afX.data(), afY.data(), uPointN, asBatch.data()); });
+
+		unsigned uLegacyErrN = 0, uScalarErrN = 0, uBatchErrN = 0;
+		for (unsigned uI(0); uI < uPointN; uI++)
+		{
+			HexCube sRef = fNearest(afX[uI], afY[uI], asScalar[uI]);
+			if (asLegacy[uI] != sRef) uLegacyErrN++;
+			if (asScalar[uI] != sRef)
+			{
+				// float precision at the hex border only
+				HexVec<double> sA = HexCubeToXY<double>(asScalar[uI]), sB = HexCubeToXY<double>(sRef);
+				double dA = std::hypot(sA.x - afX[uI], sA.y - afY[uI]), dB = std::hypot(sB.x - afX[uI], sB.y - afY[uI]);
+				if (dA - dB > 1e-4) uScalarErrN++;
+			}
+			if (asBatch[uI] != asScalar[uI]) uBatchErrN++;
+		}
+
+		// neighbour vectors : cos / sin against table
+		float fSum = 0.f, fErr = 0.f;
+		double dTrig = Measure([&]()
+			{
+				for (unsigned uI(0); uI < uPointN; uI++)
+				{
+					const float fAngleRad = (3.14159265f / 180.f) * 60.f * (float)(uI % 6), fMinW = std::sqrt(1.f - .25f) * 2.f;
+					fSum += fMinW * std::cos(fAngleRad) + fMinW * std::sin(fAngleRad);
+				}
+			});
+		double dTable = Measure([&]()
+			{
+				for (unsigned uI(0); uI < uPointN; uI++)
+					fSum += s_asHexNext<float>[uI % 6].x + s_asHexNext<float>[uI % 6].y;
+			});
+		for (unsigned uI(0); uI < 6; uI++)
+		{
+			const float fAngleRad = (3.14159265f / 180.f) * 60.f * (float)uI;
+			fErr = (std::max)(fErr, std::abs(std::sqrt(3.f) * std::cos(fAngleRad) - s_asHexNext<float>[uI].x));
+			fErr = (std::max)(fErr, std::abs(std::sqrt(3.f) * std::sin(fAngleRad) - s_asHexNext<float>[uI].y));
+		}
+
+		const double dNs = 1e6 / (double)uPointN;
+		Trace("point to hex : former %6.2f ns (%u wrong), cube round %6.2f ns (%u wrong), batch %6.2f ns (%u differ from scalar)",
+			dLegacy * dNs, uLegacyErrN, dScalar * dNs, uScalarErrN, dBatch * dNs, uBatchErrN);
+		Trace("neighbour vector : cos/sin %6.2f ns, table %6.2f ns, max difference %g, checksum %.1f", dTrig * dNs, dTable * dNs, fErr, fSum);
+
+		const bool bOk = !uScalarErrN && !uBatchErrN;
+		Trace("hex library %s", bOk ? "ok" : "FAILED");
+		return bOk ? APP_FORWARD : APP_ERROR;
+	}
+
+	/// <summary>
+	/// tile index <-> ring/cube coordinates : bijection for all tiles up to ring uRingN (C++ and the
+	/// 32 bit float path of the shader), offsets and timing against the former ambit loop
+	/// </summary>
+	static signed TileIndex(uint32_t uRingN = 1000, unsigned uLegacyAmbitN = 256)
+	{
+		static_assert(HexIndexFromCube(HexCube{ 0, 0, 0 }) == 0, "tile index : origin");
+		static_assert(HexIndexFromCube(HexCube{ 1, 0, -1 }) == 1 && HexIndexFromCube(HexCube{ 1, -1, 0 }) == 6, "tile index : ring 1");
+		static_assert(HexIndexFromCube(HexCube{ 2, 0, -2 }) == 7 && HexIndexFromCube(HexCube{ 1, 1, -2 }) == 13, "tile index : ring 2");
+		const uint64_t uTileN = HexRingFirst(uRingN + 1);
+		Trace("App_Benchmark::TileIndex : %u rings, %llu tiles", uRingN, (unsigned long long)uTileN);
+
+		// shader path (vrc.hlsli), 32 bit float estimate
+		auto fRingHlsl = [](uint32_t uIx)
+		{
+			if (!uIx) return HexRing{ 0, 0, 0 };
+			uint32_t uK = uIx - 1;
+			uint32_t uR = (uint32_t)((3.f + std::sqrt(9.f + 12.f * (float)uK)) / 6.f);
+			if (3 * uR * (uR - 1) > uK) uR--;
+			if (3 * uR * (uR + 1) <= uK) uR++;
+			uint32_t uJ = uK - 3 * uR * (uR - 1);
+			return HexRing{ uR, uJ % 6, uJ / 6 };
+		};
+
+		// index -> ring -> cube -> ring -> index, ring in range and at cube distance
+		uint64_t uErrN = 0, uHlslErrN = 0;
+		uint32_t uRingPrev = 0;
+		for (uint64_t uIx(0); uIx < uTileN; uIx++)
+		{
+			const HexRing sR = HexRingFromIndex(uIx);
+			const HexCube sC = HexCubeFromRing(sR);
+			const bool bOk = (sC.nQ + sC.nR + sC.nS == 0) && ((uint32_t)HexCubeLength(sC) == sR.uRing) &&
+				(sR.uSide < 6) && (sR.uStep < (std::max)(sR.uRing, 1u)) && (sR.uRing >= uRingPrev) && (sR.uRing <= uRingPrev + 1) &&
+				(HexRingFromCube(sC) == sR) && (HexIndexFromCube(sC) == uIx);
+			if (!bOk) uErrN++;
+			if (!(fRingHlsl((uint32_t)uIx) == sR)) uHlslErrN++;
+			uRingPrev = sR.uRing;
+		}
+
+		// all cubes within the rings -> index in range (with the above : bijective)
+		uint64_t uCubeN = 0;
+		for (int32_t nQ = -(int32_t)uRingN; nQ <= (int32_t)uRingN; nQ++)
+			for (int32_t nR = (std::max)(-(int32_t)uRingN, -nQ - (int32_t)uRingN); nR <= (std::min)((int32_t)uRingN, -nQ + (int32_t)uRingN); nR++)
+			{
+				const HexCube sC = { nQ, nR, -nQ - nR };
+				const uint64_t uIx = HexIndexFromCube(sC);
+				if ((uIx >= uTileN) || (HexCubeFromIndex(uIx) != sC)) uErrN++;
+				uCubeN++;
+			}
+		if (uCubeN != uTileN) uErrN++;
+
+		// former ambit loop
+		auto fOffsetLegacy = [](unsigned uInstIx, float fTileSz)
+		{
+			if (!uInstIx) return float2{ 0.f, 0.f };
+			unsigned uOffset = (uInstIx - 1) % 6, uAmTN = 6, uAmbit = 1, uIx = (uInstIx - 1);
+			while (uAmTN <= uIx) { uIx -= uAmTN; uAmTN += 6; uAmbit++; }
+			float2 sNext = HexTilesNext(fTileSz, uOffset);
+			float2 sOffset = float2{ sNext.x * (float)uAmbit, sNext.y * (float)uAmbit };
+			if (uIx > uOffset)
+			{
+				sNext = HexTilesNext(fTileSz, uOffset + 2);
+				sOffset.x += sNext.x * (float)(uIx / 6);
+				sOffset.y += sNext.y * (float)(uIx / 6);
+			}
+			return sOffset;
+		};
+		const unsigned uLegacyN = HexTilesN(uLegacyAmbitN);
+		std::vector<float2> asLegacy(uLegacyN), asClosed(uLegacyN);
+		double dLegacy = Measure([&]() { for (unsigned uI(0); uI < uLegacyN; uI++) asLegacy[uI] = fOffsetLegacy(uI, 1.f); });
+		double dClosed = Measure([&]() { for (unsigned uI(0); uI < uLegacyN; uI++) asClosed[uI] = HexTileOffset(uI, 1.f); });
+		float fMaxErr = 0.f;
+		for (unsigned uI(0); uI < uLegacyN; uI++)
+			fMaxErr = (std::max)(fMaxErr, (std::max)(std::abs(asLegacy[uI].x - asClosed[uI].x), std::abs(asLegacy[uI].y - asClosed[uI].y)));
+
+		Trace("index <-> ring <-> cube : %llu errors, shader path %llu errors", (unsigned long long)uErrN, (unsigned long long)uHlslErrN);
+		Trace("offsets %u ambits : ambit loop %8.3f ms, closed form %8.3f ms (x%.1f), max difference %g",
+			uLegacyAmbitN, dLegacy, dClosed, dLegacy / dClosed, fMaxErr);
+
+		const bool bOk = !uErrN && !uHlslErrN && (fMaxErr < 1e-3f);
+		Trace("tile index %s", bOk ? "ok" : "FAILED");
+		return bOk ? APP_FORWARD : APP_ERROR;
+	}
+
+	/// <summary>
+	/// incremental tile recycler against the full scan (HexTilesRecycle()) over a random camera walk :
+	/// same tile set and same moved tiles every frame, timings per frame
+	/// </summary>
+	/// <param name="uFrameN">number of camera steps</param>
+	/// <param name="uAmbitN">number of ambits</param>
+	static signed TileRecycle(unsigned uFrameN = 20000, unsigned uAmbitN = 72)
+	{
+		const unsigned uInstN = HexTilesN(uAmbitN);
+		Trace("App_Benchmark::TileRecycle : %u frames, %u ambits, %u tiles", uFrameN, uAmbitN, uInstN);
+
+		App_Jobsystem cJobs(0);
+		std::vector<float4> asScan, asIncr, asUpdateScan, asUpdateIncr;
+		std::vector<uint8_t> auRecycled;
+		HexTilesLayout(asScan, uInstN, uInstN, 1.f, cJobs);
+		HexTilesLayout(asIncr, uInstN, uInstN, 1.f, cJobs);
+		HexTilesRecycler cRecycler;
+		cRecycler.Init(asIncr, float2{ 0.f, 0.f }, uAmbitN, uInstN);
+
+		// order independent hash of the hexes of a tile list
+		auto fSetHash = [](const std::vector<float4>& asTiles, size_t uN)
+		{
+			uint64_t uSum = 0;
+			for (size_t uI(0); uI < uN; uI++)
+			{
+				const HexCube sC = HexCubeAt(asTiles[uI].x, asTiles[uI].y);
+				uint64_t uH = ((uint64_t)(uint32_t)sC.nQ << 32) ^ (uint32_t)sC.nR;
+				uH = (uH ^ (uH >> 30)) * 0xbf58476d1ce4e5b9ull;
+				uH = (uH ^ (uH >> 27)) * 0x94d049bb133111ebull;
+				uSum += uH ^ (uH >> 31);
+			}
+			return uSum;
+		};
+
+		// exact : all tiles within the ambits around the center, no hex twice
+		auto fExact = [&]()
+		{
+			std::vector<uint64_t> auIx(uInstN);
+			for (unsigned uI(0); uI < uInstN; uI++)
+				auIx[uI] = HexIndexFromCube(HexCubeAt(asIncr[uI].x, asIncr[uI].y) - cRecycler.Center());
+			std::sort(auIx.begin(), auIx.end());
+			for (unsigned uI(0); uI < uInstN; uI++) if (auIx[uI] != uI) return false;
+			return true;
+		};
+
+		// random walk, up to .8 per frame (at most one hex), pauses
+		uint32_t uSeed = 4711;
+		auto fRand = [&uSeed]() { uSeed = uSeed * 1664525u + 1013904223u; return (float)(uSeed >> 8) * (1.f / 16777216.f); };
+		float2 sPos = { 0.f, 0.f }, sXYc = { 0.f, 0.f };
+		float fAngle = 0.f;
+		unsigned uErrN = 0, uMovedScanN = 0, uMovedIncrN = 0, uCrossN = 0;
+		double dScanMs = 0., dIncrMs = 0.;
+		for (unsigned uF(0); uF < uFrameN; uF++)
+		{
+			fAngle += (fRand() - .5f) * .5f;
+			const float fStep = ((uF / 500) % 4 == 3) ? 0.f : fRand() * .8f;
+			sPos = float2{ sPos.x + std::cos(fAngle) * fStep, sPos.y + std::sin(fAngle) * fStep };
+
+			float2 sUV, sUVc;
+			const float2 sXY = HexTilesCenter(sPos.x, sPos.y, sUV, sUVc);
+			if ((sXY.x != sXYc.x) || (sXY.y != sXYc.y)) uCrossN++;
+
+			asUpdateScan.clear();
+			asUpdateIncr.clear();
+			dScanMs += Measure([&]() { uMovedScanN += HexTilesRecycle(asScan, asUpdateScan, auRecycled, sXY, sXYc, uAmbitN, uInstN, cJobs); });
+			dIncrMs += Measure([&]() { uMovedIncrN += cRecycler.Recycle(asIncr, asUpdateIncr, sXY); });
+			sXYc = sXY;
+
+			// same tiles, same moved tiles
+			if ((asUpdateScan.size() != asUpdateIncr.size()) ||
+				(fSetHash(asUpdateScan, asUpdateScan.size()) != fSetHash(asUpdateIncr, asUpdateIncr.size())) ||
+				(fSetHash(asScan, uInstN) != fSetHash(asIncr, uInstN)))
+				uErrN++;
+
+			if (((uF % 1000) == 999) && !fExact()) uErrN++;
+		}
+
+		// far jumps (placing all tiles, not comparable to the scan)
+		for (float fJump : { 5.f, 40.f, 1000.f })
+		{
+			asUpdateIncr.clear();
+			float2 sUV, sUVc;
+			const float2 sXY = HexTilesCenter(sPos.x + fJump, sPos.y - fJump * .5f, sUV, sUVc);
+			cRecycler.Recycle(asIncr, asUpdateIncr, sXY);
+			if (!fExact()) uErrN++;
+		}
+
+		Trace("%u hex crossings, moved tiles : scan %u, incremental %u", uCrossN, uMovedScanN, uMovedIncrN);
+		Trace("full scan %8.4f ms/frame, incremental %8.4f ms/frame (x%.1f)",
+			dScanMs / (double)uFrameN, dIncrMs / (double)uFrameN, dScanMs / dIncrMs);
+		const bool bOk = !uErrN && (uMovedScanN == uMovedIncrN);
+		Trace("tile recycler %s (%u frames differ)", bOk ? "ok" : "FAILED", uErrN);
+		return bOk ? APP_FORWARD : APP_ERROR;
+	}
+
+	/// <summary>
+	/// lod tiles : mesh counts and topology per level, lod plans for triangle budgets (72 ambits)
+	/// against the uniform layout (level 1, the demo base tile)
+	/// </summary>
+	static signed TileLod(unsigned uAmbitN = 72)
+	{
+		Trace("App_Benchmark::TileLod : %u ambits", uAmbitN);
+		unsigned uErrN = 0;
+
+		// meshes : counts, each directed edge once, border edges 6n, border at distance 1 (skirt : at -1)
+		std::vector<float3> asVtc;
+		std::vector<uint32_t> auIdc;
+		for (unsigned uL(0); uL <= 5; uL++)
+			for (bool bSkirt : { false, true })
+			{
+				HexMeshTile(uL, asVtc, auIdc, bSkirt);
+				if ((asVtc.size() != HexMeshVtcN(uL, bSkirt)) || (auIdc.size() != 3 * HexMeshTriN(uL, bSkirt))) uErrN++;
+
+				const float fBorderY = bSkirt ? -1.f : 1.f;
+				std::vector<uint64_t> auEdge;
+				for (size_t uT(0); uT < auIdc.size(); uT += 3)
+					for (unsigned uE(0); uE < 3; uE++)
+						auEdge.push_back(((uint64_t)auIdc[uT + uE] << 32) | auIdc[uT + (uE + 1) % 3]);
+				std::sort(auEdge.begin(), auEdge.end());
+				if (std::adjacent_find(auEdge.begin(), auEdge.end()) != auEdge.end()) uErrN++;
+				uint64_t uBorderN = 0;
+				for (uint64_t uE : auEdge)
+					if (!std::binary_search(auEdge.begin(), auEdge.end(), (uE << 32) | (uE >> 32)))
+					{
+						uBorderN++;
+						if ((asVtc[uE >> 32].y != fBorderY) || (asVtc[uE & 0xffffffff].y != fBorderY)) uErrN++;
+					}
+				if (uBorderN != (6ull << uL)) uErrN++;
+			}
+		HexMeshTile(1, asVtc, auIdc);
+		Trace("tile meshes level 0..5 : %s, level 1 : %zu vertices %zu triangles (demo base tile 19, 24)",
+			uErrN ? "FAILED" : "ok", asVtc.size(), auIdc.size() / 3);
+
+		// plans, neighbour rings differ by one level at most
+		const HexLodReport sUniform = HexLodCount(HexLodPlan{ uAmbitN, 1, uAmbitN + 1, false });
+		auto fReport = [&](const char* atName, const HexLodPlan& sPlan)
+		{
+			for (unsigned uRing(0); uRing < uAmbitN; uRing++)
+				if (HexLodLevel(sPlan, uRing) > HexLodLevel(sPlan, uRing + 1) + 1) uErrN++;
+			const HexLodReport sR = HexLodCount(sPlan);
+			char atLevels[256] = {};
+			int nL = 0;
+			for (int nLv = (int)HEX_MESH_LEVEL_MAX; nLv >= 0; nLv--)
+				if (sR.auTileN[nLv] && (nL < (int)sizeof(atLevels) - 32))
+					nL += snprintf(atLevels + nL, sizeof(atLevels) - nL, " L%d:%llu", nLv, (unsigned long long)sR.auTileN[nLv]);
+			Trace("%-22s level %u rings %3u skirt %u : %9llu vertices %9llu triangles (x%5.2f uniform) tiles%s", atName,
+				sPlan.uLevelMax, sPlan.uRingsMax, sPlan.bSkirt ? 1 : 0,
+				(unsigned long long)sR.uVtcN, (unsigned long long)sR.uTriN, (double)sR.uTriN / (double)sUniform.uTriN, atLevels);
+		};
+		fReport("uniform (current)", HexLodPlan{ uAmbitN, 1, uAmbitN + 1, false });
+		fReport("uniform level 3", HexLodPlan{ uAmbitN, 3, uAmbitN + 1, false });
+		fReport("budget uniform, max 3", HexLodPlanFor(uAmbitN, 3, sUniform.uTriN, true));
+		fReport("budget uniform, max 5", HexLodPlanFor(uAmbitN, 5, sUniform.uTriN, true));
+		fReport("budget 1M, max 5", HexLodPlanFor(uAmbitN, 5, 1000000, true));
+		fReport("budget 4M, max 7", HexLodPlanFor(uAmbitN, 7, 4000000, true));
+
+		Trace("tile lod %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// tile memory : replicated tiles (demo base tile copied per tile) against instanced tiles (base
+	/// tile + offset per instance) for several ambit counts, upload per recycled tile and copy runs
+	/// </summary>
+	static signed TileMemory()
+	{
+		Trace("App_Benchmark::TileMemory");
+		unsigned uErrN = 0;
+		constexpr unsigned uBaseVtcN = 19, uBaseIdcN = 72, uStride = 28;
+		auto fMB = [](uint64_t uB) { return (double)uB / (1024. * 1024.); };
+		for (unsigned uAmbitN : { 16u, 32u, 72u, 128u, 256u })
+		{
+			const HexTilesMemory sRep = HexTilesMemoryFor(uAmbitN, uBaseVtcN, uBaseIdcN, uStride, false, true);
+			const HexTilesMemory sIns = HexTilesMemoryFor(uAmbitN, uBaseVtcN, uBaseIdcN, uStride, true, true);
+			Trace("%3u ambits %6u tiles : replicated vb %8.3f ib %8.3f offsets %6.3f upload %6.3f = %8.3f MB, instanced %6.3f MB (x%.1f)",
+				uAmbitN, HexTilesN(uAmbitN), fMB(sRep.uVtxB), fMB(sRep.uIdxB), fMB(sRep.uOffsetB), fMB(sRep.uUploadB), fMB(sRep.Total()),
+				fMB(sIns.Total()), (double)sRep.Total() / (double)sIns.Total());
+		}
+
+		// index buffer : 32 bit all tiles (former) against 16 bit tile batches with base vertex, instanced
+		for (unsigned uAmbitN : { 16u, 32u, 72u, 128u, 256u })
+		{
+			const unsigned uInstN = HexTilesN(uAmbitN), uBatchN = HexTilesBatchN(uBaseVtcN, uInstN);
+			const uint64_t uIb32 = HexTilesMemoryFor(uAmbitN, uBaseVtcN, uBaseIdcN, uStride, false, false).uIdxB;
+			const uint64_t uIb16 = HexTilesMemoryFor(uAmbitN, uBaseVtcN, uBaseIdcN, uStride, false, true).uIdxB;
+			const uint64_t uIbIns = HexTilesMemoryFor(uAmbitN, uBaseVtcN, uBaseIdcN, uStride, true, true).uIdxB;
+			if (((uint64_t)(uBatchN + 1) * uBaseVtcN > 0x10000) || (uIb16 > uIb32)) uErrN++;
+			Trace("%3u ambits index buffer : 32 bit %10llu bytes, 16 bit %8llu bytes (%4u tiles/draw, %3u draws), instanced %llu bytes",
+				uAmbitN, (unsigned long long)uIb32, (unsigned long long)uIb16, uBatchN, (uInstN + uBatchN - 1) / uBatchN, (unsigned long long)uIbIns);
+		}
+
+		// per recycled tile : offset only against offset + base tile vertices (written by compute shader)
+		Trace("bytes per recycled tile : instanced 16, replicated %u (16 offset + %u vertices)", 16 + uBaseVtcN * uStride, uBaseVtcN);
+
+		// recycle on a straight flight (72 ambits), copy runs of the moved tiles
+		constexpr unsigned uAmbitN = 72;
+		const unsigned uInstN = HexTilesN(uAmbitN);
+		// (run gap 0 : moved tiles only, gap 16 : as the demo)
+		for (unsigned uGapN : { 0u, 16u })
+		{
+			std::vector<float4> asTilePos, asUpdate;
+			App_Jobsystem cJobs(0);
+			HexTilesLayout(asTilePos, uInstN, uInstN, 1.f, cJobs);
+			HexTilesRecycler cRecycler;
+			cRecycler.Init(asTilePos, float2{ 0.f, 0.f }, uAmbitN, uInstN);
+			uint64_t uMovedN = 0, uRunN = 0, uCopyB = 0;
+			for (unsigned uF(0); uF < 4096; uF++)
+			{
+				asUpdate.clear();
+				uMovedN += cRecycler.Recycle(asTilePos, asUpdate, float2{ (float)uF * .1f, (float)uF * .037f });
+
+				// each moved tile covered by exactly one run
+				size_t uNext = 0;
+				uRunN += HexTilesUpdateRuns(asUpdate, uInstN, uGapN, [&](unsigned uFirst, unsigned uN)
+					{
+						if (!uN || ((unsigned)asUpdate[uNext].z != uFirst)) uErrN++;
+						while ((uNext < asUpdate.size()) && ((unsigned)asUpdate[uNext].z < uFirst + uN)) uNext++;
+						if ((unsigned)asUpdate[uNext - 1].z != uFirst + uN - 1) uErrN++;
+						uCopyB += uN * 16ull;
+					});
+				if (uNext != asUpdate.size()) uErrN++;
+			}
+			Trace("straight flight, run gap %2u : %llu moved tiles, %llu copy runs (%.1f tiles/run), %.1f KB uploaded",
+				uGapN, (unsigned long long)uMovedN, (unsigned long long)uRunN, uRunN ? (double)uMovedN / (double)uRunN : 0.,
+				(double)uCopyB / 1024.);
+		}
+		Trace("tile memory %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// tile mesh : welded subdivision (hash map, appended indices) up to level 8 against the former
+	/// base hexagon subdivision (linear scan weld, front inserted indices, applied per level) up to level 5,
+	/// same vertex and triangle sets, counts, no duplicate vertices
+	/// </summary>
+	static signed TileMesh()
+	{
+		Trace("App_Benchmark::TileMesh");
+		unsigned uErrN = 0;
+
+		// former subdivision, each pass splits all triangles
+		auto fReference = [](unsigned uLevel, std::vector<float3>& asVtc, std::vector<uint32_t>& auIdc)
+		{
+			const float fHalfW = HexConst<float>::fHalfSqrt3;
+			asVtc = { { 0.f, 0.f, 0.f }, { 0.f, 1.f, -1.f }, { fHalfW, 1.f, -.5f }, { fHalfW, 1.f, .5f },
+				{ 0.f, 1.f, 1.f }, { -fHalfW, 1.f, .5f }, { -fHalfW, 1.f, -.5f } };
+			auIdc = { 1, 0, 2, 2, 0, 3, 3, 0, 4, 4, 0, 5, 5, 0, 6, 6, 0, 1 };
+			for (unsigned uL(0); uL < uLevel; uL++)
+			{
+				const size_t uTriN = auIdc.size() / 3;
+				for (size_t uI(0); uI < uTriN; uI++)
+				{
+					std::array<uint32_t, 3> auTri;
+					for (unsigned uJ : { 2, 1, 0 }) { auTri[uJ] = auIdc.back(); auIdc.pop_back(); }
+					std::array<uint32_t, 3> auNew;
+					for (unsigned uJ : { 0, 1, 2 })
+					{
+						const float3& sP = asVtc[auTri[uJ]], & sQ = asVtc[auTri[(uJ + 1) % 3]];
+						const float3 sM = { .5f * (sP.x + sQ.x), .5f * (sP.y + sQ.y), .5f * (sP.z + sQ.z) };
+						uint32_t uK = 0;
+						while ((uK < asVtc.size()) && !((asVtc[uK].x == sM.x) && (asVtc[uK].y == sM.y) && (asVtc[uK].z == sM.z))) uK++;
+						if (uK == asVtc.size()) asVtc.push_back(sM);
+						auNew[uJ] = uK;
+					}
+					for (uint32_t uIx : { auNew[2], auNew[1], auNew[0], auTri[2], auNew[1], auNew[2],
+						auNew[1], auTri[1], auNew[0], auNew[2], auNew[0], auTri[0] })
+						auIdc.insert(auIdc.begin(), uIx);
+				}
+			}
+		};
+
+		// triangles as sorted position keys (rotation kept, winding checked)
+		auto fTriKeys = [](const std::vector<float3>& asVtc, const std::vector<uint32_t>& auIdc)
+		{
+			std::vector<std::array<uint64_t, 3>> aauTri;
+			for (size_t uT(0); uT < auIdc.size(); uT += 3)
+			{
+				std::array<uint64_t, 3> auK;
+				for (unsigned uJ(0); uJ < 3; uJ++) auK[uJ] = HexMeshWelder<float3>::Key(asVtc[auIdc[uT + uJ]]);
+				while ((auK[0] > auK[1]) || (auK[0] > auK[2])) std::rotate(auK.begin(), auK.begin() + 1, auK.end());
+				aauTri.push_back(auK);
+			}
+			std::sort(aauTri.begin(), aauTri.end());
+			return aauTri;
+		};
+
+		std::vector<float3> asVtc, asVtcRef;
+		std::vector<uint32_t> auIdc, auIdcRef;
+		for (unsigned uL(1); uL <= HEX_MESH_LEVEL_MAX; uL++)
+		{
+			const double dMs = Measure([&]() { HexMeshTile(uL, asVtc, auIdc); });
+
+			// counts, unique vertices
+			if ((asVtc.size() != HexMeshVtcN(uL)) || (auIdc.size() != 3 * HexMeshTriN(uL))) uErrN++;
+			std::vector<uint64_t> auKey;
+			for (const float3& sV : asVtc) auKey.push_back(HexMeshWelder<float3>::Key(sV));
+			std::sort(auKey.begin(), auKey.end());
+			if (std::adjacent_find(auKey.begin(), auKey.end()) != auKey.end()) uErrN++;
+
+			if (uL <= 5)
+			{
+				const double dRefMs = Measure([&]() { fReference(uL, asVtcRef, auIdcRef); });
+				if (fTriKeys(asVtc, auIdc) != fTriKeys(asVtcRef, auIdcRef)) uErrN++;
+				Trace("level %u : %7zu vertices %7zu triangles, welded %9.3f ms, former %9.3f ms (x%.1f)",
+					uL, asVtc.size(), auIdc.size() / 3, dMs, dRefMs, dRefMs / dMs);
+			}
+			else
+				Trace("level %u : %7zu vertices %7zu triangles, welded %9.3f ms", uL, asVtc.size(), auIdc.size() / 3, dMs);
+		}
+
+		Trace("tile mesh %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// tile mesh vertex cache : ACMR/ATVR (FIFO 16, 32 entries) of the generated tile before and after
+	/// the cache optimizer per subdivision level, triangles and winding unchanged
+	/// </summary>
+	static signed TileCache()
+	{
+		Trace("App_Benchmark::TileCache");
+		unsigned uErrN = 0;
+
+		// triangles, rotated to the lowest index first (winding kept)
+		auto fTris = [](const std::vector<uint32_t>& auIdc)
+		{
+			std::vector<std::array<uint32_t, 3>> aauTri;
+			for (size_t uT(0); uT < auIdc.size(); uT += 3)
+			{
+				std::array<uint32_t, 3> auT = { auIdc[uT], auIdc[uT + 1], auIdc[uT + 2] };
+				while ((auT[0] > auT[1]) || (auT[0] > auT[2])) std::rotate(auT.begin(), auT.begin() + 1, auT.end());
+				aauTri.push_back(auT);
+			}
+			std::sort(aauTri.begin(), aauTri.end());
+			return aauTri;
+		};
+
+		std::vector<float3> asVtc;
+		std::vector<uint32_t> auIdc;
+		for (unsigned uL(1); uL <= HEX_MESH_LEVEL_MAX; uL++)
+		{
+			HexMeshTile(uL, asVtc, auIdc);
+			const MeshCacheStats sPre16 = MeshCacheSimulate(auIdc, asVtc.size(), 16), sPre32 = MeshCacheSimulate(auIdc, asVtc.size(), 32);
+			const auto aauTri = fTris(auIdc);
+			const double dMs = Measure([&]() { MeshCacheOptimize(auIdc, asVtc.size()); });
+			const MeshCacheStats sPost16 = MeshCacheSimulate(auIdc, asVtc.size(), 16), sPost32 = MeshCacheSimulate(auIdc, asVtc.size(), 32);
+			if (fTris(auIdc) != aauTri) uErrN++;
+			if (sPost32.fACMR > sPre32.fACMR) uErrN++;
+
+			Trace("level %u %7zu tris : ACMR fifo16 %.3f -> %.3f fifo32 %.3f -> %.3f, ATVR fifo16 %.3f -> %.3f fifo32 %.3f -> %.3f (%8.3f ms)",
+				uL, auIdc.size() / 3, sPre16.fACMR, sPost16.fACMR, sPre32.fACMR, sPost32.fACMR,
+				sPre16.fATVR, sPost16.fATVR, sPre32.fATVR, sPost32.fATVR, dMs);
+		}
+
+		Trace("tile cache %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// tile vertex formats : encode/decode round trip of the generated tiles (levels 1..8, skirted), float
+	/// exact, packed within half a quantization step, bytes per tile and per frame (72 ambits, instanced)
+	/// </summary>
+	static signed TileVertex(unsigned uAmbitN = 72)
+	{
+		Trace("App_Benchmark::TileVertex");
+		struct VertexFloat { float3 sPos; float4 sColor; };
+		static_assert(sizeof(VertexFloat) == 28, "VertexFloat : as VertexPosCol");
+		unsigned uErrN = 0;
+
+		std::vector<float3> asVtc;
+		std::vector<uint32_t> auIdc;
+		for (unsigned uL(1); uL <= HEX_MESH_LEVEL_MAX; uL++)
+		{
+			// skirted mesh : skirt vertices (y = -1) decode to the rim (distance 1) with skirt depth -1
+			HexMeshTile(uL, asVtc, auIdc, true);
+			float fErrPos = 0.f, fErrDist = 0.f, fErrLen = 0.f;
+			for (const float3& sV : asVtc)
+			{
+				float3 sPos, sPosP;
+				float4 sCol, sColP;
+				VertexCodec<VertexFloat>::Decode(VertexCodec<VertexFloat>::Encode(sV.x, sV.z, sV.y), sPos, sCol);
+				VertexCodec<VertexPacked>::Decode(VertexCodec<VertexPacked>::Encode(sV.x, sV.z, sV.y), sPosP, sColP);
+				const float fSkirtY = (sV.y < 0.f) ? -1.f : 0.f, fDistN = (sV.y < 0.f) ? 1.f : sV.y;
+
+				// float exact
+				if ((sPos.x != sV.x) || (sPos.y != fSkirtY) || (sPos.z != sV.z) || (sCol.x != sV.x) || (sCol.y != sV.z) || (sCol.w != fDistN)) uErrN++;
+
+				// packed : decoded color as derived from the decoded position, skirt exact
+				fErrPos = (std::max)(fErrPos, (std::max)(std::fabs(sPosP.x - sV.x), std::fabs(sPosP.z - sV.z)));
+				fErrDist = (std::max)(fErrDist, std::fabs(sColP.w - fDistN));
+				fErrLen = (std::max)(fErrLen, std::fabs(sColP.z - sCol.z));
+				if ((sPosP.y != fSkirtY) || (sColP.x != sPosP.x) || (sColP.y != sPosP.z)) uErrN++;
+			}
+			if ((fErrPos > .5f / 32767.f + 1e-7f) || (fErrDist > .5f / 65535.f + 1e-7f) || (fErrLen > 1.f / 32767.f)) uErrN++;
+
+			Trace("level %u %6zu vertices : bytes/tile float %8zu packed %7zu, packed max error position %.2e distance %.2e",
+				uL, asVtc.size(), asVtc.size() * sizeof(VertexFloat), asVtc.size() * sizeof(VertexPacked), fErrPos, fErrDist);
+		}
+
+		// vertex fetch per frame, each tile vertex once (post-transform cache ignored)
+		const uint64_t uTileN = HexTilesN(uAmbitN);
+		for (unsigned uL : { 1u, 3u })
+			Trace("%u ambits level %u : vertex fetch/frame float %8.2f MB packed %7.2f MB", uAmbitN, uL,
+				(double)(uTileN * HexMeshVtcN(uL) * sizeof(VertexFloat)) / (1024. * 1024.),
+				(double)(uTileN * HexMeshVtcN(uL) * sizeof(VertexPacked)) / (1024. * 1024.));
+
+		Trace("tile vertex %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// tile terrain on CPU : fbm evaluations per frame in steady state (generated at recycle time,
+	/// lru cache of 2 tile sets) against the vertex shader scheme (1 fbm_der per vertex, each frame),
+	/// straight flight and a back and forth flight (revisits), cached terrain equals generated
+	/// </summary>
+	static signed TileTerrain(unsigned uAmbitN = 72)
+	{
+		Trace("App_Benchmark::TileTerrain : %u ambits", uAmbitN);
+		unsigned uErrN = 0;
+		const unsigned uInstN = HexTilesN(uAmbitN);
+		App_Jobsystem cJobs(std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() - 1 : 0);
+
+		// base tile xz (level 1, as the demo)
+		std::vector<float3> asVtc;
+		std::vector<uint32_t> auIdc;
+		HexMeshTile(1, asVtc, auIdc);
+		std::vector<float2> asBaseXZ;
+		for (const float3& sV : asVtc) asBaseXZ.push_back(float2{ sV.x, sV.z });
+		const uint64_t uShaderFbmN = (uint64_t)uInstN * asBaseXZ.size();
+
+		for (bool bBackForth : { false, true })
+		{
+			std::vector<float4> asTilePos, asUpdate;
+			HexTilesLayout(asTilePos, uInstN, uInstN, 1.f, cJobs);
+			HexTilesRecycler cRecycler;
+			cRecycler.Init(asTilePos, float2{ 0.f, 0.f }, uAmbitN, uInstN);
+			HexTileTerrain cTerrain;
+			cTerrain.Init(asBaseXZ, uInstN, 2 * uInstN);
+
+			// all tiles initially
+			asUpdate.assign(asTilePos.begin(), asTilePos.end());
+			const double dInitMs = Measure([&]() { cTerrain.Update(asUpdate, cJobs); });
+			const uint64_t uFbm0 = cTerrain.Fbm_N(), uHit0 = cTerrain.Hits_N(), uMiss0 = cTerrain.Misses_N();
+
+			// fly (.2 per frame, back and forth : 400 frames out, 400 frames back)
+			constexpr unsigned uFrameN = 3200;
+			double dMs = 0.;
+			for (unsigned uF(0); uF < uFrameN; uF++)
+			{
+				const unsigned uPhase = uF % 800;
+				const float fT = bBackForth ? (float)((uPhase < 400) ? uPhase : 800 - uPhase) : (float)uF;
+				asUpdate.clear();
+				cRecycler.Recycle(asTilePos, asUpdate, float2{ fT * .2f, fT * .07f });
+				dMs += Measure([&]() { cTerrain.Update(asUpdate, cJobs); });
+			}
+
+			// terrain of the tiles equals generated at their offset (every 97th tile)
+			std::vector<float4> asRef(asBaseXZ.size());
+			for (unsigned uI(0); uI < uInstN; uI += 97)
+			{
+				cTerrain.Generate(asTilePos[uI].x, asTilePos[uI].y, asRef.data());
+				if (std::memcmp(asRef.data(), cTerrain.Tile(uI), asRef.size() * sizeof(float4))) uErrN++;
+			}
+
+			const uint64_t uHitN = cTerrain.Hits_N() - uHit0, uMissN = cTerrain.Misses_N() - uMiss0;
+			Trace("%-12s init %8.1f ms, %llu tile hits %llu misses (%.1f%% hits), %.3f ms/frame",
+				bBackForth ? "back, forth" : "straight", dInitMs, (unsigned long long)uHitN, (unsigned long long)uMissN,
+				(uHitN + uMissN) ? 100. * (double)uHitN / (double)(uHitN + uMissN) : 0., dMs / (double)uFrameN);
+			Trace("%-12s fbm/frame : vertex shader %llu, cpu at recycle %.1f (x%.0f less)", "",
+				(unsigned long long)uShaderFbmN, (double)(cTerrain.Fbm_N() - uFbm0) / (double)uFrameN,
+				(cTerrain.Fbm_N() > uFbm0) ? (double)uShaderFbmN * uFrameN / (double)(cTerrain.Fbm_N() - uFbm0) : 0.);
+		}
+
+		Trace("tile terrain %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// tile frustum culling : culled fraction over a recorded camera path (scripted flight, turn and pitch sweep,
+	/// replayed), time per frame, visible tiles sorted by ring with consistent ranges, no culled tile has
+	/// a vertex (terrain height by fbm) inside the frustum (every 128th frame)
+	/// </summary>
+	static signed TileCull(unsigned uFrameN = 2000, unsigned uAmbitN = 72)
+	{
+		Trace("App_Benchmark::TileCull : %u frames, %u ambits", uFrameN, uAmbitN);
+		const unsigned uInstN = HexTilesN(uAmbitN);
+		App_Jobsystem cJobs(std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() - 1 : 0);
+
+		// record the scripted path, replay
+		const char* atStream = "App_Benchmark_cull.bin";
+		App_Input cInput;
+		cInput.Source(CullScript);
+		s_uScriptN = 0;
+		bool bStream = cInput.Record(atStream);
+		for (unsigned uF(0); uF < uFrameN; uF++)
+		{
+			InputFrame sFrame = {};
+			cInput.Next(sFrame, 1.f / 60.f);
+		}
+		cInput.Close();
+		cInput.Source(nullptr);
+		bStream &= cInput.Replay(atStream) && (cInput.Replay_N() == uFrameN);
+
+		// scene as the demo (terrain height fbm * 10, projection 16:9)
+		const float fHeightScale = 10.f, fBound = FbmBound(1.f) * fHeightScale;
+		std::vector<float4> asTilePos, asUpdate;
+		HexTilesLayout(asTilePos, uInstN, uInstN, 1.f, cJobs);
+		HexTilesRecycler cRecycler;
+		cRecycler.Init(asTilePos, float2{ 0.f, 0.f }, uAmbitN, uInstN);
+		HexTilesCuller cCuller;
+		cCuller.Init(uAmbitN, 1.f, -fBound, fBound);
+		Camera sCam = { float3{ 0.f, 10.f, 0.f }, {}, 0.f, 0.f };
+		std::vector<float3> asVtc;
+		std::vector<uint32_t> auIdc;
+		HexMeshTile(1, asVtc, auIdc);
+
+		unsigned uErrN = 0, uCheckN = 0, uFrame = 0;
+		double dMs = 0., dCulled = 0., dCulledMin = 1., dCulledMax = 0., dRangeN = 0.;
+		InputFrame sFrame = {};
+		while (cInput.Next(sFrame, 1.f / 60.f))
+		{
+			CameraIntegrate(sCam, CameraInputFrom(sFrame), sFrame.fDelta, .1f, 4.f, .995f);
+			float2 sUV, sUVc;
+			const float2 sXY = HexTilesCenter(sCam.sPos.x, sCam.sPos.z, sUV, sUVc);
+			asUpdate.clear();
+			cRecycler.Recycle(asTilePos, asUpdate, sXY);
+
+			float afWVP[16];
+			CameraViewProjection(sCam, .25f * 3.14159265f, 16.f / 9.f, 1.f, 1000.f, afWVP);
+			unsigned uVisibleN = 0;
+			dMs += Measure([&]() { uVisibleN = cCuller.Cull(asTilePos, uInstN, cRecycler.Center(), afWVP); });
+			const double dC = 1. - (double)uVisibleN / (double)uInstN;
+			dCulled += dC;
+			dCulledMin = (std::min)(dCulledMin, dC);
+			dCulledMax = (std::max)(dCulledMax, dC);
+			dRangeN += (double)cCuller.Ranges().size();
+
+			// ranges cover the visible tiles in ascending ring order
+			uint32_t uNext = 0, uRingOld = 0;
+			for (const HexCullRange& sR : cCuller.Ranges())
+			{
+				if ((sR.uFirst != uNext) || (sR.uRing < uRingOld)) uErrN++;
+				for (uint32_t uI(sR.uFirst); uI < sR.uFirst + sR.uN; uI++)
+					if (cCuller.Ring(cCuller.Visible()[uI]) != sR.uRing) uErrN++;
+				uNext = sR.uFirst + sR.uN;
+				uRingOld = sR.uRing;
+			}
+			if (uNext != uVisibleN) uErrN++;
+
+			// culled tiles : no vertex inside the clip volume
+			if ((uFrame++ % 128) == 0)
+			{
+				uCheckN++;
+				for (unsigned uI(0); uI < uInstN; uI++)
+				{
+					if (cCuller.Ring(uI) != ~0u) continue;
+					for (const float3& sV : asVtc)
+					{
+						const float fX = asTilePos[uI].x + sV.x, fZ = asTilePos[uI].y + sV.z;
+						const float fY = Fbm(fX * .05f, fZ * .05f, 1.f) * fHeightScale;
+						float afClip[4];
+						for (unsigned uC(0); uC < 4; uC++)
+							afClip[uC] = fX * afWVP[uC] + fY * afWVP[4 + uC] + fZ * afWVP[8 + uC] + afWVP[12 + uC];
+						if ((std::abs(afClip[0]) <= afClip[3]) && (std::abs(afClip[1]) <= afClip[3]) && (afClip[2] >= 0.f) && (afClip[2] <= afClip[3]))
+							uErrN++;
+					}
+				}
+			}
+		}
+		cInput.Close();
+		remove(atStream);
+		if (!bStream || (uFrame != uFrameN)) uErrN++;
+
+		Trace("culled tiles %.1f%% (min %.1f%%, max %.1f%%) of %u, %.1f ring ranges/frame, %.3f ms/frame",
+			100. * dCulled / (double)uFrameN, 100. * dCulledMin, 100. * dCulledMax, uInstN, dRangeN / (double)uFrameN, dMs / (double)uFrameN);
+		Trace("tile box height +-%.2f (fbm bound), camera (%.1f, %.1f, %.1f), %u frames checked", fBound,
+			sCam.sPos.x, sCam.sPos.y, sCam.sPos.z, uCheckN);
+		Trace("tile culling %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// hierarchical tile index (aperture 7) against linear scans over the tile positions : tile at a point,
+	/// tiles within a radius, tiles in a frustum (same results), incremental update while flying against a rebuild
+	/// </summary>
+	static signed TileQuery()
+	{
+		Trace("App_Benchmark::TileQuery");
+		unsigned uErrN = 0;
+		App_Jobsystem cJobs(std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() - 1 : 0);
+		uint32_t uSeed = 12345;
+		auto fRand = [&uSeed]() { uSeed = uSeed * 1664525u + 1013904223u; return (float)(uSeed >> 8) * (1.f / 16777216.f); };
+
+		for (unsigned uAmbitN : { 72u, 256u, 1024u })
+		{
+			const unsigned uInstN = HexTilesN(uAmbitN);
+			const float fField = (float)uAmbitN * 1.5f;
+			std::vector<float4> asTilePos, asUpdate;
+			HexTilesLayout(asTilePos, uInstN, uInstN, 1.f, cJobs);
+			HexTilesIndex cIndex;
+			const double dInitMs = Measure([&]() { cIndex.Init(asTilePos, uInstN); });
+			Trace("%u ambits, %u tiles : %u levels (top %u nodes), build %.1f ms", uAmbitN, uInstN, cIndex.Levels_N(),
+				(unsigned)cIndex.Nodes_N(cIndex.Levels_N() - 1), dInitMs);
+
+			// tile at a point
+			constexpr unsigned uPointN = 64;
+			std::vector<uint32_t> auAt(uPointN), auAtLin(uPointN);
+			std::vector<float2> asPt(uPointN);
+			for (float2& sP : asPt) sP = float2{ (fRand() * 2.f - 1.f) * fField, (fRand() * 2.f - 1.f) * fField };
+			const double dAt = Measure([&]() { for (unsigned uP(0); uP < uPointN; uP++) auAt[uP] = cIndex.At(asPt[uP].x, asPt[uP].y); });
+			const double dAtLin = Measure([&]()
+				{
+					for (unsigned uP(0); uP < uPointN; uP++)
+					{
+						const HexCube sC = HexCubeAt(asPt[uP].x, asPt[uP].y);
+						auAtLin[uP] = ~0u;
+						for (unsigned uI(0); uI < uInstN; uI++)
+							if (HexCubeAt(asTilePos[uI].x, asTilePos[uI].y) == sC) { auAtLin[uP] = uI; break; }
+					}
+				});
+			if (auAt != auAtLin) uErrN++;
+
+			// tiles within a radius (8)
+			constexpr unsigned uRadiusN = 64;
+			std::vector<uint32_t> auR, auRLin;
+			size_t uRN = 0;
+			double dR = 0., dRLin = 0.;
+			for (unsigned uQ(0); uQ < uRadiusN; uQ++)
+			{
+				const float fX = (fRand() * 2.f - 1.f) * fField * .7f, fY = (fRand() * 2.f - 1.f) * fField * .7f;
+				auR.clear();
+				auRLin.clear();
+				dR += Measure([&]() { cIndex.Radius(fX, fY, 8.f, auR); });
+				dRLin += Measure([&]()
+					{
+						for (unsigned uI(0); uI < uInstN; uI++)
+						{
+							const float fDx = asTilePos[uI].x - fX, fDy = asTilePos[uI].y - fY;
+							if (std::sqrt(fDx * fDx + fDy * fDy) <= 8.f) auRLin.push_back(uI);
+						}
+					});
+				std::sort(auR.begin(), auR.end());
+				if (auR != auRLin) uErrN++;
+				uRN += auR.size();
+			}
+
+			// tiles in a frustum (camera at the center, 8 directions, tile box as the demo)
+			const float fEy = FbmBound(1.f) * 10.f;
+			std::vector<uint32_t> auF, auFLin;
+			size_t uFN = 0;
+			double dF = 0., dFLin = 0.;
+			for (unsigned uD(0); uD < 8; uD++)
+			{
+				const Camera sCam = { float3{ 0.f, 10.f, 0.f }, {}, (float)uD * .785398163f, .2f };
+				float afWVP[16];
+				CameraViewProjection(sCam, .25f * 3.14159265f, 16.f / 9.f, 1.f, 1000.f, afWVP);
+				const HexCullFrustum asPlanes = HexCullPlanes(afWVP);
+				const float3 sE = { HexConst<float>::fHalfSqrt3, fEy, 1.f };
+				auF.clear();
+				auFLin.clear();
+				dF += Measure([&]() { cIndex.Frustum(asPlanes, 0.f, fEy, auF); });
+				dFLin += Measure([&]()
+					{
+						for (unsigned uI(0); uI < uInstN; uI++)
+							if (HexCullBox(asPlanes, float3{ asTilePos[uI].x, 0.f, asTilePos[uI].y }, sE)) auFLin.push_back(uI);
+					});
+				std::sort(auF.begin(), auF.end());
+				if (auF != auFLin) uErrN++;
+				uFN += auF.size();
+			}
+
+			// fly (.2 per frame), recycle and update the index
+			constexpr unsigned uFrameN = 256;
+			HexTilesRecycler cRecycler;
+			cRecycler.Init(asTilePos, float2{ 0.f, 0.f }, uAmbitN, uInstN);
+			size_t uMovedN = 0;
+			double dUpdate = 0.;
+			for (unsigned uF(0); uF < uFrameN; uF++)
+			{
+				asUpdate.clear();
+				cRecycler.Recycle(asTilePos, asUpdate, float2{ (float)uF * .2f, (float)uF * .07f });
+				uMovedN += asUpdate.size();
+				dUpdate += Measure([&]() { cIndex.Update(asUpdate); });
+			}
+			for (unsigned uI(0); uI < uInstN; uI += 97)
+				if (cIndex.At(asTilePos[uI].x, asTilePos[uI].y) != uI) uErrN++;
+
+			Trace("  at point   index %9.4f ms linear %9.4f ms per query (x%.0f)", dAt / uPointN, dAtLin / uPointN, dAt > 0. ? dAtLin / dAt : 0.);
+			Trace("  radius 8   index %9.4f ms linear %9.4f ms per query (x%.0f), %.0f tiles", dR / uRadiusN, dRLin / uRadiusN,
+				dR > 0. ? dRLin / dR : 0., (double)uRN / uRadiusN);
+			Trace("  frustum    index %9.4f ms linear %9.4f ms per query (x%.1f), %.0f tiles", dF / 8., dFLin / 8.,
+				dF > 0. ? dFLin / dF : 0., (double)uFN / 8.);
+			Trace("  update     %9.4f ms per frame (%.1f tiles moved), rebuild %.1f ms", dUpdate / uFrameN, (double)uMovedN / uFrameN, dInitMs);
+		}
+
+		Trace("tile query %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// fbm noise stack (zone_fbm.h) per vector width against the scalar port : bitwise mismatches,
+	/// max difference, points/s on one core and across all cores
+	/// </summary>
+	static signed FbmKernels(unsigned uPointN = 1u << 15)
+	{
+		Trace("App_Benchmark::FbmKernels : %u points", uPointN);
+		unsigned uErrN = 0;
+		App_Jobsystem cJobs(std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() - 1 : 0);
+
+		// points in the range of the terrain (fbm scale .05 over 1024 ambits)
+		uint32_t uSeed = 12345;
+		auto fRand = [&uSeed]() { uSeed = uSeed * 1664525u + 1013904223u; return (float)(uSeed >> 8) * (1.f / 16777216.f); };
+		std::vector<float> afX(uPointN), afY(uPointN);
+		for (unsigned uI(0); uI < uPointN; uI++)
+		{
+			afX[uI] = (fRand() - .5f) * 160.f;
+			afY[uI] = (fRand() - .5f) * 160.f;
+		}
+
+		uErrN += FbmKernelsWidth<float>("scalar", afX, afY, cJobs);
+#ifdef FBM_SIMD_SSE2
+		uErrN += FbmKernelsWidth<FbmV4>("sse2 x4", afX, afY, cJobs);
+#endif
+#ifdef FBM_SIMD_AVX2
+		uErrN += FbmKernelsWidth<FbmV8>("avx2 x8", afX, afY, cJobs);
+#endif
+#ifdef FBM_SIMD_AVX512
+		uErrN += FbmKernelsWidth<FbmV16>("avx512 x16", afX, afY, cJobs);
+#endif
+
+		Trace("fbm kernels %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// gradient hashes of the noise stack, sin hash against integer hash : value range, distribution
+	/// (mean, variance, chi-square over 64 bins, neighbour correlation, distinct values) by lattice
+	/// block offset, hashes/s scalar and widest SIMD
+	/// </summary>
+	static signed FbmHashes(unsigned uBlock = 256)
+	{
+		Trace("App_Benchmark::FbmHashes : %ux%u lattice points per offset, hash selected : %s", uBlock, uBlock, FBM_HASH_INTEGER ? "integer" : "sin");
+		unsigned uErrN = 0;
+		const size_t uN = (size_t)uBlock * uBlock;
+		std::vector<float> afX(uN), afY(uN), afH(uN), afV(uN);
+
+		// fHash(x, y) scalar, fBatch(x, y, out) widest SIMD
+		auto fHashTest = [&](const char* atName, bool bInteger, auto fHash, auto fBatch)
+		{
+			for (float fOffset : { 0.f, 1000.f, 100000.f, 4000000.f })
+			{
+				for (unsigned uI(0); uI < uN; uI++)
+				{
+					afX[uI] = fOffset + (float)(uI % uBlock);
+					afY[uI] = fOffset + (float)(uI / uBlock);
+				}
+				const double dMs = Measure([&]() { for (size_t uI(0); uI < uN; uI++) afH[uI] = fHash(afX[uI], afY[uI]); });
+				const double dBatchMs = Measure([&]() { fBatch(afX.data(), afY.data(), afV.data()); });
+
+				// range, moments, chi-square, neighbour (x + 1) correlation, distinct values
+				float fMin = 1e30f, fMax = -1e30f;
+				double dSum = 0., dSq = 0., dCross = 0.;
+				std::array<unsigned, 64> auBin = {};
+				size_t uMismatchN = 0;
+				for (size_t uI(0); uI < uN; uI++)
+				{
+					const float fH = afH[uI];
+					fMin = (std::min)(fMin, fH);
+					fMax = (std::max)(fMax, fH);
+					dSum += fH;
+					dSq += (double)fH * fH;
+					auBin[(std::min)((unsigned)((fH + 1.f) * 32.f), 63u)]++;
+					if ((uI % uBlock) + 1 < uBlock) dCross += (double)fH * afH[uI + 1];
+					if (afV[uI] != fH) uMismatchN++;
+				}
+				const double dMean = dSum / (double)uN, dVar = dSq / (double)uN - dMean * dMean;
+				const double dCorr = (dCross / (double)(uN - uBlock) - dMean * dMean) / (std::max)(dVar, 1e-30);
+				double dChi = 0.;
+				const double dExp = (double)uN / 64.;
+				for (unsigned uB : auBin) dChi += ((double)uB - dExp) * ((double)uB - dExp) / dExp;
+				std::vector<float> afSorted(afH);
+				std::sort(afSorted.begin(), afSorted.end());
+				const size_t uDistinctN = (size_t)(std::unique(afSorted.begin(), afSorted.end()) - afSorted.begin());
+
+				Trace("  %-7s offset %9.0f : range [%.4f, %.4f] mean %+.4f var %.4f (1/3) chi2 %8.1f (63 dof) corr %+.4f distinct %5.1f%%, %6.1f Mhash/s scalar %6.1f Mhash/s simd (mismatch %u)",
+					atName, fOffset, fMin, fMax, dMean, dVar, dChi, dCorr, 100. * (double)uDistinctN / (double)uN,
+					dMs > 0. ? (double)uN / (dMs * 1000.) : 0., dBatchMs > 0. ? (double)uN / (dBatchMs * 1000.) : 0., (unsigned)uMismatchN);
+
+				// simd equals scalar (sin : |v| < 1.6 * 10^6), integer hash : range [-1, 1), uniform, uncorrelated at all offsets
+				if (uMismatchN && (bInteger || (fOffset * 100.f < 1.6e6f))) uErrN++;
+				if (bInteger && ((fMin < -1.f) || (fMax >= 1.f) || (std::abs(dMean) > .01) || (std::abs(dVar - 1. / 3.) > .01) ||
+					(dChi > 150.) || (std::abs(dCorr) > .02) || (uDistinctN < uN * 99 / 100))) uErrN++;
+			}
+		};
+
+		fHashTest("sin", false, [](float fX, float fY) { return FbmHashSin(fX, fY); },
+			[uN](const float* pfX, const float* pfY, float* pfOut) { FbmHashSinBatch(pfX, pfY, uN, pfOut); });
+		fHashTest("integer", true, [](float fX, float fY) { return FbmHashInt(fX, fY); },
+			[uN](const float* pfX, const float* pfY, float* pfOut) { FbmHashIntBatch(pfX, pfY, uN, pfOut); });
+
+		// hash12() twin (CS_demo02.hlsl, any point, scalar only) : [0, 1), uniform at fractional and integral points,
+		// integer hash : distinct for distinct float bits at all offsets (points not exact at the offset are skipped)
+		for (float fOffset : { 0.f, 1000.f, 100000.f, 4000000.f })
+			for (float fScale : { .125f, 1.f })
+			{
+				if ((fOffset + fScale) - fOffset != fScale) continue;
+				std::array<unsigned, 64> auBin = {};
+				double dSum = 0., dSq = 0.;
+				float fMin = 1e30f, fMax = -1e30f;
+				for (size_t uI(0); uI < uN; uI++)
+				{
+					afX[uI] = fOffset + (float)(uI % uBlock) * fScale;
+					afY[uI] = fOffset + (float)(uI / uBlock) * fScale;
+					const float fH = afH[uI] = FbmHash12(afX[uI], afY[uI]);
+					fMin = (std::min)(fMin, fH);
+					fMax = (std::max)(fMax, fH);
+					dSum += fH;
+					dSq += (double)fH * fH;
+					auBin[(std::min)((unsigned)(fH * 64.f), 63u)]++;
+				}
+				const double dMean = dSum / (double)uN, dVar = dSq / (double)uN - dMean * dMean, dExp = (double)uN / 64.;
+				double dChi = 0.;
+				for (unsigned uB : auBin) dChi += ((double)uB - dExp) * ((double)uB - dExp) / dExp;
+				std::sort(afH.begin(), afH.end());
+				const size_t uDistinctN = (size_t)(std::unique(afH.begin(), afH.end()) - afH.begin());
+
+				Trace("  hash12  offset %9.0f scale %.3f : range [%.4f, %.4f] mean %.4f var %.4f (1/12) chi2 %8.1f (63 dof) distinct %5.1f%%",
+					fOffset, fScale, fMin, fMax, dMean, dVar, dChi, 100. * (double)uDistinctN / (double)uN);
+				if ((fMin < 0.f) || (fMax >= 1.f)) uErrN++;
+				if (FBM_HASH_INTEGER && ((std::abs(dMean - .5) > .01) || (std::abs(dVar - 1. / 12.) > .01) || (dChi > 150.) ||
+					(uDistinctN < uN * 99 / 100))) uErrN++;
+			}
+
+		Trace("fbm hashes %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// analytic fbm derivatives (FbmDer) against 4th order central differences of Fbm, normals
+	/// (FbmNormalDer) against finite difference normals and fbm_normal (.02 square), noise
+	/// evaluations and points/s per shaded point of both normal methods
+	/// </summary>
+	static signed FbmNormals(unsigned uPointN = 1u << 14)
+	{
+		Trace("App_Benchmark::FbmNormals : %u points", uPointN);
+		unsigned uErrN = 0;
+		uint32_t uSeed = 4711;
+		auto fRand = [&uSeed]() { uSeed = uSeed * 1664525u + 1013904223u; return (float)(uSeed >> 8) * (1.f / 16777216.f); };
+		auto fAngle = [](const float3& sA, const float3& sB)
+		{
+			const double dDot = (double)sA.x * sB.x + (double)sA.y * sB.y + (double)sA.z * sB.z;
+			return std::acos((std::min)((std::max)(dDot, -1.), 1.)) * 57.29577951308232;
+		};
+		auto fNormalOf = [](float fDx, float fDy, float fS)
+		{
+			const float fCx = -fS * fDx, fCz = -fS * fDy, fLenInv = 1.f / std::sqrt(fCx * fCx + 1.f + fCz * fCz);
+			return float3{ fCx * fLenInv, -fLenInv, fCz * fLenInv };
+		};
+
+		// derivative step 2^-9 (exact offsets), 4th order : error O(h^4)
+		const float fStep = 1.f / 512.f;
+		double dDerMax = 0., dDerSum = 0., dFdMax = 0., dFdSum = 0., dCdMax = 0., dCdSum = 0., dHeightMax = 0.;
+		std::vector<float> afX(uPointN), afY(uPointN);
+		for (unsigned uP(0); uP < uPointN; uP++)
+		{
+			const float fX = afX[uP] = (fRand() - .5f) * 160.f, fY = afY[uP] = (fRand() - .5f) * 160.f;
+			auto fDiff = [&](float fEx, float fEy)
+			{
+				auto fF = [&](float fK) { return Fbm(fX + fK * fEx, fY + fK * fEy, 1.f); };
+				return (-fF(2.f) + 8.f * fF(1.f) - 8.f * fF(-1.f) + fF(-2.f)) / (12.f * fStep);
+			};
+			float fDx, fDy;
+			const float fT = FbmDer(fX, fY, 1.f, fDx, fDy);
+			const float fFdx = fDiff(fStep, 0.f), fFdy = fDiff(0.f, fStep);
+			const double dErr = (std::max)(std::abs(fDx - fFdx), std::abs(fDy - fFdy)) / (1. + std::sqrt((double)fDx * fDx + (double)fDy * fDy));
+			dDerMax = (std::max)(dDerMax, dErr);
+			dDerSum += dErr;
+			if (fT != Fbm(fX, fY, 1.f)) uErrN++;
+
+			// normals : analytic, finite difference derivatives, fbm_normal
+			float fTerrain, fTerrainCd;
+			float3 sN, sCd;
+			FbmNormalDer(fX, fY, 1.f, fTerrain, sN);
+			FbmNormal(fX, fY, 1.f, fTerrainCd, sCd);
+			const double dFd = fAngle(sN, fNormalOf(fFdx, fFdy, .02f)), dCd = fAngle(sN, sCd);
+			dFdMax = (std::max)(dFdMax, dFd);
+			dFdSum += dFd;
+			dCdMax = (std::max)(dCdMax, dCd);
+			dCdSum += dCd;
+			dHeightMax = (std::max)(dHeightMax, (double)std::abs(fTerrain - fTerrainCd));
+		}
+		// noise is C2 (quintic), differences across lattice lines are 2nd order : max error ~ 10^-2
+		if (dDerMax > 5e-2) uErrN++;
+		if (dFdMax > .1) uErrN++;
+		Trace("  derivatives vs 4th order differences : relative error mean %.2e max %.2e", dDerSum / uPointN, dDerMax);
+		Trace("  normal vs difference normal          : mean %.4f max %.4f degrees", dFdSum / uPointN, dFdMax);
+		Trace("  normal vs fbm_normal (.02 square)    : mean %.4f max %.4f degrees, height max diff %.4f", dCdSum / uPointN, dCdMax, dHeightMax);
+
+		// cost per shaded point : fbm_normal 4 fbm (4 * octaves noised), fbm_normal_der 1 fbm_der (octaves noised_der)
+		std::vector<float> afT(uPointN), afNx(uPointN), afNy(uPointN), afNz(uPointN);
+		double dCdMs = 1e30, dDerMs = 1e30;
+		for (unsigned uR(0); uR < 3; uR++)
+		{
+			dCdMs = (std::min)(dCdMs, Measure([&]() { FbmNormalBatch(afX.data(), afY.data(), uPointN, 1.f, afT.data(), afNx.data(), afNy.data(), afNz.data()); }));
+			dDerMs = (std::min)(dDerMs, Measure([&]() { FbmNormalDerBatch(afX.data(), afY.data(), uPointN, 1.f, afT.data(), afNx.data(), afNy.data(), afNz.data()); }));
+		}
+		Trace("  fbm_normal     %2d noise evaluations (%3d hashes) per point, %8.2f Mpoints/s", 4 * FBM_OCTAVES, 16 * FBM_OCTAVES,
+			dCdMs > 0. ? (double)uPointN / (dCdMs * 1000.) : 0.);
+		Trace("  fbm_normal_der %2d noise evaluations (%3d hashes) per point, %8.2f Mpoints/s (x%.1f)", FBM_OCTAVES, 4 * FBM_OCTAVES,
+			dDerMs > 0. ? (double)uPointN / (dDerMs * 1000.) : 0., dDerMs > 0. ? dCdMs / dDerMs : 0.);
+
+		Trace("fbm normals %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// baked terrain pyramid (zone_bake.h) : interrupted and resumed bake, texels against the terrain
+	/// (level 0 : fbm_normal_der, level 1 : tent taps), paging along a flight, bilinear sampling
+	/// against fbm_normal_der per point
+	/// </summary>
+	static signed TerrainBake(unsigned uTilesN = 8, unsigned uLevelN = 4)
+	{
+		Trace("App_Benchmark::TerrainBake : %ux%u tiles, %u levels", uTilesN, uTilesN, uLevelN);
+		unsigned uErrN = 0;
+		App_Jobsystem cJobs(std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() - 1 : 0);
+		const char* atFile = "App_Benchmark_bake.bin";
+		remove(atFile);
+
+		// terrain as the demo, centered, level 0 texel .5
+		const float fTexel = .5f, fSpan = (float)(HEX_BAKE_TILE_S - 1) * fTexel * (float)uTilesN;
+		const HexBakeDesc sDesc = { -fSpan * .5f, -fSpan * .5f, fTexel, uTilesN, uTilesN, uLevelN, .05f, 10.f, 1.f };
+
+		// bake half, close (interrupted), resume
+		double dBakeMs = 0.;
+		unsigned uTileN = 0, uFirstN = 0;
+		{
+			HexBakePyramid cBake;
+			if (cBake.Create(atFile, sDesc) != APP_FORWARD) { Trace("terrain bake FAILED (create)"); return APP_ERROR; }
+			uTileN = cBake.Tiles_N();
+			uFirstN = uTileN / 2;
+			dBakeMs += Measure([&]() { if (cBake.Bake(cJobs, uFirstN) != uTileN - uFirstN) uErrN++; });
+		}
+		{
+			HexBakePyramid cBake;
+			if (cBake.Create(atFile, sDesc) != APP_FORWARD) uErrN++;
+			if (cBake.Baked_N() != uFirstN) uErrN++;
+			dBakeMs += Measure([&]() { if (cBake.Bake(cJobs) != 0) uErrN++; });
+			if (cBake.Baked_N() != uTileN) uErrN++;
+		}
+		HexBakePyramid cPyramid;
+		if (cPyramid.Open(atFile) != APP_FORWARD) { remove(atFile); Trace("terrain bake FAILED (open)"); return APP_ERROR; }
+		const double dFileMb = (double)cPyramid.Header().uFileSz / (1024. * 1024.);
+		Trace("  bake    %u tiles (%u before the interruption, resumed), %.1f MB, %.0f ms, %.2f Mtexels/s",
+			uTileN, uFirstN, dFileMb, dBakeMs, dBakeMs > 0. ? (double)uTileN * HEX_BAKE_TILE_S * HEX_BAKE_TILE_S / (dBakeMs * 1000.) : 0.);
+
+		// texels : level 0 fbm_normal_der (normal snorm16), level 1 tent filtered fbm_der
+		cPyramid.Page(0.f, 0.f, fSpan);
+		if (cPyramid.Mapped_N() != uTileN) uErrN++;
+		double dTexelMax = 0.;
+		float3 sN;
+		for (uint32_t uTy(0); uTy < cPyramid.Tiles_Y(0); uTy++)
+			for (uint32_t uTx(0); uTx < cPyramid.Tiles_X(0); uTx++)
+			{
+				const HexBakeTexel* psTile = cPyramid.Tile(0, uTx, uTy);
+				if (!psTile) { uErrN++; continue; }
+				for (uint32_t uJ(0); uJ < HEX_BAKE_TILE_S; uJ += 9)
+					for (uint32_t uI(0); uI < HEX_BAKE_TILE_S; uI += 7)
+					{
+						const float fX = sDesc.fOriginX + (float)(uTx * (HEX_BAKE_TILE_S - 1) + uI) * fTexel;
+						const float fY = sDesc.fOriginY + (float)(uTy * (HEX_BAKE_TILE_S - 1) + uJ) * fTexel;
+						float fT;
+						FbmNormalDer(fX * .05f, fY * .05f, 1.f, fT, sN);
+						const HexBakeTexel& sT = psTile[uJ * HEX_BAKE_TILE_S + uI];
+						dTexelMax = (std::max)(dTexelMax, (double)std::abs(sT.fHeight - fT * 10.f));
+						if ((std::abs(sT.nNx - sN.x * 32767.f) > 1.f) || (std::abs(sT.nNz - sN.z * 32767.f) > 1.f)) uErrN++;
+					}
+			}
+		if (dTexelMax > 1e-4) uErrN++;
+		double dLevel1Max = 0.;
+		if (uLevelN > 1)
+			for (unsigned uS(0); uS < 256; uS++)
+			{
+				const uint32_t uI = (uS * 37) % HEX_BAKE_TILE_S, uJ = (uS * 91) % HEX_BAKE_TILE_S;
+				const HexBakeTexel* psTile = cPyramid.Tile(1, 0, 0);
+				if (!psTile) { uErrN++; break; }
+				float fH = 0.f;
+				const float afW[3] = { .25f, .5f, .25f };
+				for (int32_t nTy(0); nTy < 3; nTy++)
+					for (int32_t nTx(0); nTx < 3; nTx++)
+					{
+						float fDx, fDy;
+						const float fX = sDesc.fOriginX + (float)uI * 2.f * fTexel + (float)(nTx - 1) * fTexel;
+						const float fY = sDesc.fOriginY + (float)uJ * 2.f * fTexel + (float)(nTy - 1) * fTexel;
+						fH += afW[nTx] * afW[nTy] * FbmDer(fX * .05f, fY * .05f, 1.f, fDx, fDy);
+					}
+				dLevel1Max = (std::max)(dLevel1Max, (double)std::abs(psTile[uJ * HEX_BAKE_TILE_S + uI].fHeight - fH * 10.f));
+			}
+		if (dLevel1Max > 1e-3) uErrN++;
+		Trace("  texels  level 0 vs fbm_normal_der max %.2e, level 1 vs tent taps max %.2e", dTexelMax, dLevel1Max);
+
+		// flight through the field : paged tiles around the camera
+		const unsigned uStepN = 200;
+		const float fRadius = fSpan * .125f;
+		double dPageMs = 0.;
+		unsigned uMappedMax = 0;
+		for (unsigned uS(0); uS < uStepN; uS++)
+		{
+			const float fT = (float)uS / (float)uStepN;
+			const float fX = (fT - .5f) * fSpan * .8f, fY = std::sin(fT * 6.283f) * fSpan * .3f;
+			unsigned uMapped = 0;
+			dPageMs += Measure([&]() { uMapped = cPyramid.Page(fX, fY, fRadius); });
+			uMappedMax = (std::max)(uMappedMax, uMapped);
+
+			// the camera position is mapped on every level
+			float fH;
+			for (unsigned uL(0); uL < uLevelN; uL++)
+				if (!cPyramid.Sample(fX, fY, uL, fH, sN)) uErrN++;
+		}
+		Trace("  paging  radius %.0f : max %u of %u tiles mapped (%.1f of %.1f MB), %.3f ms per page", fRadius, uMappedMax, uTileN,
+			(double)uMappedMax * HexBakePyramid::s_uTileSz / (1024. * 1024.), dFileMb, dPageMs / uStepN);
+
+		// bilinear sampling near the camera against the terrain per point
+		const unsigned uSampleN = 1u << 16;
+		uint32_t uSeed = 777;
+		auto fRand = [&uSeed]() { uSeed = uSeed * 1664525u + 1013904223u; return (float)(uSeed >> 8) * (1.f / 16777216.f); };
+		std::vector<float2> asPt(uSampleN);
+		for (float2& sP : asPt) sP = float2{ (fRand() - .5f) * fRadius, (fRand() - .5f) * fRadius };
+		cPyramid.Page(0.f, 0.f, fRadius);
+		std::vector<float> afBaked(uSampleN), afDirect(uSampleN);
+		unsigned uMissN = 0;
+		const double dSampleMs = Measure([&]()
+			{
+				for (unsigned uP(0); uP < uSampleN; uP++)
+					if (!cPyramid.Sample(asPt[uP].x, asPt[uP].y, 0, afBaked[uP], sN)) uMissN++;
+			});
+		const double dDirectMs = Measure([&]()
+			{
+				for (unsigned uP(0); uP < uSampleN; uP++)
+					FbmNormalDer(asPt[uP].x * .05f, asPt[uP].y * .05f, 1.f, afDirect[uP], sN);
+			});
+		double dErrSum = 0., dErrMax = 0.;
+		for (unsigned uP(0); uP < uSampleN; uP++)
+		{
+			const double dErr = std::abs(afBaked[uP] - afDirect[uP] * 10.f);
+			dErrSum += dErr;
+			dErrMax = (std::max)(dErrMax, dErr);
+		}
+		if (uMissN) uErrN++;
+		Trace("  sample  bilinear %.2f Msamples/s, fbm_normal_der %.2f Mpoints/s (x%.1f), height error mean %.4f max %.4f (texel %.2f)",
+			dSampleMs > 0. ? uSampleN / (dSampleMs * 1000.) : 0., dDirectMs > 0. ? uSampleN / (dDirectMs * 1000.) : 0.,
+			dSampleMs > 0. ? dDirectMs / dSampleMs : 0., dErrSum / uSampleN, dErrMax, fTexel);
+
+		cPyramid.Close();
+		remove(atFile);
+		Trace("terrain bake %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+	/// <summary>
+	/// compile time octave counts (FbmN, FbmLod) : equality with Fbm at the full count, continuity of the
+	/// fractional count, points/s per octave count, and a terrain image (ground plane hits of a camera,
+	/// height and lambert shading by FbmNormalDer) with octaves by distance against all octaves
+	/// </summary>
+	static signed FbmOctaves(unsigned uWidth = 320, unsigned uHeight = 180, unsigned uPointN = 1u << 14)
+	{
+		Trace("App_Benchmark::FbmOctaves : %ux%u image, %u points", uWidth, uHeight, uPointN);
+		unsigned uErrN = 0;
+		uint32_t uSeed = 1234;
+		auto fRand = [&uSeed]() { uSeed = uSeed * 1664525u + 1013904223u; return (float)(uSeed >> 8) * (1.f / 16777216.f); };
+		std::vector<float> afX(uPointN), afY(uPointN), afOut(uPointN);
+		for (unsigned uP(0); uP < uPointN; uP++)
+		{
+			afX[uP] = (fRand() - .5f) * 160.f;
+			afY[uP] = (fRand() - .5f) * 160.f;
+		}
+
+		// full count equals Fbm, FbmDer bitwise, the fractional count is continuous : a count k + e
+		// adds octave k + 1 at weight e (|noised| <= 2, amplitude <= 1, jump <= 2e)
+		const float fEps = 1.f / 1024.f;
+		unsigned uMismatchN = 0;
+		double dJumpMax = 0.;
+		for (unsigned uP(0); uP < uPointN; uP++)
+		{
+			const float fX = afX[uP], fY = afY[uP];
+			float fDx, fDy, fDxL, fDyL;
+			const float fT = FbmDer(fX, fY, 1.f, fDx, fDy), fTL = FbmDerLod(fX, fY, 1.f, (float)FBM_OCTAVES, fDxL, fDyL);
+			if (FbmLod(fX, fY, 1.f, (float)FBM_OCTAVES) != Fbm(fX, fY, 1.f) || fT != fTL || fDx != fDxL || fDy != fDyL) uMismatchN++;
+			for (int nK(1); nK < FBM_OCTAVES; nK++)
+				dJumpMax = (std::max)(dJumpMax, (double)std::abs(FbmLod(fX, fY, 1.f, (float)nK + fEps) - FbmLod(fX, fY, 1.f, (float)nK)));
+		}
+		if (uMismatchN || dJumpMax > 2. * fEps * 1.01) uErrN++;
+		Trace("  full count vs Fbm, FbmDer : %u mismatches, fade jump max %.2e (bound %.2e)", uMismatchN, dJumpMax, 2. * fEps);
+
+		// points/s per octave count (widest vector, one specialisation per batch)
+		double adMs[FBM_OCTAVES + 1] = {};
+		for (int nK(1); nK <= FBM_OCTAVES; nK++)
+		{
+			adMs[nK] = 1e30;
+			for (unsigned uR(0); uR < 3; uR++)
+				adMs[nK] = (std::min)(adMs[nK], Measure([&]() { FbmLodBatch(afX.data(), afY.data(), uPointN, 1.f, (float)nK, afOut.data()); }));
+		}
+		// batch (one specialisation per call) equals FbmLod per point, integral and fractional counts
+		unsigned uBatchN = 0;
+		for (const float fOctaves : { 1.f, 1.5f, 2.f, 3.25f, 4.f, 5.75f, 6.f })
+		{
+			FbmLodBatch(afX.data(), afY.data(), uPointN, 1.f, fOctaves, afOut.data());
+			for (unsigned uP(0); uP < uPointN; uP++)
+				if (afOut[uP] != FbmLod(afX[uP], afY[uP], 1.f, fOctaves)) uBatchN++;
+		}
+		if (uBatchN) uErrN++;
+		Trace("  FbmLodBatch vs FbmLod : %u mismatches (counts 1, 1.5, 2, 3.25, 4, 5.75, 6)", uBatchN);
+		for (int nK(1); nK <= FBM_OCTAVES; nK++)
+			Trace("  %d octaves : %8.2f Mpoints/s (x%.2f of %d octaves)", nK, adMs[nK] > 0. ? (double)uPointN / (adMs[nK] * 1000.) : 0.,
+				adMs[nK] > 0. ? adMs[FBM_OCTAVES] / adMs[nK] : 0., FBM_OCTAVES);
+
+		// camera as the demo (fov pi / 4), eye 20 above the ground plane, pitched down .1, the ray marched
+		// far field only (ground hits beyond the tile rim, 80.8 in CS_demo00, up to 1000), uSuperN^2
+		// samples per pixel for the pixel averaged reference
+		const unsigned uSuperN = 4;
+		const float fFovY = .7853982f, fPixelAngle = FbmPixelAngle(fFovY, (float)uHeight);
+		const float fEyeY = 20.f, fPitch = .1f, fRim = 80.8f, fFbmScale = .05f, fHeightScale = 10.f;
+		const float fTan = std::tan(fFovY * .5f), fAspect = (float)uWidth / (float)uHeight;
+		const float fSp = std::sin(fPitch), fCp = std::cos(fPitch);
+		struct Hit { float fX, fZ, fDist; };
+		auto fHit = [&](float fPx, float fPy, Hit& sHit)
+		{
+			const float fU = (fPx / (float)uWidth * 2.f - 1.f) * fTan * fAspect;
+			const float fV = (1.f - fPy / (float)uHeight * 2.f) * fTan;
+			// right (1, 0, 0), up (0, cos, sin), forward (0, -sin, cos)
+			const float fDx = fU, fDy = fV * fCp - fSp, fDz = fV * fSp + fCp;
+			const float fLen = std::sqrt(fDx * fDx + fDy * fDy + fDz * fDz);
+			if (fDy >= -1e-3f * fLen) return false;
+			const float fT = fEyeY * fLen / -fDy;
+			sHit = Hit{ fT * fDx / fLen, fT * fDz / fLen, fT };
+			return fT >= fRim && fT <= 1000.f;
+		};
+		std::vector<Hit> asHit, asSuper;
+		std::vector<uint32_t> auSuperFirst(1, 0);
+		for (unsigned uY(0); uY < uHeight; uY++)
+			for (unsigned uX(0); uX < uWidth; uX++)
+			{
+				Hit sHit;
+				if (!fHit((float)uX + .5f, (float)uY + .5f, sHit)) continue;
+				asHit.push_back(sHit);
+				for (unsigned uS(0); uS < uSuperN * uSuperN; uS++)
+					if (fHit((float)uX + ((float)(uS % uSuperN) + .5f) / (float)uSuperN, (float)uY + ((float)(uS / uSuperN) + .5f) / (float)uSuperN, sHit))
+						asSuper.push_back(sHit);
+				auSuperFirst.push_back((uint32_t)asSuper.size());
+			}
+
+		// shade (lambert, light as PS_phong) and height of hits, octaves : fCellPixels > 0 - by distance,
+		// else nFixed everywhere, returns evaluated octaves per hit
+		const size_t uHitN = asHit.size();
+		const float fLx = .2f, fLy = -.6f, fLz = .5f, fLInv = 1.f / std::sqrt(fLx * fLx + fLy * fLy + fLz * fLz);
+		auto fShade = [&](const std::vector<Hit>& asIn, float fCellPixels, int nFixed, std::vector<float>& afShade, std::vector<float>& afHeight)
+		{
+			afShade.resize(asIn.size());
+			afHeight.resize(asIn.size());
+			double dOctaves = 0.;
+			for (size_t uH(0); uH < asIn.size(); uH++)
+			{
+				const Hit& sHit = asIn[uH];
+				const float fOctaves = (fCellPixels > 0.f) ? FbmOctavesAt(sHit.fDist, fPixelAngle, fFbmScale, fCellPixels) : (float)nFixed;
+				float fTerrain;
+				float3 sN;
+				FbmNormalDer(sHit.fX * fFbmScale, sHit.fZ * fFbmScale, 1.f, fTerrain, sN, .02f, fOctaves);
+				afShade[uH] = (std::max)((sN.x * fLx + sN.y * fLy + sN.z * fLz) * fLInv, 0.f);
+				afHeight[uH] = fTerrain * fHeightScale;
+				dOctaves += std::ceil(fOctaves);
+			}
+			return asIn.empty() ? 0. : dOctaves / (double)asIn.size();
+		};
+		std::vector<float> afShadeRef, afHeightRef, afShade, afHeight, afShadeAvg, afHeightAvg;
+		const double dRefMs = Measure([&]() { fShade(asHit, 0.f, FBM_OCTAVES, afShadeRef, afHeightRef); });
+		fShade(asSuper, 0.f, FBM_OCTAVES, afShadeAvg, afHeightAvg);
+		std::vector<float> afShadeTrue(uHitN);
+		for (size_t uH(0); uH < uHitN; uH++)
+		{
+			double dSum = 0.;
+			for (uint32_t uS = auSuperFirst[uH]; uS < auSuperFirst[uH + 1]; uS++) dSum += afShadeAvg[uS];
+			afShadeTrue[uH] = (auSuperFirst[uH + 1] > auSuperFirst[uH]) ? (float)(dSum / (double)(auSuperFirst[uH + 1] - auSuperFirst[uH])) : afShadeRef[uH];
+		}
+		Trace("  image %zu far field pixels (distance %.1f..1000), all %d octaves %.2f ms", uHitN, fRim, FBM_OCTAVES, dRefMs);
+
+		// shade error in 8 bit levels against all octaves and against the pixel average, height error in world units
+		auto fRms = [&](const std::vector<float>& afA, const std::vector<float>& afB, double& dMax)
+		{
+			double dSq = 0.;
+			dMax = 0.;
+			for (size_t uH(0); uH < uHitN; uH++)
+			{
+				const double dErr = std::abs((double)afA[uH] - afB[uH]);
+				dSq += dErr * dErr;
+				dMax = (std::max)(dMax, dErr);
+			}
+			return uHitN ? std::sqrt(dSq / (double)uHitN) : 0.;
+		};
+		double dMax;
+		const double dFullTrue = fRms(afShadeRef, afShadeTrue, dMax);
+		Trace("  %-12s %.2f octaves/pixel                     shade vs %ux%u average rmse %5.2f levels", "all", (double)FBM_OCTAVES, uSuperN, uSuperN, dFullTrue * 255.);
+		auto fCompare = [&](const char* atName, float fCellPixels, int nFixed, double& dTrue)
+		{
+			double dOctaves = 0.;
+			const double dMs = Measure([&]() { dOctaves = fShade(asHit, fCellPixels, nFixed, afShade, afHeight); });
+			double dShadeMax, dHeightMax, dTrueMax;
+			const double dRmse = fRms(afShade, afShadeRef, dShadeMax), dHeight = fRms(afHeight, afHeightRef, dHeightMax);
+			dTrue = fRms(afShade, afShadeTrue, dTrueMax);
+			Trace("  %-12s %.2f octaves/pixel %6.2f ms (x%.2f), shade vs %ux%u average rmse %5.2f levels, vs all octaves rmse %5.2f max %6.2f levels psnr %5.1f dB, height rms %.3f max %.3f",
+				atName, dOctaves, dMs, dMs > 0. ? dRefMs / dMs : 0., uSuperN, uSuperN, dTrue * 255., dRmse * 255., dShadeMax * 255.,
+				dRmse > 0. ? 20. * std::log10(1. / dRmse) : 99., dHeight, dHeightMax);
+			return dRmse;
+		};
+		double adRmse[3] = {}, adTrue[3] = {}, dTrue;
+		const float afCell[3] = { 1.f, 2.f, 4.f };
+		for (unsigned uC(0); uC < 3; uC++)
+		{
+			char atName[32];
+			snprintf(atName, sizeof(atName), "cell %.0f px", afCell[uC]);
+			adRmse[uC] = fCompare(atName, afCell[uC], 0, adTrue[uC]);
+		}
+		for (int nK(FBM_OCTAVES - 1); nK >= 2; nK--)
+		{
+			char atName[32];
+			snprintf(atName, sizeof(atName), "fixed %d", nK);
+			fCompare(atName, 0.f, nK, dTrue);
+		}
+		// coarser cells drop more octaves (further from all octaves), the default (2 px, Nyquist) no
+		// further from the pixel average than all octaves
+		if (!(adRmse[0] <= adRmse[1] && adRmse[1] <= adRmse[2]) || adTrue[1] > dFullTrue) uErrN++;
+
+		// selector at 1080 lines (cell 2 px) by ray distance and by tile ring (tile size 8, eye 20)
+		const float fPixel1080 = FbmPixelAngle(fFovY, 1080.f);
+		Trace("  1080 lines, distance 100 / 250 / 500 / 1000 : %.2f / %.2f / %.2f / %.2f octaves, ring 4 / 16 / 64 : %.2f / %.2f / %.2f octaves",
+			FbmOctavesAt(100.f, fPixel1080, fFbmScale), FbmOctavesAt(250.f, fPixel1080, fFbmScale), FbmOctavesAt(500.f, fPixel1080, fFbmScale),
+			FbmOctavesAt(1000.f, fPixel1080, fFbmScale), FbmOctavesRing(4, 8.f, fEyeY, fPixel1080, fFbmScale),
+			FbmOctavesRing(16, 8.f, fEyeY, fPixel1080, fFbmScale), FbmOctavesRing(64, 8.f, fEyeY, fPixel1080, fFbmScale));
+
+		Trace("fbm octaves %s", uErrN ? "FAILED" : "ok");
+		return uErrN ? APP_ERROR : APP_FORWARD;
+	}
+
+private:
+	/// <summary>fbm kernels of one vector width, returns the number of errors (mismatch rate above 10^-5)</summary>
+	template <typename V>
+	static unsigned FbmKernelsWidth(const char* atName, const std::vector<float>& afX, const std::vector<float>& afY, App_Jobsystem& cJobs)
+	{
+		const size_t uN = afX.size();
+		unsigned uErrN = 0;
+		std::vector<float> afRef(uN * 4), afOut(uN * 4);
+		auto fPlanes = [uN](std::vector<float>& af, size_t uOffset) { return std::array<float*, 4>{ &af[uOffset], &af[uN + uOffset], &af[2 * uN + uOffset], &af[3 * uN + uOffset] }; };
+
+		// fBatch(width tag, x, y, n, output planes)
+		auto fKernel = [&](const char* atKernel, unsigned uOutN, auto fBatch)
+		{
+			fBatch(0.f, afX.data(), afY.data(), uN, fPlanes(afRef, 0));
+			// best of 3
+			double dMs = 1e30, dJobsMs = 1e30;
+			for (unsigned uR(0); uR < 3; uR++)
+			{
+				dMs = (std::min)(dMs, Measure([&]() { fBatch(V{}, afX.data(), afY.data(), uN, fPlanes(afOut, 0)); }));
+				dJobsMs = (std::min)(dJobsMs, Measure([&]()
+					{
+						cJobs.ParallelFor(0, uN, 1024, [&](size_t uB, size_t uE) { fBatch(V{}, afX.data() + uB, afY.data() + uB, uE - uB, fPlanes(afOut, uB)); });
+					}));
+			}
+
+			double dMax = 0.;
+			size_t uMismatchN = 0;
+			for (unsigned uO(0); uO < uOutN; uO++)
+				for (size_t uI(0); uI < uN; uI++)
+				{
+					const float fA = afOut[uO * uN + uI], fR = afRef[uO * uN + uI];
+					if (fA != fR) uMismatchN++;
+					dMax = (fA == fA) ? (std::max)(dMax, (double)std::abs(fA - fR)) : 1e30;
+				}
+			if ((double)uMismatchN > 1e-5 * (double)(uN * uOutN)) uErrN++;
+			Trace("  %-10s %-14s %8.2f Mpoints/s core %8.2f Mpoints/s %u cores, mismatch %u max diff %.3g", atName, atKernel,
+				dMs > 0. ? (double)uN / (dMs * 1000.) : 0., dJobsMs > 0. ? (double)uN / (dJobsMs * 1000.) : 0., cJobs.Workers_N() + 1,
+				(unsigned)uMismatchN, dMax);
+		};
+
+		fKernel("fbm", 1, [](auto sTag, const float* pfX, const float* pfY, size_t uN, std::array<float*, 4> apf)
+			{ FbmBatch<decltype(sTag)>(pfX, pfY, uN, 1.f, apf[0]); });
+		fKernel("fbm_der", 3, [](auto sTag, const float* pfX, const float* pfY, size_t uN, std::array<float*, 4> apf)
+			{ FbmDerBatch<decltype(sTag)>(pfX, pfY, uN, 1.f, apf[0], apf[1], apf[2]); });
+		fKernel("fbm_normal", 4, [](auto sTag, const float* pfX, const float* pfY, size_t uN, std::array<float*, 4> apf)
+			{ FbmNormalBatch<decltype(sTag)>(pfX, pfY, uN, 1.f, apf[0], apf[1], apf[2], apf[3]); });
+		fKernel("fbm_normal_der", 4, [](auto sTag, const float* pfX, const float* pfY, size_t uN, std::array<float*, 4> apf)
+			{ FbmNormalDerBatch<decltype(sTag)>(pfX, pfY, uN, 1.f, apf[0], apf[1], apf[2], apf[3]); });
+		fKernel("noise_simplex", 1, [](auto sTag, const float* pfX, const float* pfY, size_t uN, std::array<float*, 4> apf)
+			{ FbmSimplexBatch<decltype(sTag)>(pfX, pfY, uN, apf[0]); });
+		fKernel("frac_simplex", 1, [](auto sTag, const float* pfX, const float* pfY, size_t uN, std::array<float*, 4> apf)
+			{ FbmFracSimplexBatch<decltype(sTag)>(pfX, pfY, uN, apf[0]); });
+		return uErrN;
+	}
+
+	/// <summary>wall time of a function call in milliseconds</summary>
+	template <typename F>
+	static double Measure(F&& fFunc)
+	{
+		auto cStart = std::chrono::steady_clock::now();
+		fFunc();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cStart).count();
+	}
+
+	/// <summary>task handler wrapper, execute on demand</summary>
+	class Taskhandler : protected App_Taskhandler
+	{
+	public:
+		explicit Taskhandler(
+			std::vector<std::vector<AppTask>>& aasTasks_Init,
+			std::vector<std::vector<AppTask>>& aasTasks_Runtime,
+			std::vector<std::vector<AppTask>>& aasTasks_Destroy
+		) : App_Taskhandler(aasTasks_Init, aasTasks_Runtime, aasTasks_Destroy) {}
+
+		void Execute() { Run(); }
+		unsigned Workers_N() const { return Jobs().Workers_N(); }
+		double CriticalPath_Ms() const { return App_Taskhandler::CriticalPath_Ms(RUNTIME); }
+		GameTimer::frame_stats Stats() const { return Timer().stats(); }
+	};
+
+	/// <summary>scripted controller for the culling path : thrust, turn, pitch sweep (+-54 degrees)</summary>
+	static bool CullScript(InputFrame& sFrame)
+	{
+		const float fT = (float)s_uScriptN++ / 60.f;
+		sFrame.nThumbLY = 32767;
+		sFrame.nThumbRX = 3277;
+		sFrame.nThumbRY = (int16_t)(std::sin(fT * .5f) * 19660.f);
+		return true;
+	}
+	static inline unsigned s_uScriptN = 0;
+
+	/// <summary>scene app on the OS backend, executes the CPU side of the demo update</summary>
+	class SceneApp : protected APP_Os
+	{
+	public:
+		explicit SceneApp(uint64_t uFrameN) : APP_Os(
+			m_aasTasks_Init = { { APP_Os::OsInit }, { SceneInit } },
+			m_aasTasks_Runtime = { {
+				{ APP_Os::OsUpdate, APP_RES_NONE, APP_RES_OSQUEUE, true },
+				{ SceneUpdate, APP_RES_NONE, APP_RES_SCENE },
+				{ APP_Os::OsFrame, APP_RES_NONE, APP_RES_OSQUEUE, true } } },
+			m_aasTasks_Destroy = { { APP_Os::OsPreRelease }, { APP_Os::OsRelease } })
+		{
+			FixedStep(1.f / 60.f, uFrameN);
+		}
+
+		void Execute() { Run(); }
+		double Throughput() const { return App_Taskhandler::Throughput(); }
+		GameTimer::frame_stats Stats() const { return Timer().stats(); }
+		using APP_Os::Input;
+
+		/// <summary>scripted controller : constant thrust, turn</summary>
+		static bool Script(InputFrame& sFrame)
+		{
+			sFrame.nThumbLX = 9830;
+			sFrame.nThumbLY = 32767;
+			sFrame.nThumbRX = 3277;
+			return true;
+		}
+
+		/// <summary>scene state (as App_D3D12::SceneData)</summary>
+		struct Scene
+		{
+			Camera sCam;
+			float2 sHexUV, sHexUVc, sHexXYc;
+			unsigned uInstN;
+			std::vector<float4> asTilePos, asTilePosUpdate;
+			HexTilesRecycler cTileRecycler;
+		};
+		static inline Scene s_sScene = {};
+		static inline unsigned s_uAmbitN = 0;
+		/// <summary>number of recycled tiles, hash of the camera trajectory</summary>
+		static inline uint64_t s_uMovedN = 0, s_uHash = 0;
+
+	private:
+		/// <summary>create the tile layout</summary>
+		FUNC_GAME_TASK(SceneInit)
+		{
+			s_sScene = {};
+			s_sScene.sCam.sPos = float3{ 0.f, 10.f, 0.f };
+			s_sScene.uInstN = HexTilesN(s_uAmbitN);
+			HexTilesLayout(s_sScene.asTilePos, s_sScene.uInstN, (s_sScene.uInstN + 255) & ~255, 1.f, *sData.pcJobs);
+			s_sScene.cTileRecycler.Init(s_sScene.asTilePos, s_sScene.sHexXYc, s_uAmbitN, s_sScene.uInstN);
+			return APP_FORWARD;
+		}
+		/// <summary>camera integration, hex center, tile recycling (see App_D3D12::UpdateConstants())</summary>
+		FUNC_GAME_TASK(SceneUpdate)
+		{
+			InputFrame sFrame = {};
+			if (!m_cInput.Next(sFrame, sData.fDelta)) return APP_QUIT;
+			CameraIntegrate(s_sScene.sCam, CameraInputFrom(sFrame), sFrame.fDelta, .1f, 4.f, .995f);
+			for (size_t uI(0); uI < sizeof(Camera); uI++)
+				s_uHash = (s_uHash ^ ((const uint8_t*)&s_sScene.sCam)[uI]) * 1099511628211ull;
+
+			float2 sXY = HexTilesCenter(s_sScene.sCam.sPos.x, s_sScene.sCam.sPos.z, s_sScene.sHexUV, s_sScene.sHexUVc);
+			s_sScene.asTilePosUpdate.clear();
+			s_uMovedN += s_sScene.cTileRecycler.Recycle(s_sScene.asTilePos, s_sScene.asTilePosUpdate, sXY);
+			s_sScene.sHexXYc = sXY;
+			return APP_FORWARD;
+		}
+		static inline std::vector<std::vector<AppTask>> m_aasTasks_Init = {}, m_aasTasks_Runtime = {}, m_aasTasks_Destroy = {};
+	};
+
+	/// <summary>synthetic independent task, busy for s_fWorkMs</summary>
+	FUNC_GAME_TASK(Workload)
+	{
+		auto cEnd = std::chrono::steady_clock::now() + std::chrono::duration<float, std::milli>(s_fWorkMs);
+		while (std::chrono::steady_clock::now() < cEnd) {}
+		return APP_FORWARD;
+	}
+	/// <summary>count frames, quit after s_uFrameN</summary>
+	FUNC_GAME_TASK(FrameCount)
+	{
+		return (++s_uFrameCnt >= s_uFrameN) ? APP_QUIT : APP_FORWARD;
+	}
+
+	/// <summary>synthetic frame task uT, logs start and end time, task 0 pauses and quits</summary>
+	template <unsigned uT>
+	FUNC_GAME_TASK(GraphTask)
+	{
+		const unsigned uF = (unsigned)sData.uFrame;
+		if (uF >= s_uGraphFrameMax) return APP_QUIT;
+		GraphLog& sLog = s_aasGraphLog[uF][uT];
+		sLog.uAllocN = s_uAllocN.load();
+		sLog.dStart = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_cGraphStart).count();
+		if (s_fGraphScale > 0.f)
+			std::this_thread::sleep_for(std::chrono::duration<float, std::milli>(s_afGraphMs[uT] * s_fGraphScale));
+		sLog.dEnd = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_cGraphStart).count();
+		sLog.bDone = true;
+
+		if (uT == 0)
+		{
+			if (uF + 1 >= s_uFrameN) return APP_QUIT;
+			if ((uF % s_uGraphPause) == (s_uGraphPause - 1)) return APP_PAUSE;
+		}
+		return APP_FORWARD;
+	}
+	/// <summary>index of a synthetic frame task</summary>
+	static unsigned TaskIndex(const AppTask& sTask)
+	{
+		const GAME_TASK apfTasks[] = { GraphTask<0>, GraphTask<1>, GraphTask<2>, GraphTask<3>, GraphTask<4>, GraphTask<5>, GraphTask<6> };
+		for (unsigned uI(0); uI < 7; uI++)
+			if (apfTasks[uI] == sTask.pfTask) return uI;
+		return 0;
+	}
+	/// <summary>synthetic frame task log entry</summary>
+	struct GraphLog { double dStart, dEnd; size_t uAllocN; bool bDone; };
+	static constexpr unsigned s_uGraphFrameMax = 256;
+	static constexpr unsigned s_uGraphPause = 8;
+	static inline std::array<std::array<GraphLog, 7>, s_uGraphFrameMax> s_aasGraphLog = {};
+	static inline const float s_afGraphMs[7] = { .5f, 2.f, .5f, 3.f, 1.f, 2.f, 1.5f };
+	static inline std::chrono::steady_clock::time_point s_cGraphStart;
+	static inline float s_fGraphScale = 1.f;
+
+	/// <summary>number of frames to be executed, frame counter</summary>
+	static inline unsigned s_uFrameN = 0, s_uFrameCnt = 0;
+	/// <summary>busy time of a synthetic task</summary>
+	static inline float s_fWorkMs = 0.f;
+};
+
+#endif // _APP_BENCHMARK
@@ -0,0 +1,180 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _APP_INPUT
+#define _APP_INPUT
+
+#include <stdio.h>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Controller state of one frame (XInput layout) and the frame delta,
+/// binary record of the input stream (16 bytes, little endian)
+/// </summary>
+struct InputFrame
+{
+	/// <summary>thumbsticks left x, y, right x, y (-32768..32767)</summary>
+	int16_t nThumbLX, nThumbLY, nThumbRX, nThumbRY;
+	/// <summary>triggers left, right (0..255)</summary>
+	uint8_t uTriggerL, uTriggerR;
+	/// <summary>buttons (XInput), INPUT_CONNECTED if a controller is connected</summary>
+	uint16_t uButtons;
+	/// <summary>frame delta in seconds</summary>
+	float fDelta;
+};
+static_assert(sizeof(InputFrame) == 16, "InputFrame : binary record size");
+
+/// <summary>connected flag, uses a button bit not assigned by XInput</summary>
+constexpr uint16_t INPUT_CONNECTED = 0x0400;
+
+/// <summary>
+/// Input layer : polls controller 0 (live), records the polled frames to a binary stream
+/// or replays a recorded stream in place of polling.
+/// Stream : "HXIN", uint32 version, uint32 record size, records (InputFrame).
+/// </summary>
+class App_Input
+{
+public:
+	/// <summary>poll function, returns false if no controller is connected</summary>
+	typedef bool(*INPUT_POLL)(InputFrame& sFrame);
+
+	enum struct Mode : unsigned
+	{
+		Live,
+		Record,
+		Replay
+	};
+
+	App_Input() {}
+	~App_Input() { Close(); }
+	App_Input(const App_Input&) = delete;
+	App_Input& operator=(const App_Input&) = delete;
+
+	/// <summary>record all following frames to a file</summary>
+	bool Record(const char* atPath)
+	{
+		Close();
+		if (!(m_pFile = Open(atPath, "wb"))) return false;
+		const uint32_t auHeader[3] = { s_uMagic, s_uVersion, (uint32_t)sizeof(InputFrame) };
+		if (fwrite(auHeader, sizeof(auHeader), 1, m_pFile) != 1) { Close(); return false; }
+		m_eMode = Mode::Record;
+		return true;
+	}
+	/// <summary>replay a recorded file (loaded completely) in place of polling</summary>
+	bool Replay(const char* atPath)
+	{
+		Close();
+		FILE* pFile = Open(atPath, "rb");
+		if (!pFile) return false;
+
+		// check header, read records
+		uint32_t auHeader[3] = {};
+		bool bOk = (fread(auHeader, sizeof(auHeader), 1, pFile) == 1) &&
+			(auHeader[0] == s_uMagic) && (auHeader[1] == s_uVersion) && (auHeader[2] == (uint32_t)sizeof(InputFrame));
+		if (bOk)
+		{
+			InputFrame sFrame = {};
+			while (fread(&sFrame, sizeof(InputFrame), 1, pFile) == 1)
+				m_asReplay.push_back(sFrame);
+		}
+		fclose(pFile);
+		if (!bOk) return false;
+
+		m_uReplayIx = 0;
+		m_eMode = Mode::Replay;
+		return true;
+	}
+	/// <summary>stop recording (flush) or replaying, back to live polling</summary>
+	void Close()
+	{
+		if (m_pFile) fclose(m_pFile);
+		m_pFile = nullptr;
+		m_asReplay.clear();
+		m_eMode = Mode::Live;
+	}
+	/// <summary>set the poll function (nullptr : controller 0)</summary>
+	void Source(INPUT_POLL pfPoll) { m_pfPoll = pfPoll; }
+
+	/// <summary>
+	/// Next input frame : replayed or polled (and recorded), fDelta is the frame delta
+	/// to be recorded. Returns false if the replay ended.
+	/// </summary>
+	bool Next(InputFrame& sFrame, float fDelta)
+	{
+		if (m_eMode == Mode::Replay)
+		{
+			if (m_uReplayIx >= m_asReplay.size()) return false;
+			sFrame = m_asReplay[m_uReplayIx++];
+			return true;
+		}
+
+		// poll
+		sFrame = {};
+		if ((m_pfPoll ? m_pfPoll : PollController)(sFrame))
+			sFrame.uButtons |= INPUT_CONNECTED;
+		else
+			sFrame = {};
+		sFrame.fDelta = fDelta;
+
+		// and record
+		if ((m_eMode == Mode::Record) && (fwrite(&sFrame, sizeof(InputFrame), 1, m_pFile) != 1))
+			Close();
+		return true;
+	}
+
+	/// <summary>current mode</summary>
+	Mode Mode_Current() const { return m_eMode; }
+	/// <summary>number of frames to be replayed</summary>
+	size_t Replay_N() const { return m_asReplay.size(); }
+
+	/// <summary>poll controller 0 (no controllers on POSIX)</summary>
+	static bool PollController(InputFrame& sFrame)
+	{
+#ifdef _WIN64
+		XINPUT_STATE sState = {};
+		if (XInputGetState(0, &sState) != ERROR_SUCCESS) return false;
+		sFrame.nThumbLX = sState.Gamepad.sThumbLX;
+		sFrame.nThumbLY = sState.Gamepad.sThumbLY;
+		sFrame.nThumbRX = sState.Gamepad.sThumbRX;
+		sFrame.nThumbRY = sState.Gamepad.sThumbRY;
+		sFrame.uTriggerL = sState.Gamepad.bLeftTrigger;
+		sFrame.uTriggerR = sState.Gamepad.bRightTrigger;
+		sFrame.uButtons = sState.Gamepad.wButtons;
+		return true;
+#else
+		(void)sFrame;
+		return false;
+#endif
+	}
+
+private:
+	/// <summary>open a file (fopen_s on Windows)</summary>
+	static FILE* Open(const char* atPath, const char* atMode)
+	{
+#ifdef _WIN64
+		FILE* pFile = nullptr;
+		return (fopen_s(&pFile, atPath, atMode) == 0) ? pFile : nullptr;
+#else
+		return fopen(atPath, atMode);
+#endif
+	}
+
+	/// <summary>stream magic "HXIN", version</summary>
+	static constexpr uint32_t s_uMagic = 0x4E495848;
+	static constexpr uint32_t s_uVersion = 1;
+
+	/// <summary>current mode</summary>
+	Mode m_eMode = Mode::Live;
+	/// <summary>record file</summary>
+	FILE* m_pFile = nullptr;
+	/// <summary>replay frames, next frame index</summary>
+	std::vector<InputFrame> m_asReplay;
+	size_t m_uReplayIx = 0;
+	/// <summary>poll function (nullptr : controller 0)</summary>
+	INPUT_POLL m_pfPoll = nullptr;
+};
+
+#endif // _APP_INPUT
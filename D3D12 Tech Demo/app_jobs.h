@@ -0,0 +1,252 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _APP_JOBS
+#define _APP_JOBS
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+
+/// <summary>
+/// Work stealing job system.
+/// Each thread owns a job deque, the owner pushes and pops at the back (LIFO),
+/// idle threads steal from the front (FIFO) of the other deques.
+/// A waiting thread executes pending jobs until its counter reaches zero.
+/// </summary>
+class App_Jobsystem
+{
+public:
+	/// <summary>job function, executes range [uBegin, uEnd) of the job context</summary>
+	typedef void(*JOB_FUNC)(void* pvCtx, size_t uBegin, size_t uEnd);
+
+	/// <summary>maximum number of queued jobs per thread (if full, jobs execute immediately)</summary>
+	static constexpr size_t uQueueSz = 1024;
+	/// <summary>maximum number of partial results of a parallel reduce</summary>
+	static constexpr size_t uReduceN = 64;
+
+	/// <summary>default number of workers : hardware threads - 1 (calling thread works too)</summary>
+	static unsigned Workers_Default() { return (std::max)(std::thread::hardware_concurrency(), 2u) - 1; }
+
+	/// <summary>create worker threads</summary>
+	/// <param name="uWorkerN">number of worker threads, 0 = all jobs execute on calling thread</param>
+	explicit App_Jobsystem(unsigned uWorkerN = Workers_Default())
+		: m_uQueueN(uWorkerN + 1)
+		, m_asQueues(new Queue[uWorkerN + 1])
+	{
+		// queue 0 is shared by all non-worker threads (main thread)
+		for (unsigned uI(1); uI <= uWorkerN; uI++)
+			m_acThreads.emplace_back(&App_Jobsystem::Work, this, uI);
+	}
+	/// <summary>quit and join worker threads</summary>
+	~App_Jobsystem()
+	{
+		{
+			std::lock_guard<std::mutex> cLock(m_cSleepMutex);
+			m_bQuit = true;
+		}
+		m_cWake.notify_all();
+		for (std::thread& cThread : m_acThreads)
+			cThread.join();
+	}
+	App_Jobsystem(const App_Jobsystem&) = delete;
+	App_Jobsystem& operator=(const App_Jobsystem&) = delete;
+
+	/// <summary>number of worker threads</summary>
+	unsigned Workers_N() const { return (unsigned)m_acThreads.size(); }
+
+	/// <summary>spawn a job to the queue of this thread, increments the pending counter</summary>
+	void Spawn(JOB_FUNC pfFunc, void* pvCtx, size_t uBegin, size_t uEnd, std::atomic<size_t>& uPending)
+	{
+		uPending.fetch_add(1, std::memory_order_relaxed);
+		const Job sJob = { pfFunc, pvCtx, uBegin, uEnd, &uPending };
+
+		// queue full ? execute right here
+		if (!Push(m_asQueues[Self()], sJob))
+		{
+			Execute(sJob);
+			return;
+		}
+
+		// wake a sleeping worker
+		m_uQueued.fetch_add(1, std::memory_order_release);
+		{ std::lock_guard<std::mutex> cLock(m_cSleepMutex); }
+		m_cWake.notify_one();
+	}
+
+	/// <summary>execute pending jobs until the counter is zero</summary>
+	void Wait(std::atomic<size_t>& uPending)
+	{
+		while (uPending.load(std::memory_order_acquire))
+		{
+			if (!TryExecute(Self()))
+				std::this_thread::yield();
+		}
+	}
+
+	/// <summary>execute one pending job (own or stolen), false if there is none</summary>
+	bool Help() { return TryExecute(Self()); }
+
+	/// <summary>
+	/// execute fBody(uB, uE) for all chunks [uB, uE) of [uBegin, uEnd), chunk size uGrain
+	/// first chunk executes on the calling thread, returns when all chunks are done
+	/// </summary>
+	template <typename F>
+	void ParallelFor(size_t uBegin, size_t uEnd, size_t uGrain, F&& fBody)
+	{
+		if (uEnd <= uBegin) return;
+		uGrain = (std::max)(uGrain, (size_t)1);
+
+		// single chunk or no workers ? execute
+		if (((uEnd - uBegin) <= uGrain) || !Workers_N())
+		{
+			fBody(uBegin, uEnd);
+			return;
+		}
+
+		// spawn all but the first chunk
+		std::atomic<size_t> uPending = 0;
+		for (size_t uB = uBegin + uGrain; uB < uEnd; uB += uGrain)
+			Spawn(&Invoke<F>, (void*)&fBody, uB, (std::min)(uB + uGrain, uEnd), uPending);
+
+		// execute first, then help out
+		fBody(uBegin, uBegin + uGrain);
+		Wait(uPending);
+	}
+
+	/// <summary>
+	/// reduce fBody(uB, uE) -> T of all chunks [uB, uE) of [uBegin, uEnd) by fReduce(T, T) -> T
+	/// the grain is raised to get at most uReduceN chunks, partial results are reduced
+	/// in chunk order (deterministic, fReduce needs to be associative only)
+	/// </summary>
+	template <typename T, typename F, typename R>
+	T ParallelReduce(size_t uBegin, size_t uEnd, size_t uGrain, T tInit, F&& fBody, R&& fReduce)
+	{
+		if (uEnd <= uBegin) return tInit;
+		const size_t uN = uEnd - uBegin;
+		uGrain = (std::max)({ uGrain, (uN + uReduceN - 1) / uReduceN, (size_t)1 });
+		const size_t uChunkN = (uN + uGrain - 1) / uGrain;
+
+		// partial results
+		std::array<T, uReduceN> atPartial;
+		ParallelFor(0, uChunkN, 1, [&](size_t uC0, size_t uC1)
+			{
+				for (size_t uC = uC0; uC < uC1; uC++)
+					atPartial[uC] = fBody(uBegin + uC * uGrain, (std::min)(uBegin + (uC + 1) * uGrain, uEnd));
+			});
+
+		// reduce in order
+		T tResult = tInit;
+		for (size_t uC(0); uC < uChunkN; uC++)
+			tResult = fReduce(tResult, atPartial[uC]);
+		return tResult;
+	}
+
+private:
+	/// <summary>queued job</summary>
+	struct Job
+	{
+		JOB_FUNC pfFunc;
+		void* pvCtx;
+		size_t uBegin, uEnd;
+		std::atomic<size_t>* puPending;
+	};
+	/// <summary>job deque (fixed size ring buffer, no allocations)</summary>
+	struct Queue
+	{
+		std::mutex cMutex;
+		std::array<Job, uQueueSz> asJobs = {};
+		size_t uHead = 0, uTail = 0;
+	};
+
+	/// <summary>call a functor job</summary>
+	template <typename F>
+	static void Invoke(void* pvCtx, size_t uBegin, size_t uEnd)
+	{
+		(*static_cast<std::remove_reference_t<F>*>(pvCtx))(uBegin, uEnd);
+	}
+
+	/// <summary>queue index of the calling thread</summary>
+	unsigned Self() const { return (s_pcOwner == this) ? s_uThreadI : 0; }
+
+	/// <summary>push to back</summary>
+	static bool Push(Queue& sQueue, const Job& sJob)
+	{
+		std::lock_guard<std::mutex> cLock(sQueue.cMutex);
+		if ((sQueue.uTail - sQueue.uHead) == uQueueSz) return false;
+		sQueue.asJobs[sQueue.uTail++ % uQueueSz] = sJob;
+		return true;
+	}
+	/// <summary>pop from back (owner) or front (thief)</summary>
+	static bool Pop(Queue& sQueue, Job& sJob, bool bBack)
+	{
+		std::lock_guard<std::mutex> cLock(sQueue.cMutex);
+		if (sQueue.uTail == sQueue.uHead) return false;
+		sJob = bBack ? sQueue.asJobs[--sQueue.uTail % uQueueSz] : sQueue.asJobs[sQueue.uHead++ % uQueueSz];
+		return true;
+	}
+
+	/// <summary>execute and count down</summary>
+	static void Execute(const Job& sJob)
+	{
+		sJob.pfFunc(sJob.pvCtx, sJob.uBegin, sJob.uEnd);
+		sJob.puPending->fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	/// <summary>pop own job or steal one, execute</summary>
+	bool TryExecute(unsigned uSelf)
+	{
+		Job sJob = {};
+		bool bFound = Pop(m_asQueues[uSelf], sJob, true);
+		for (unsigned uI(1); (uI < m_uQueueN) && !bFound; uI++)
+			bFound = Pop(m_asQueues[(uSelf + uI) % m_uQueueN], sJob, false);
+		if (!bFound) return false;
+
+		m_uQueued.fetch_sub(1, std::memory_order_relaxed);
+		Execute(sJob);
+		return true;
+	}
+
+	/// <summary>worker thread main loop</summary>
+	void Work(unsigned uSelf)
+	{
+		s_pcOwner = this;
+		s_uThreadI = uSelf;
+		for (;;)
+		{
+			if (TryExecute(uSelf)) continue;
+
+			// nothing to do, sleep
+			std::unique_lock<std::mutex> cLock(m_cSleepMutex);
+			m_cWake.wait(cLock, [this] { return m_bQuit || (m_uQueued.load(std::memory_order_acquire) > 0); });
+			if (m_bQuit) return;
+		}
+	}
+
+	/// <summary>number of queues (workers + 1)</summary>
+	const unsigned m_uQueueN;
+	/// <summary>job deques, one per thread</summary>
+	std::unique_ptr<Queue[]> m_asQueues;
+	/// <summary>number of queued jobs (all deques)</summary>
+	std::atomic<size_t> m_uQueued = 0;
+	/// <summary>sleep synchronization</summary>
+	std::mutex m_cSleepMutex;
+	std::condition_variable m_cWake;
+	/// <summary>true if the system is destroyed</summary>
+	bool m_bQuit = false;
+	/// <summary>worker threads</summary>
+	std::vector<std::thread> m_acThreads;
+	/// <summary>job system and queue index of the current thread</summary>
+	static inline thread_local const App_Jobsystem* s_pcOwner = nullptr;
+	static inline thread_local unsigned s_uThreadI = 0;
+};
+
+#endif // _APP_JOBS
@@ -0,0 +1,211 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _APP_TIMER
+#define _APP_TIMER
+
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <algorithm>
+
+#define GameTimer game_timer
+
+/// <summary>
+/// Game Time simple helper (portable, monotonic clock).
+/// Keeps the deltas of the last frames to provide frame time statistics.
+/// </summary>
+class game_timer
+{
+public:
+	/// <summary>number of frame deltas kept for the statistics</summary>
+	static constexpr unsigned uHistoryN = 1024;
+
+	/// <summary>frame time statistics in milliseconds (over the last uHistoryN frames)</summary>
+	struct frame_stats
+	{
+		/// <summary>number of frames evaluated</summary>
+		unsigned uFrameN;
+		float fMin, fMean, fP50, fP95, fP99, fMax;
+		/// <summary>frames slower than twice the median, frames slower than the hitch threshold (lifetime count : hitches())</summary>
+		unsigned uHitchRelN, uHitchN;
+	};
+
+	/// <summary>init the timer</summary>
+	game_timer()
+	{
+		// init timer
+		int64_t nCurrTime = now();
+
+		m_nBaseTime = nCurrTime;
+		m_nPrevTime = nCurrTime;
+		m_nCurrTime = nCurrTime;
+	}
+
+	/// <summary>current monotonic time in nanoseconds</summary>
+	static int64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/// <summary>Restart</summary>
+	void restart()
+	{
+		int64_t nStartTime = now();
+
+		if (m_bStopped)
+		{
+			m_nPausedTime += (nStartTime - m_nStopTime);
+
+			m_nPrevTime = nStartTime;
+			m_nStopTime = 0;
+			m_bStopped = false;
+		}
+	}
+	/// <summary>Pause</summary>
+	void pause()
+	{
+		if (!m_bStopped)
+		{
+			m_nStopTime = now();
+			m_bStopped = true;
+		}
+	}
+	/// <summary>New frame</summary>
+	void tick() { tick(now()); }
+	/// <summary>New frame at a given time (nanoseconds, monotonic)</summary>
+	void tick(int64_t nCurrTime)
+	{
+		// increment frame counter for this second
+		m_nFramesThisSecond++;
+
+		// stopped ?
+		if (m_bStopped)
+		{
+			m_dDelta = 0.0;
+			m_fDelta = 0.f;
+			m_fTotal = (float)(((m_nStopTime - m_nPausedTime) - m_nBaseTime) * s_dTicksInSeconds);
+			return;
+		}
+
+		// get counter
+		m_nCurrTime = nCurrTime;
+
+		// set total
+		m_fTotal = (float)(((m_nCurrTime - m_nPausedTime) - m_nBaseTime) * s_dTicksInSeconds);
+
+		// set delta
+		m_dDelta = (m_nCurrTime - m_nPrevTime) * s_dTicksInSeconds;
+
+		// set previous frame time
+		m_nPrevTime = m_nCurrTime;
+
+		// clamp positive
+		if (m_dDelta < 0.0)	m_dDelta = 0.0;
+		m_fDelta = (float)m_dDelta;
+
+		// keep delta, count hitches
+		m_afDeltaMs[m_uDeltaIx++ % uHistoryN] = (float)(m_dDelta * 1000.0);
+		if (m_dDelta * 1000.0 > (double)m_fHitchMs) m_uHitchN++;
+
+		// set fps if new second
+		if ((m_fTotal - m_fSecondsCounter) >= 1.0f)
+		{
+			// set total frames
+			m_nFramesTotal += m_nFramesThisSecond;
+
+			// calc fps
+			m_fFPSTotal = (float)m_nFramesThisSecond;
+			m_fFPS = m_nFramesThisSecond / (m_fTotal - m_fSecondsCounter);
+
+			// reset
+			m_nFramesThisSecond = 0;
+			m_fSecondsCounter += 1.0f;
+		}
+	}
+
+	/// <summary>frame time statistics of the last frames</summary>
+	frame_stats stats() const
+	{
+		frame_stats sStats = {};
+		sStats.uFrameN = (unsigned)(std::min)(m_uDeltaIx, (uint64_t)uHistoryN);
+		if (!sStats.uFrameN) return sStats;
+
+		// sort a copy
+		std::array<float, uHistoryN> afSorted;
+		std::copy(m_afDeltaMs.begin(), m_afDeltaMs.begin() + sStats.uFrameN, afSorted.begin());
+		std::sort(afSorted.begin(), afSorted.begin() + sStats.uFrameN);
+
+		// nearest rank percentile
+		auto fPercentile = [&](float fP) { return afSorted[(size_t)(std::min)((float)sStats.uFrameN - 1.f, std::ceil(fP * (float)sStats.uFrameN) - 1.f)]; };
+		double dSum = 0.;
+		for (unsigned uI(0); uI < sStats.uFrameN; uI++) dSum += (double)afSorted[uI];
+		sStats.fMin = afSorted[0];
+		sStats.fMax = afSorted[sStats.uFrameN - 1];
+		sStats.fMean = (float)(dSum / (double)sStats.uFrameN);
+		sStats.fP50 = fPercentile(.50f);
+		sStats.fP95 = fPercentile(.95f);
+		sStats.fP99 = fPercentile(.99f);
+		for (unsigned uI(0); uI < sStats.uFrameN; uI++)
+		{
+			if (afSorted[uI] > 2.f * sStats.fP50) sStats.uHitchRelN++;
+			if ((double)afSorted[uI] > (double)m_fHitchMs) sStats.uHitchN++;
+		}
+		return sStats;
+	}
+
+	/// <summary>Total time</summary>
+	float total() const { return m_fTotal; }
+	/// <summary>Timer delta in seconds</summary>
+	float delta() const { return m_fDelta; }
+	/// <summary>Frames per second, total</summary>
+	float fps_total() const { return m_fFPSTotal; }
+	/// <summary>Frames per second</summary>
+	float fps() const { return m_fFPS; }
+	/// <summary>Number of frames slower than the hitch threshold (since construction)</summary>
+	uint64_t hitches() const { return m_uHitchN; }
+	/// <summary>Set the hitch threshold in milliseconds</summary>
+	void hitch_threshold(float fMs) { m_fHitchMs = fMs; }
+
+private:
+	/// <summary>Ticks in seconds game timer helper (nanosecond ticks)</summary>
+	static constexpr double s_dTicksInSeconds = 1e-9;
+
+	/// <summary>Total time</summary>
+	float m_fTotal = 0.f;
+	/// <summary>Timer delta in seconds</summary>
+	float m_fDelta = 0.f;
+	/// <summary>Frames per second, total</summary>
+	float m_fFPSTotal = 0.f;
+	/// <summary>Frames per second</summary>
+	float m_fFPS = 0.f;
+	/// <summary>Timer delta (double)</summary>
+	double m_dDelta = 0.;
+	/// <summary>Timer base.</summary>
+	int64_t m_nBaseTime = 0;
+	/// <summary>Timer pause time helper.</summary>
+	int64_t m_nPausedTime = 0;
+	/// <summary>Timer stop time helper.</summary>
+	int64_t m_nStopTime = 0;
+	/// <summary>Timer previous time helper.</summary>
+	int64_t m_nPrevTime = 0;
+	/// <summary>Timer current time helper.</summary>
+	int64_t m_nCurrTime = 0;
+	/// <summary>True if the timer is stopped.</summary>
+	bool m_bStopped = false;
+	/// <summary>Frame counters for the fps</summary>
+	int m_nFramesThisSecond = 0, m_nFramesTotal = 0;
+	/// <summary>Start of the current fps second</summary>
+	float m_fSecondsCounter = 0.f;
+	/// <summary>Frame deltas in milliseconds (ring), number of deltas written</summary>
+	std::array<float, uHistoryN> m_afDeltaMs = {};
+	uint64_t m_uDeltaIx = 0;
+	/// <summary>Hitch threshold in milliseconds (default : 30 fps), number of hitches</summary>
+	float m_fHitchMs = 1000.f / 30.f;
+	uint64_t m_uHitchN = 0;
+};
+
+#endif // _APP_TIMER
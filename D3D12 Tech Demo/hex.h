@@ -0,0 +1,308 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _HEX
+#define _HEX
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <array>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HEX_SIMD_SSE2
+#endif
+
+// Hexagonal grid (pointy top, size = corner radius) :
+//
+// cube coordinates (q, r, s), q + r + s = 0
+// cartesian        (x, y) = size * (sqrt(3) * (q + r / 2), 3 / 2 * r)
+// legacy uv        (u, v) = (q + r, r) = (-s, r)   (HexTilesUV())
+//
+// neighbour i (0..5) is at angle 60 * i degrees, corner i at 60 * i - 30 degrees
+//
+// tile index (spiral)   0 = origin, ring r > 0 holds 6 * r tiles starting at index 1 + 3 * r * (r - 1),
+//                       index = 1 + 3 * r * (r - 1) + 6 * step + side,
+//                       cube  = r * direction(side) + step * direction(side + 2),   step < r
+
+/// <summary>integer cube coordinates (q + r + s = 0)</summary>
+struct HexCube
+{
+	int32_t nQ, nR, nS;
+};
+constexpr bool operator==(const HexCube& sA, const HexCube& sB) { return (sA.nQ == sB.nQ) && (sA.nR == sB.nR) && (sA.nS == sB.nS); }
+constexpr bool operator!=(const HexCube& sA, const HexCube& sB) { return !(sA == sB); }
+constexpr HexCube operator+(const HexCube& sA, const HexCube& sB) { return HexCube{ sA.nQ + sB.nQ, sA.nR + sB.nR, sA.nS + sB.nS }; }
+constexpr HexCube operator-(const HexCube& sA, const HexCube& sB) { return HexCube{ sA.nQ - sB.nQ, sA.nR - sB.nR, sA.nS - sB.nS }; }
+constexpr HexCube operator*(const HexCube& sA, int32_t nK) { return HexCube{ sA.nQ * nK, sA.nR * nK, sA.nS * nK }; }
+
+/// <summary>axial key of a hex (q high, r low word), hex of an axial key</summary>
+constexpr uint64_t HexCubeKey(const HexCube& sC) { return ((uint64_t)(uint32_t)sC.nQ << 32) | (uint32_t)sC.nR; }
+constexpr HexCube HexCubeFromKey(uint64_t uK)
+{
+	const int32_t nQ = (int32_t)(uint32_t)(uK >> 32), nR = (int32_t)(uint32_t)uK;
+	return HexCube{ nQ, nR, -nQ - nR };
+}
+/// <summary>hash of packed 64 bit keys (splitmix finalizer, packed keys have poor low bits for std::hash)</summary>
+struct HexKeyHash
+{
+	size_t operator()(uint64_t uK) const
+	{
+		uK = (uK ^ (uK >> 30)) * 0xbf58476d1ce4e5b9ull;
+		uK = (uK ^ (uK >> 27)) * 0x94d049bb133111ebull;
+		return (size_t)(uK ^ (uK >> 31));
+	}
+};
+
+/// <summary>fractional cube coordinates</summary>
+template <typename T>
+struct HexFrac
+{
+	T q, r, s;
+};
+
+/// <summary>2D vector (cartesian or uv)</summary>
+template <typename T>
+struct HexVec
+{
+	T x, y;
+};
+
+/// <summary>scalar constants</summary>
+template <typename T>
+struct HexConst
+{
+	static constexpr T fSqrt3 = T(1.7320508075688772935274463415059);
+	static constexpr T fSqrt3Inv = T(0.57735026918962576450914878050196);
+	static constexpr T fHalfSqrt3 = T(0.86602540378443864676372317075294);
+	static constexpr T fThird = T(1) / T(3);
+	static constexpr T fTwoThirds = T(2) / T(3);
+};
+
+/// <summary>cube directions to the 6 neighbours (index 0..5)</summary>
+constexpr std::array<HexCube, 6> s_asHexDirections = { {
+	{ 1, 0, -1 }, { 0, 1, -1 }, { -1, 1, 0 }, { -1, 0, 1 }, { 0, -1, 1 }, { 1, -1, 0 } } };
+
+/// <summary>vectors to the neighbours, size 1 (index 0..5)</summary>
+template <typename T>
+constexpr std::array<HexVec<T>, 6> s_asHexNext = { {
+	{ HexConst<T>::fSqrt3, T(0) }, { HexConst<T>::fHalfSqrt3, T(1.5) }, { -HexConst<T>::fHalfSqrt3, T(1.5) },
+	{ -HexConst<T>::fSqrt3, T(0) }, { -HexConst<T>::fHalfSqrt3, T(-1.5) }, { HexConst<T>::fHalfSqrt3, T(-1.5) } } };
+
+/// <summary>corner points, size 1 (index 0..5)</summary>
+template <typename T>
+constexpr std::array<HexVec<T>, 6> s_asHexCorner = { {
+	{ HexConst<T>::fHalfSqrt3, T(-.5) }, { HexConst<T>::fHalfSqrt3, T(.5) }, { T(0), T(1) },
+	{ -HexConst<T>::fHalfSqrt3, T(.5) }, { -HexConst<T>::fHalfSqrt3, T(-.5) }, { T(0), T(-1) } } };
+
+// float to hex conversions : exact (batch equals scalar) only if not contracted to FMA (-mfma, -mavx512f),
+// contraction is turned off for this block (GCC optimize, clang float_control, MSVC /fp:precise does not contract)
+#if defined(__clang__)
+#pragma float_control(push)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+/// <summary>floor (constexpr, |fV| < 2^31)</summary>
+template <typename T>
+constexpr T HexFloor(T fV)
+{
+	const int32_t nT = int32_t(fV);
+	return T(nT - int32_t(T(nT) > fV));
+}
+/// <summary>round half up (constexpr, equals the batch conversion)</summary>
+template <typename T>
+constexpr T HexRound(T fV) { return HexFloor(fV + T(.5)); }
+/// <summary>absolute value (constexpr)</summary>
+template <typename T>
+constexpr T HexAbs(T fV) { return (fV > -fV) ? fV : -fV; }
+
+/// <summary>fractional cube coordinates of a cartesian point</summary>
+template <typename T>
+constexpr HexFrac<T> HexCubeFromXY(T fX, T fY, T fSize = T(1))
+{
+	const T fSizeInv = T(1) / fSize;
+	const T fQ = (fX * HexConst<T>::fSqrt3Inv - fY * HexConst<T>::fThird) * fSizeInv;
+	const T fR = (fY * HexConst<T>::fTwoThirds) * fSizeInv;
+	return HexFrac<T>{ fQ, fR, -fQ - fR };
+}
+
+/// <summary>round fractional cube coordinates to the containing hex (component with the largest rounding error is reset)</summary>
+template <typename T>
+constexpr HexCube HexCubeRound(const HexFrac<T>& sF)
+{
+	const T fQ = HexRound(sF.q), fR = HexRound(sF.r), fS = HexRound(sF.s);
+	const T fDQ = HexAbs(fQ - sF.q), fDR = HexAbs(fR - sF.r), fDS = HexAbs(fS - sF.s);
+	const int32_t nQ = int32_t(fQ), nR = int32_t(fR), nS = int32_t(fS);
+
+	// select by mask (branch free, the reset component is unpredictable)
+	const int32_t nMaskQ = -(int32_t(fDQ > fDR) & int32_t(fDQ > fDS));
+	const int32_t nMaskR = ~nMaskQ & -int32_t(fDR > fDS);
+	const int32_t nMaskS = ~(nMaskQ | nMaskR);
+	return HexCube{ (nQ & ~nMaskQ) | ((-nR - nS) & nMaskQ), (nR & ~nMaskR) | ((-nQ - nS) & nMaskR), (nS & ~nMaskS) | ((-nQ - nR) & nMaskS) };
+}
+
+/// <summary>hex containing a cartesian point</summary>
+template <typename T>
+constexpr HexCube HexCubeAt(T fX, T fY, T fSize = T(1)) { return HexCubeRound(HexCubeFromXY(fX, fY, fSize)); }
+
+/// <summary>
+/// Hexes containing the points (pfX[i], pfY[i]), uN points.
+/// Batch conversion, 4 points per SSE2 instruction for float (same results as HexCubeAt(), not contracted).
+/// </summary>
+template <typename T>
+inline void HexCubeAtBatch(const T* pfX, const T* pfY, size_t uN, HexCube* psOut, T fSize = T(1))
+{
+	for (size_t uI(0); uI < uN; uI++)
+		psOut[uI] = HexCubeAt(pfX[uI], pfY[uI], fSize);
+}
+
+#ifdef HEX_SIMD_SSE2
+template <>
+inline void HexCubeAtBatch<float>(const float* pfX, const float* pfY, size_t uN, HexCube* psOut, float fSize)
+{
+	typedef HexConst<float> C;
+	const float fSizeInv = 1.f / fSize;
+	const __m128 sSizeInv = _mm_set1_ps(fSizeInv), sSqrt3Inv = _mm_set1_ps(C::fSqrt3Inv);
+	const __m128 sThird = _mm_set1_ps(C::fThird), sTwoThirds = _mm_set1_ps(C::fTwoThirds);
+	const __m128 sHalf = _mm_set1_ps(.5f), sOne = _mm_set1_ps(1.f);
+	const __m128 sAbs = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+	// floor(v + .5) by truncation, as HexRound()
+	auto fRound = [&](__m128 sV)
+	{
+		sV = _mm_add_ps(sV, sHalf);
+		__m128 sT = _mm_cvtepi32_ps(_mm_cvttps_epi32(sV));
+		return _mm_sub_ps(sT, _mm_and_ps(_mm_cmpgt_ps(sT, sV), sOne));
+	};
+	auto fSelect = [](__m128 sMask, __m128 sA, __m128 sB) { return _mm_or_ps(_mm_and_ps(sMask, sA), _mm_andnot_ps(sMask, sB)); };
+
+	size_t uI = 0;
+	for (; uI + 4 <= uN; uI += 4)
+	{
+		// fractional cube coords
+		const __m128 sX = _mm_loadu_ps(pfX + uI), sY = _mm_loadu_ps(pfY + uI);
+		const __m128 sQf = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(sX, sSqrt3Inv), _mm_mul_ps(sY, sThird)), sSizeInv);
+		const __m128 sRf = _mm_mul_ps(_mm_mul_ps(sY, sTwoThirds), sSizeInv);
+		const __m128 sSf = _mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), sQf), sRf);
+
+		// round, reset the component with the largest error
+		__m128 sQ = fRound(sQf), sR = fRound(sRf), sS = fRound(sSf);
+		const __m128 sDQ = _mm_and_ps(_mm_sub_ps(sQ, sQf), sAbs);
+		const __m128 sDR = _mm_and_ps(_mm_sub_ps(sR, sRf), sAbs);
+		const __m128 sDS = _mm_and_ps(_mm_sub_ps(sS, sSf), sAbs);
+		const __m128 sMaskQ = _mm_and_ps(_mm_cmpgt_ps(sDQ, sDR), _mm_cmpgt_ps(sDQ, sDS));
+		const __m128 sMaskR = _mm_andnot_ps(sMaskQ, _mm_cmpgt_ps(sDR, sDS));
+		const __m128 sMaskS = _mm_andnot_ps(_mm_or_ps(sMaskQ, sMaskR), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+		sQ = fSelect(sMaskQ, _mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), sR), sS), sQ);
+		sR = fSelect(sMaskR, _mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), sQ), sS), sR);
+		sS = fSelect(sMaskS, _mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), sQ), sR), sS);
+
+		// store (array of structures)
+		alignas(16) int32_t anQ[4], anR[4], anS[4];
+		_mm_store_si128((__m128i*)anQ, _mm_cvttps_epi32(sQ));
+		_mm_store_si128((__m128i*)anR, _mm_cvttps_epi32(sR));
+		_mm_store_si128((__m128i*)anS, _mm_cvttps_epi32(sS));
+		for (unsigned uJ(0); uJ < 4; uJ++)
+			psOut[uI + uJ] = HexCube{ anQ[uJ], anR[uJ], anS[uJ] };
+	}
+	for (; uI < uN; uI++)
+		psOut[uI] = HexCubeAt(pfX[uI], pfY[uI], fSize);
+}
+#endif
+
+#if defined(__clang__)
+#pragma float_control(pop)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+/// <summary>cartesian center of a hex</summary>
+template <typename T>
+constexpr HexVec<T> HexCubeToXY(const HexCube& sC, T fSize = T(1))
+{
+	return HexVec<T>{ fSize * HexConst<T>::fSqrt3 * (T(sC.nQ) + T(sC.nR) * T(.5)), fSize * T(1.5) * T(sC.nR) };
+}
+
+/// <summary>legacy uv coordinates of a hex</summary>
+template <typename T>
+constexpr HexVec<T> HexCubeToUV(const HexCube& sC) { return HexVec<T>{ T(-sC.nS), T(sC.nR) }; }
+
+/// <summary>number of steps to the origin</summary>
+constexpr int32_t HexCubeLength(const HexCube& sC)
+{
+	return ((sC.nQ < 0 ? -sC.nQ : sC.nQ) + (sC.nR < 0 ? -sC.nR : sC.nR) + (sC.nS < 0 ? -sC.nS : sC.nS)) / 2;
+}
+/// <summary>number of steps between two hexes</summary>
+constexpr int32_t HexCubeDistance(const HexCube& sA, const HexCube& sB) { return HexCubeLength(sA - sB); }
+/// <summary>neighbour hex (index 0..5)</summary>
+constexpr HexCube HexCubeNext(const HexCube& sC, unsigned uI) { return sC + s_asHexDirections[uI % 6]; }
+
+/// <summary>ring coordinates of a tile : ring (distance to origin), side 0..5, step 0..ring-1</summary>
+struct HexRing
+{
+	uint32_t uRing, uSide, uStep;
+};
+constexpr bool operator==(const HexRing& sA, const HexRing& sB) { return (sA.uRing == sB.uRing) && (sA.uSide == sB.uSide) && (sA.uStep == sB.uStep); }
+
+/// <summary>first tile index of a ring</summary>
+constexpr uint64_t HexRingFirst(uint32_t uRing) { return uRing ? 1 + 3 * (uint64_t)uRing * (uRing - 1) : 0; }
+
+/// <summary>ring coordinates of a tile index, O(1)</summary>
+inline HexRing HexRingFromIndex(uint64_t uIx)
+{
+	if (!uIx) return HexRing{ 0, 0, 0 };
+
+	// ring r holds indices [1 + 3r(r-1), 3r(r+1)], estimate by sqrt and correct rounding
+	const uint64_t uK = uIx - 1;
+	uint64_t uR = (uint64_t)((3.0 + std::sqrt(9.0 + 12.0 * (double)uK)) / 6.0);
+	if (3 * uR * (uR - 1) > uK) uR--;
+	if (3 * uR * (uR + 1) <= uK) uR++;
+
+	const uint64_t uJ = uK - 3 * uR * (uR - 1);
+	return HexRing{ (uint32_t)uR, (uint32_t)(uJ % 6), (uint32_t)(uJ / 6) };
+}
+/// <summary>tile index of ring coordinates</summary>
+constexpr uint64_t HexIndexFromRing(const HexRing& sR) { return sR.uRing ? HexRingFirst(sR.uRing) + 6 * (uint64_t)sR.uStep + sR.uSide : 0; }
+
+/// <summary>cube coordinates of ring coordinates</summary>
+constexpr HexCube HexCubeFromRing(const HexRing& sR)
+{
+	return s_asHexDirections[sR.uSide % 6] * (int32_t)sR.uRing + s_asHexDirections[(sR.uSide + 2) % 6] * (int32_t)sR.uStep;
+}
+/// <summary>ring coordinates of cube coordinates (the side is given by the coordinate at +-ring)</summary>
+constexpr HexRing HexRingFromCube(const HexCube& sC)
+{
+	const int32_t nR = HexCubeLength(sC);
+	const uint32_t uR = (uint32_t)nR;
+	if (!nR) return HexRing{ 0, 0, 0 };
+	if ((sC.nS == -nR) && (sC.nR < nR)) return HexRing{ uR, 0, (uint32_t)sC.nR };
+	if ((sC.nR == nR) && (sC.nQ > -nR)) return HexRing{ uR, 1, (uint32_t)-sC.nQ };
+	if ((sC.nQ == -nR) && (sC.nS < nR)) return HexRing{ uR, 2, (uint32_t)sC.nS };
+	if ((sC.nS == nR) && (sC.nR > -nR)) return HexRing{ uR, 3, (uint32_t)-sC.nR };
+	if ((sC.nR == -nR) && (sC.nQ < nR)) return HexRing{ uR, 4, (uint32_t)sC.nQ };
+	return HexRing{ uR, 5, (uint32_t)-sC.nS };
+}
+
+/// <summary>cube coordinates of a tile index, O(1)</summary>
+inline HexCube HexCubeFromIndex(uint64_t uIx) { return HexCubeFromRing(HexRingFromIndex(uIx)); }
+/// <summary>tile index of cube coordinates, O(1)</summary>
+constexpr uint64_t HexIndexFromCube(const HexCube& sC) { return HexIndexFromRing(HexRingFromCube(sC)); }
+
+/// <summary>
+/// Wrapped index (0 .. 3r^2 + 3r) of a hex, r = uRingN. Periodic on the lattice of hexagons with r rings,
+/// so the index is unique within any hexagon of r rings (at any center).
+/// </summary>
+constexpr uint32_t HexCubeWrap(const HexCube& sC, uint32_t uRingN)
+{
+	const int64_t nN = (int64_t)HexRingFirst(uRingN + 1);
+	const int64_t nIx = ((int64_t)sC.nQ + 3 * (int64_t)uRingN * uRingN * (int64_t)sC.nR) % nN;
+	return (uint32_t)((nIx < 0) ? nIx + nN : nIx);
+}
+
+#endif // _HEX
@@ -46,19 +46,49 @@
 // Rng - range
 // H - handle
 
+#ifdef APP_BENCHMARK
+#include "app_benchmark.h"
+#else
 #include "app_TechDemo.h"
+#endif
 
 #ifdef _WIN64
 /// <summary>
 /// Windows main entry point.
 /// </summary>
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine, int nCmdShow)
+#elif (defined(__unix__) || defined(__APPLE__)) && defined(APP_BENCHMARK)
+/// <summary>
+/// POSIX main entry point (headless, benchmark only).
+/// </summary>
+int main()
 #else 
 #error "OS not supported!"
 #endif
 {
-	// start Application
-	App_TechDemo cApp;
+#ifdef APP_BENCHMARK
+	// run benchmarks instead of the demo
+	App_Benchmark cBenchmark;
+#else
+	// "-record <file>", "-replay <file>" : record or replay controller input
+	for (const wchar_t* atOpt : { L"-record", L"-replay" })
+	{
+		if (const wchar_t* atArg = wcsstr(pCmdLine, atOpt))
+		{
+			char atPath[MAX_PATH] = {};
+			atArg += wcslen(atOpt) + wcsspn(atArg + wcslen(atOpt), L" ");
+			WideCharToMultiByte(CP_ACP, 0, atArg, (int)wcscspn(atArg, L" "), atPath, MAX_PATH - 1, nullptr, nullptr);
+			bool bOk = (wcscmp(atOpt, L"-record") == 0) ? APP_Os::Input().Record(atPath) : APP_Os::Input().Replay(atPath);
+			if (!bOk) OutputDebugStringA("main : input stream not available");
+		}
+	}
+
+	// start Application, "-fixed <frames>" : fixed timestep mode
+	uint64_t uFixedFrameN = 0;
+	if (const wchar_t* atFixed = wcsstr(pCmdLine, L"-fixed"))
+		uFixedFrameN = wcstoull(atFixed + 6, nullptr, 10);
+	App_TechDemo cApp(uFixedFrameN);
+#endif
 	return 0;
 }
 
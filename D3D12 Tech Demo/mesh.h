@@ -52,30 +52,52 @@ protected:
 	const UINT m_uStrideV;
 	/// <summary>buffer constants</summary>
 	UINT m_uSizeV, m_uSizeI, m_uIdcN, m_uInstN;
-	/// <summary>buffer index format constant</summary>
-	const DXGI_FORMAT m_eFormatI;
+	/// <summary>buffer index format (16 bit if all indices fit)</summary>
+	DXGI_FORMAT m_eFormatI;
 
 private:
 	/// <summary>name identifier</summary>
 	const std::string _atName;
 };
 
-/// <summary>simple mesh sample class</summary>
-class Mesh_PosCol : public Mesh<VertexPosCol>
+/// <summary>tile mesh class, vertex format by template parameter (see mesh_vertex.h)</summary>
+template <typename T>
+class Mesh_Vtc : public Mesh<T>
 {
+	using Mesh<T>::m_uSizeV;
+	using Mesh<T>::m_uSizeI;
+	using Mesh<T>::m_uIdcN;
+	using Mesh<T>::m_uInstN;
+	using Mesh<T>::m_eFormatI;
+	using Mesh<T>::m_psBlobVB;
+	using Mesh<T>::m_psBlobIB;
+	using Mesh<T>::m_pcBufferV;
+	using Mesh<T>::m_pcBufferI;
+	using Mesh<T>::m_pcBufferTmpV;
+	using Mesh<T>::m_pcBufferTmpI;
+
 public:
-	Mesh_PosCol(ID3D12Device* psDevice,
+	Mesh_Vtc(ID3D12Device* psDevice,
 		ID3D12GraphicsCommandList* psCmdList,
-		std::vector<VertexPosCol>& asVtc,
+		std::vector<T>& asVtc,
 		std::vector<std::uint32_t>& auIdc,
 		D3D12_CPU_DESCRIPTOR_HANDLE& sCpuUavHandle,
 		UINT uInstancesN = 1,
 		std::string atName = "mesh")
-		: Mesh<VertexPosCol>(psDevice, psCmdList, atName)
+		: Mesh<T>(psDevice, psCmdList, atName)
 	{
+		// 16 bit indices if the vertex range of a draw fits (indices are relative to the base vertex)
+		std::vector<std::uint16_t> auIdc16;
+		if (*std::max_element(auIdc.begin(), auIdc.end()) <= 0xffff)
+		{
+			m_eFormatI = DXGI_FORMAT_R16_UINT;
+			auIdc16.assign(auIdc.begin(), auIdc.end());
+		}
+		const void* pvIdc = auIdc16.size() ? (const void*)auIdc16.data() : (const void*)auIdc.data();
+
 		// align buffer size, fill up vertices
-		m_uSizeV = (UINT)asVtc.size() * sizeof(VertexPosCol);
-		m_uSizeI = (UINT)auIdc.size() * sizeof(std::uint32_t);
+		m_uSizeV = (UINT)asVtc.size() * sizeof(T);
+		m_uSizeI = (UINT)auIdc.size() * (auIdc16.size() ? sizeof(std::uint16_t) : sizeof(std::uint32_t));
 		m_uIdcN = (UINT)auIdc.size();
 		m_uInstN = uInstancesN;
 
@@ -83,23 +105,23 @@ public:
 		ThrowIfFailed(D3DCreateBlob(m_uSizeV, &m_psBlobVB));
 		CopyMemory(m_psBlobVB->GetBufferPointer(), asVtc.data(), m_uSizeV);
 		ThrowIfFailed(D3DCreateBlob(m_uSizeI, &m_psBlobIB));
-		CopyMemory(m_psBlobIB->GetBufferPointer(), auIdc.data(), m_uSizeI);
+		CopyMemory(m_psBlobIB->GetBufferPointer(), pvIdc, m_uSizeI);
 
-		Create(psDevice, psCmdList, asVtc, auIdc, sCpuUavHandle);
+		Create(psDevice, psCmdList, asVtc, pvIdc, sCpuUavHandle);
 	}
 
 private:
 	signed Create(ID3D12Device* psDevice,
 		ID3D12GraphicsCommandList* psCmdList,
-		std::vector<VertexPosCol>& asVtc,
-		std::vector<std::uint32_t>& auIdc,
+		std::vector<T>& asVtc,
+		const void* pvIdc,
 		D3D12_CPU_DESCRIPTOR_HANDLE& sCpuUavHandle)
 	{
 		// create buffers and upload buffers
 		ThrowIfFailed(Create(psDevice, psCmdList, asVtc.data(),
 			m_uSizeV, true, sCpuUavHandle, m_pcBufferV, m_pcBufferTmpV));
 		D3D12_CPU_DESCRIPTOR_HANDLE sNull = {};
-		ThrowIfFailed(Create(psDevice, psCmdList, auIdc.data(),
+		ThrowIfFailed(Create(psDevice, psCmdList, pvIdc,
 			m_uSizeI, false, sNull, m_pcBufferI, m_pcBufferTmpI));
 
 		return APP_FORWARD;
@@ -159,7 +181,7 @@ private:
 					D3D12_UAV_DIMENSION_BUFFER, {}
 				};
 
-				sUavDc.Buffer = { 0, (unsigned)Align8Bit((unsigned)uBytesize) / (unsigned)sizeof(VertexPosCol), sizeof(VertexPosCol), 0, D3D12_BUFFER_UAV_FLAG_NONE };
+				sUavDc.Buffer = { 0, (unsigned)Align8Bit((unsigned)uBytesize) / (unsigned)sizeof(T), sizeof(T), 0, D3D12_BUFFER_UAV_FLAG_NONE };
 				psDevice->CreateUnorderedAccessView(pcBuffer.Get(), nullptr, &sUavDc, sCpuUavHandle);
 			}
 		}
@@ -168,4 +190,7 @@ private:
 	}
 };
 
+/// <summary>simple mesh sample class</summary>
+typedef Mesh_Vtc<VertexPosCol> Mesh_PosCol;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,161 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _MESH_CACHE
+#define _MESH_CACHE
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+// Post-transform vertex cache :
+//
+// statistics     FIFO cache simulation, ACMR - cache misses per triangle (0.5 ideal for large
+//                regular grids, 3 worst), ATVR - cache misses per vertex (1 ideal)
+// optimizer      T. Forsyth, "Linear-Speed Vertex Cache Optimisation" (2006) : greedy, emits the
+//                triangle with the best vertex score, scores by position in a simulated LRU cache
+//                (32 entries) and by the number of triangles left per vertex
+
+/// <summary>vertex cache statistics</summary>
+struct MeshCacheStats
+{
+	/// <summary>average cache miss ratio (misses per triangle), average transform to vertex ratio</summary>
+	float fACMR, fATVR;
+};
+
+/// <summary>simulate a FIFO post-transform cache of uCacheN entries on a triangle list</summary>
+inline MeshCacheStats MeshCacheSimulate(const std::vector<uint32_t>& auIdc, size_t uVtcN, unsigned uCacheN)
+{
+	// time stamp of the vertex entering the cache (FIFO : entry is valid for uCacheN misses)
+	std::vector<uint64_t> auStamp(uVtcN, 0);
+	uint64_t uMissN = 0;
+	for (uint32_t uIx : auIdc)
+	{
+		if (auStamp[uIx] && (uMissN - auStamp[uIx] < uCacheN)) continue;
+		auStamp[uIx] = ++uMissN;
+	}
+
+	// ATVR over referenced vertices only
+	size_t uUsedN = 0;
+	for (uint64_t uS : auStamp) uUsedN += uS ? 1 : 0;
+	const size_t uTriN = auIdc.size() / 3;
+	return MeshCacheStats{ uTriN ? (float)uMissN / (float)uTriN : 0.f, uUsedN ? (float)uMissN / (float)uUsedN : 0.f };
+}
+
+/// <summary>
+/// Reorder the triangles of a triangle list for the post-transform vertex cache (Forsyth),
+/// triangle winding is kept, the input order is kept if not worse (FIFO 32 ACMR, small meshes).
+/// Runs in O(triangles * cache size).
+/// </summary>
+inline void MeshCacheOptimize(std::vector<uint32_t>& auIdc, size_t uVtcN)
+{
+	constexpr int32_t nCacheN = 32;
+	constexpr float fCacheDecay = 1.5f, fLastTriScore = .75f, fValenceScale = 2.f, fValenceDecay = -.5f;
+	const size_t uTriN = auIdc.size() / 3;
+	if (uTriN < 2) return;
+
+	// score tables by cache position, by triangles left
+	float afCacheScore[nCacheN], afValenceScore[64];
+	for (int32_t nP(0); nP < nCacheN; nP++)
+		afCacheScore[nP] = (nP < 3) ? fLastTriScore : std::pow(1.f - (float)(nP - 3) / (float)(nCacheN - 3), fCacheDecay);
+	for (int32_t nV(0); nV < 64; nV++)
+		afValenceScore[nV] = nV ? fValenceScale * std::pow((float)nV, fValenceDecay) : 0.f;
+
+	// vertex -> triangles adjacency (compressed)
+	std::vector<uint32_t> auTriStart(uVtcN + 1, 0), auVtxTri(auIdc.size());
+	for (uint32_t uIx : auIdc) auTriStart[uIx + 1]++;
+	for (size_t uV(0); uV < uVtcN; uV++) auTriStart[uV + 1] += auTriStart[uV];
+	std::vector<uint32_t> auFill(auTriStart.begin(), auTriStart.end() - 1);
+	for (size_t uI(0); uI < auIdc.size(); uI++) auVtxTri[auFill[auIdc[uI]]++] = (uint32_t)(uI / 3);
+
+	// per vertex : triangles left (active at the front of its adjacency), cache position, score
+	std::vector<uint32_t> auLeftN(uVtcN);
+	std::vector<int32_t> anCachePos(uVtcN, -1);
+	std::vector<float> afVtxScore(uVtcN), afTriScore(uTriN);
+	std::vector<uint8_t> abEmitted(uTriN, 0);
+	auto fScore = [&](uint32_t uV)
+	{
+		if (!auLeftN[uV]) return -1.f;
+		const float fCache = (anCachePos[uV] < 0) ? 0.f : afCacheScore[anCachePos[uV]];
+		return fCache + afValenceScore[(std::min)(auLeftN[uV], 63u)];
+	};
+	for (size_t uV(0); uV < uVtcN; uV++)
+	{
+		auLeftN[uV] = auTriStart[uV + 1] - auTriStart[uV];
+		afVtxScore[uV] = fScore((uint32_t)uV);
+	}
+	for (size_t uT(0); uT < uTriN; uT++)
+		afTriScore[uT] = afVtxScore[auIdc[uT * 3]] + afVtxScore[auIdc[uT * 3 + 1]] + afVtxScore[auIdc[uT * 3 + 2]];
+
+	// emit
+	std::vector<uint32_t> auOut;
+	auOut.reserve(auIdc.size());
+	uint32_t auCache[nCacheN + 3];
+	int32_t nCacheUsed = 0;
+	size_t uBestTri = 0, uScan = 0;
+	for (size_t uT(1); uT < uTriN; uT++)
+		if (afTriScore[uT] > afTriScore[uBestTri]) uBestTri = uT;
+	while (true)
+	{
+		// emit best triangle, remove it from the adjacency of its vertices
+		abEmitted[uBestTri] = 1;
+		const uint32_t* puTri = &auIdc[uBestTri * 3];
+		auOut.insert(auOut.end(), puTri, puTri + 3);
+		for (unsigned uJ(0); uJ < 3; uJ++)
+		{
+			const uint32_t uV = puTri[uJ];
+			uint32_t* puAdj = &auVtxTri[auTriStart[uV]];
+			const uint32_t uN = auLeftN[uV];
+			for (uint32_t uK(0); uK < uN; uK++)
+				if (puAdj[uK] == (uint32_t)uBestTri) { std::swap(puAdj[uK], puAdj[uN - 1]); break; }
+			auLeftN[uV]--;
+		}
+
+		// new cache : triangle vertices first, then the former entries
+		uint32_t auNew[nCacheN + 3];
+		int32_t nNewN = 0;
+		for (unsigned uJ(0); uJ < 3; uJ++) auNew[nNewN++] = puTri[uJ];
+		for (int32_t nC(0); nC < nCacheUsed; nC++)
+			if ((auCache[nC] != puTri[0]) && (auCache[nC] != puTri[1]) && (auCache[nC] != puTri[2]))
+				auNew[nNewN++] = auCache[nC];
+
+		// update vertex scores (dropped vertices leave the cache), triangle scores of the cached vertices
+		for (int32_t nC(0); nC < nNewN; nC++)
+		{
+			const uint32_t uV = auNew[nC];
+			anCachePos[uV] = (nC < nCacheN) ? nC : -1;
+			afVtxScore[uV] = fScore(uV);
+		}
+		float fBest = -1.f;
+		size_t uBest = uTriN;
+		for (int32_t nC(0); nC < nNewN; nC++)
+		{
+			const uint32_t uV = auNew[nC];
+			for (uint32_t uK(0); uK < auLeftN[uV]; uK++)
+			{
+				const uint32_t uT = auVtxTri[auTriStart[uV] + uK];
+				const uint32_t* puT = &auIdc[(size_t)uT * 3];
+				afTriScore[uT] = afVtxScore[puT[0]] + afVtxScore[puT[1]] + afVtxScore[puT[2]];
+				if (afTriScore[uT] > fBest) { fBest = afTriScore[uT]; uBest = uT; }
+			}
+		}
+		nCacheUsed = (std::min)(nNewN, nCacheN);
+		for (int32_t nC(0); nC < nCacheUsed; nC++) auCache[nC] = auNew[nC];
+
+		// no triangle at the cache ? next not emitted triangle in order (scan is linear over the run)
+		if (uBest == uTriN)
+		{
+			while ((uScan < uTriN) && abEmitted[uScan]) uScan++;
+			if (uScan == uTriN) break;
+			uBest = uScan;
+		}
+		uBestTri = uBest;
+	}
+	if (MeshCacheSimulate(auOut, uVtcN, 32).fACMR < MeshCacheSimulate(auIdc, uVtcN, 32).fACMR)
+		auIdc.swap(auOut);
+}
+
+#endif // _MESH_CACHE
@@ -0,0 +1,78 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _MESH_VERTEX
+#define _MESH_VERTEX
+
+#include "app.h"
+#include <cmath>
+#include <cstdint>
+
+// Tile vertex formats (tile local position, corner radius 1) :
+//
+// float          position xyz (y skirt depth, -1 skirt vertex, 0 else), color xyzw = local xz, distance
+//                to the tile center, normalized hex distance (28 bytes, VertexPosCol)
+// packed         position xz 16 bit snorm, attribute word : normalized hex distance 16 bit unorm,
+//                skirt 16 bit unorm (8 bytes), color is derived in the vertex shader. Tile local only,
+//                the replicated tiles (world positions written by compute shader) need float
+//
+// A negative normalized distance (HexMeshTile() skirt vertices) encodes a skirt vertex on the rim
+// (distance 1), the vertex shader lowers it by the skirt depth below the terrain.
+
+/// <summary>packed tile vertex (R16G16_SNORM position xz, R16G16_UNORM attributes)</summary>
+struct VertexPacked
+{
+	int16_t anPosL[2];
+	uint16_t auAttr[2];
+};
+static_assert(sizeof(VertexPacked) == 8, "VertexPacked : 8 bytes");
+
+/// <summary>
+/// Vertex codec : encode a tile vertex from its local position xz and normalized hex distance,
+/// decode to position (y - skirt depth) and color (as the vertex shader sees it). Float vertices
+/// (any type with sPos xyz, sColor xyzw as VertexPosCol).
+/// </summary>
+template <typename T>
+struct VertexCodec
+{
+	static constexpr bool bPacked = false;
+
+	static T Encode(float fX, float fZ, float fDistN)
+	{
+		const bool bSkirt = fDistN < 0.f;
+		T sV = {};
+		sV.sPos.x = fX; sV.sPos.y = bSkirt ? -1.f : 0.f; sV.sPos.z = fZ;
+		sV.sColor.x = fX; sV.sColor.y = fZ; sV.sColor.z = std::sqrt(fX * fX + fZ * fZ); sV.sColor.w = bSkirt ? 1.f : fDistN;
+		return sV;
+	}
+	static void Decode(const T& sV, float3& sPos, float4& sCol)
+	{
+		sPos = float3{ sV.sPos.x, sV.sPos.y, sV.sPos.z };
+		sCol = float4{ sV.sColor.x, sV.sColor.y, sV.sColor.z, sV.sColor.w };
+	}
+};
+
+/// <summary>packed vertex codec, snorm/unorm conversion as D3D (round to nearest, -1 = -32767)</summary>
+template <>
+struct VertexCodec<VertexPacked>
+{
+	static constexpr bool bPacked = true;
+
+	static VertexPacked Encode(float fX, float fZ, float fDistN)
+	{
+		auto fSnorm = [](float fV) { return (int16_t)std::lround((double)(std::fmin)((std::fmax)(fV, -1.f), 1.f) * 32767.); };
+		auto fUnorm = [](float fV) { return (uint16_t)std::lround((double)(std::fmin)((std::fmax)(fV, 0.f), 1.f) * 65535.); };
+		const bool bSkirt = fDistN < 0.f;
+		return VertexPacked{ { fSnorm(fX), fSnorm(fZ) }, { fUnorm(bSkirt ? 1.f : fDistN), fUnorm(bSkirt ? 1.f : 0.f) } };
+	}
+	static void Decode(const VertexPacked& sV, float3& sPos, float4& sCol)
+	{
+		const float fX = (std::fmax)((float)sV.anPosL[0] / 32767.f, -1.f), fZ = (std::fmax)((float)sV.anPosL[1] / 32767.f, -1.f);
+		sPos = float3{ fX, -(float)sV.auAttr[1] / 65535.f, fZ };
+		sCol = float4{ fX, fZ, std::sqrt(fX * fX + fZ * fZ), (float)sV.auAttr[0] / 65535.f };
+	}
+};
+
+#endif // _MESH_VERTEX
@@ -19,6 +19,8 @@
 #include <DirectXColors.h>
 #include <DirectXCollision.h>
 #include "d3dx12.h"
+#include "hex.h"
+#include "mesh_vertex.h"
 #pragma comment(lib,"d3dcompiler.lib")
 #pragma comment(lib, "D3D12.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -26,38 +28,6 @@
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 
-/// <summary>provide one of 6 hexagonal corner points</summary>
-inline XMFLOAT2 HexCorner(float fSize, uint uI)
-{
-	float fAngleDeg = 60.f * (float)(uI % 6) - 30.f;
-	float fAngleRad = (XM_PI / 180.f) * fAngleDeg;
-	return XMFLOAT2{ fSize * cos(fAngleRad), fSize * sin(fAngleRad) };
-}
-
-/// <summary>provide vector to neighbour field (index 0..5)</summary>
-inline XMFLOAT2 HexNext(float fSize, uint uI)
-{
-	const float fMinW = sqrt(fSize * fSize - (fSize * .5f * fSize * .5f)) * 2.f;
-	float fAngleDeg = 60.f * (float)(uI % 6);
-	float fAngleRad = (XM_PI / 180.f) * fAngleDeg;
-	return XMFLOAT2{ fMinW * cos(fAngleRad), fMinW * sin(fAngleRad) };
-}
-
-/// <summary>Cartesian to hex coordinates</summary>
-inline XMFLOAT2 HexUV(float fX, float fY)
-{
-	// hex coords       (u, v) = (          .5 * x + .5 * y,        y ) 
-	// hex coord scaled (u, v) = ((sqrt(3.f) * x + y) / 3.f, y / 1.5f )
-	return XMFLOAT2{ (sqrt(3.f) * fX + fY) / 3.f, fY / 1.5f };
-}
-
-/// <summary>Hex to cartesian coordinates</summary>
-inline XMFLOAT2 HexXY(float fU, float fV)
-{
-	// get cartesian coords
-	return XMFLOAT2{ (fU * 3.f - fV * 1.5f) / sqrt(3.f), fV * 1.5f };
-}
-
 /// <summary>Simple Sample vertex</summary>
 struct VertexPosCol
 {
@@ -65,6 +35,23 @@ struct VertexPosCol
 	XMFLOAT4 sColor;
 };
 
+/// <summary>input layout of a vertex format (see mesh_vertex.h)</summary>
+template <typename T> std::vector<D3D12_INPUT_ELEMENT_DESC> VertexLayout();
+template <> inline std::vector<D3D12_INPUT_ELEMENT_DESC> VertexLayout<VertexPosCol>()
+{
+	return {
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+	};
+}
+template <> inline std::vector<D3D12_INPUT_ELEMENT_DESC> VertexLayout<VertexPacked>()
+{
+	return {
+		{ "POSITION", 0, DXGI_FORMAT_R16G16_SNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "COLOR", 0, DXGI_FORMAT_R16G16_UNORM, 0, 4, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+	};
+}
+
 /// <summary>hlsl attribute structure</summary>
 struct PosNorm
 {
@@ -107,7 +94,7 @@ struct ConstantsScene
 		0.0f, 1.0f, 0.0f, 0.0f,
 		0.0f, 0.0f, 1.0f, 0.0f,
 		0.0f, 0.0f, 0.0f, 1.0f);
-	/// hex data (x - number of vertices per hex tile, xyz reserved)
+	/// hex data (x - number of vertices per hex tile, y - tiles instanced (1) or replicated (0), z - vertices packed (1), w - terrain by cpu (1))
 	XMUINT4 sHexData;
 };
 
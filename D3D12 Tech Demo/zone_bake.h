@@ -0,0 +1,507 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _ZONE_BAKE
+#define _ZONE_BAKE
+
+#include "zone_fbm.h"
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#ifndef _WIN64
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Disk baked terrain pyramid for the far field :
+//
+// file           header and tile index (first 64 KiB blocks), then the tiles, each 64 KiB aligned
+//                (view granularity on Windows, page multiple on POSIX), so every tile maps on its own
+// tile           128 x 128 texels over 127 cells, edge texels shared with the neighbour tiles (same
+//                global texel position), so bilinear lookups never leave a tile
+// texel          height (scaled), normal xz (snorm16, y = -sqrt(1 - x^2 - z^2), fbm_normal_der() convention)
+// levels         level l : texel size d * 2^l, ceil(n / 2^l) tiles per side, level 0 point sampled, levels
+//                above tent filtered over the texel footprint (3 x 3 fbm_der taps at half texel, weights
+//                1/4 1/2 1/4, derivatives filtered alike)
+// baking         tiles in parallel on the job workers (fbm_der batches), written through a writable
+//                mapping, flushed, then marked in the index : an interrupted bake resumes with the tiles
+//                not marked (same file, same description)
+// paging         Page() maps the baked tiles around the camera (square of half size r * 2^l per level,
+//                read only views) and unmaps the others, Sample() reads the mapped texels (zero copy)
+
+/// <summary>texels per tile side, file alignment of the tiles</summary>
+constexpr uint32_t HEX_BAKE_TILE_S = 128;
+constexpr uint64_t HEX_BAKE_ALIGN = 65536;
+/// <summary>file format version</summary>
+constexpr uint32_t HEX_BAKE_VERSION = 1;
+
+/// <summary>baked texel : height (scaled), normal xz (snorm16)</summary>
+struct HexBakeTexel
+{
+	float fHeight;
+	int16_t nNx, nNz;
+};
+
+/// <summary>pyramid description</summary>
+struct HexBakeDesc
+{
+	/// <summary>world xz of texel (0, 0), level 0 texel size</summary>
+	float fOriginX, fOriginY, fTexel;
+	/// <summary>level 0 tiles per side, number of levels</summary>
+	uint32_t uTilesX, uTilesY, uLevelN;
+	/// <summary>terrain : fbm scale, height scale, Hurst exponent (as HexTileTerrain)</summary>
+	float fFbmScale, fHeightScale, fH;
+};
+
+/// <summary>file header (offset 0), followed by the tile index</summary>
+struct HexBakeHeader
+{
+	char acMagic[8];
+	uint32_t uVersion, uTileS, uHash, uOctaves;
+	HexBakeDesc sDesc;
+	uint32_t uTileN;
+	uint64_t uDataOffset, uFileSz;
+};
+
+/// <summary>tile index entry : file offset, level, baked flag</summary>
+struct HexBakeIndex
+{
+	uint64_t uOffset;
+	uint32_t uLevel, uBaked;
+};
+
+/// <summary>
+/// Memory mapped file : views at aligned offsets (HEX_BAKE_ALIGN), read only or writable.
+/// </summary>
+class HexBakeMapping
+{
+public:
+	HexBakeMapping() = default;
+	HexBakeMapping(const HexBakeMapping&) = delete;
+	HexBakeMapping& operator=(const HexBakeMapping&) = delete;
+	~HexBakeMapping() { Close(); }
+
+	/// <summary>open a file, bWrite : create if missing and resize to uSz (if nonzero)</summary>
+	bool Open(const char* atPath, bool bWrite, uint64_t uSz = 0)
+	{
+		Close();
+		m_bWrite = bWrite;
+#ifdef _WIN64
+		m_pFile = CreateFileA(atPath, GENERIC_READ | (bWrite ? GENERIC_WRITE : 0), FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+			bWrite ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_pFile == INVALID_HANDLE_VALUE) return false;
+		LARGE_INTEGER sSz = {};
+		if (!GetFileSizeEx(m_pFile, &sSz)) { Close(); return false; }
+		if (bWrite && uSz && ((uint64_t)sSz.QuadPart != uSz))
+		{
+			// resize (fails while the file is mapped elsewhere)
+			sSz.QuadPart = (LONGLONG)uSz;
+			if (!SetFilePointerEx(m_pFile, sSz, nullptr, FILE_BEGIN) || !SetEndOfFile(m_pFile)) { Close(); return false; }
+		}
+		if (!sSz.QuadPart) { Close(); return false; }
+		m_uSz = (uint64_t)sSz.QuadPart;
+		m_pMapping = CreateFileMappingA(m_pFile, nullptr, bWrite ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+		if (!m_pMapping) { Close(); return false; }
+#else
+		m_nFd = open(atPath, bWrite ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+		if (m_nFd < 0) return false;
+		if (bWrite && uSz && (ftruncate(m_nFd, (off_t)uSz) != 0)) { Close(); return false; }
+		struct stat sStat;
+		if ((fstat(m_nFd, &sStat) != 0) || !sStat.st_size) { Close(); return false; }
+		m_uSz = (uint64_t)sStat.st_size;
+#endif
+		return true;
+	}
+
+	/// <summary>map uSz bytes at uOffset (aligned), nullptr on failure</summary>
+	uint8_t* Map(uint64_t uOffset, uint64_t uSz) const
+	{
+		if (!m_uSz || (uOffset + uSz > m_uSz)) return nullptr;
+#ifdef _WIN64
+		return (uint8_t*)MapViewOfFile(m_pMapping, m_bWrite ? FILE_MAP_WRITE : FILE_MAP_READ, (DWORD)(uOffset >> 32), (DWORD)uOffset, (SIZE_T)uSz);
+#else
+		void* pV = mmap(nullptr, (size_t)uSz, PROT_READ | (m_bWrite ? PROT_WRITE : 0), MAP_SHARED, m_nFd, (off_t)uOffset);
+		return (pV == MAP_FAILED) ? nullptr : (uint8_t*)pV;
+#endif
+	}
+
+	/// <summary>unmap a view of uSz bytes</summary>
+	static void Unmap(const void* pV, uint64_t uSz)
+	{
+#ifdef _WIN64
+		(void)uSz;
+		UnmapViewOfFile(pV);
+#else
+		munmap((void*)pV, (size_t)uSz);
+#endif
+	}
+
+	/// <summary>write the mapped bytes through to the file, Sync() : to the disk</summary>
+	bool Flush(void* pV, uint64_t uSz) const
+	{
+#ifdef _WIN64
+		return FlushViewOfFile(pV, (SIZE_T)uSz) != FALSE;
+#else
+		return msync(pV, (size_t)uSz, MS_SYNC) == 0;
+#endif
+	}
+	bool Sync() const
+	{
+#ifdef _WIN64
+		return FlushFileBuffers(m_pFile) != FALSE;
+#else
+		return fsync(m_nFd) == 0;
+#endif
+	}
+
+	/// <summary>close mapping and file (views stay valid until unmapped)</summary>
+	void Close()
+	{
+#ifdef _WIN64
+		if (m_pMapping) CloseHandle(m_pMapping);
+		if (m_pFile != INVALID_HANDLE_VALUE) CloseHandle(m_pFile);
+		m_pMapping = nullptr;
+		m_pFile = INVALID_HANDLE_VALUE;
+#else
+		if (m_nFd >= 0) close(m_nFd);
+		m_nFd = -1;
+#endif
+		m_uSz = 0;
+	}
+
+	/// <summary>file size</summary>
+	uint64_t Size() const { return m_uSz; }
+
+private:
+#ifdef _WIN64
+	HANDLE m_pFile = INVALID_HANDLE_VALUE, m_pMapping = nullptr;
+#else
+	int m_nFd = -1;
+#endif
+	bool m_bWrite = false;
+	uint64_t m_uSz = 0;
+};
+
+/// <summary>
+/// Baked terrain pyramid : Create() and Bake() write the file (resumable), Open(), Page() and Sample()
+/// read it (tiles around the camera mapped, zero copy). Same terrain as HexTileTerrain.
+/// </summary>
+class HexBakePyramid
+{
+public:
+	HexBakePyramid() = default;
+	HexBakePyramid(const HexBakePyramid&) = delete;
+	HexBakePyramid& operator=(const HexBakePyramid&) = delete;
+	~HexBakePyramid() { Close(); }
+
+	/// <summary>create the file for baking, an existing file of the same description resumes</summary>
+	signed Create(const char* atPath, const HexBakeDesc& sDesc)
+	{
+		Close();
+		Layout(sDesc);
+
+		// same header : keep index and baked tiles
+		bool bResume = false;
+		{
+			HexBakeMapping cOld;
+			if (cOld.Open(atPath, false) && (cOld.Size() == m_sHeader.uFileSz))
+				if (const uint8_t* pOld = cOld.Map(0, m_sHeader.uDataOffset))
+				{
+					bResume = !std::memcmp(pOld, &m_sHeader, sizeof(HexBakeHeader));
+					HexBakeMapping::Unmap(pOld, m_sHeader.uDataOffset);
+				}
+		}
+
+		if (!m_cFile.Open(atPath, true, m_sHeader.uFileSz)) return APP_ERROR;
+		m_pWrite = m_cFile.Map(0, m_sHeader.uFileSz);
+		if (!m_pWrite) { Close(); return APP_ERROR; }
+		if (!bResume)
+		{
+			// header, index : tiles level by level at aligned offsets, none baked
+			std::memset(m_pWrite, 0, (size_t)m_sHeader.uDataOffset);
+			std::memcpy(m_pWrite, &m_sHeader, sizeof(HexBakeHeader));
+			HexBakeIndex* psIndex = Index();
+			for (uint32_t uI(0); uI < m_sHeader.uTileN; uI++)
+				psIndex[uI] = HexBakeIndex{ m_sHeader.uDataOffset + (uint64_t)uI * s_uTileSz, LevelOf(uI), 0 };
+			m_cFile.Flush(m_pWrite, m_sHeader.uDataOffset);
+			m_cFile.Sync();
+		}
+		return APP_FORWARD;
+	}
+
+	/// <summary>
+	/// bake up to uTileMax of the tiles not baked yet, parallel in batches (baked, flushed, marked),
+	/// returns the number of tiles left
+	/// </summary>
+	unsigned Bake(App_Jobsystem& cJobs, unsigned uTileMax = ~0u)
+	{
+		if (!m_pWrite) return 0;
+		HexBakeIndex* psIndex = Index();
+		std::vector<uint32_t> auTodo;
+		for (uint32_t uI(0); uI < m_sHeader.uTileN; uI++)
+			if (!psIndex[uI].uBaked) auTodo.push_back(uI);
+		const size_t uN = (std::min)((size_t)uTileMax, auTodo.size());
+
+		const size_t uBatchN = (size_t)(cJobs.Workers_N() + 1) * 4;
+		for (size_t uB(0); uB < uN; uB += uBatchN)
+		{
+			const size_t uE = (std::min)(uB + uBatchN, uN);
+			cJobs.ParallelFor(uB, uE, 1, [&](size_t uT0, size_t uT1)
+				{
+					for (size_t uT = uT0; uT < uT1; uT++)
+						BakeTile(auTodo[uT], (HexBakeTexel*)(m_pWrite + psIndex[auTodo[uT]].uOffset));
+				});
+			for (size_t uT = uB; uT < uE; uT++) m_cFile.Flush(m_pWrite + psIndex[auTodo[uT]].uOffset, s_uTileSz);
+			m_cFile.Sync();
+			for (size_t uT = uB; uT < uE; uT++) psIndex[auTodo[uT]].uBaked = 1;
+			m_cFile.Flush(m_pWrite, m_sHeader.uDataOffset);
+			m_cFile.Sync();
+		}
+		return (unsigned)(auTodo.size() - uN);
+	}
+
+	/// <summary>open a baked file for sampling</summary>
+	signed Open(const char* atPath)
+	{
+		Close();
+		if (!m_cFile.Open(atPath, false)) return APP_ERROR;
+		const uint8_t* pHead = m_cFile.Map(0, HEX_BAKE_ALIGN);
+		if (!pHead) { Close(); return APP_ERROR; }
+		HexBakeHeader sHeader;
+		std::memcpy(&sHeader, pHead, sizeof(HexBakeHeader));
+		HexBakeMapping::Unmap(pHead, HEX_BAKE_ALIGN);
+
+		// same layout as this build would create
+		Layout(sHeader.sDesc);
+		if (std::memcmp(&sHeader, &m_sHeader, sizeof(HexBakeHeader)) || (m_cFile.Size() != m_sHeader.uFileSz)) { Close(); return APP_ERROR; }
+		m_pIndexView = m_cFile.Map(0, m_sHeader.uDataOffset);
+		if (!m_pIndexView) { Close(); return APP_ERROR; }
+		m_apTile.assign(m_sHeader.uTileN, nullptr);
+		m_auMapped.clear();
+		return APP_FORWARD;
+	}
+
+	/// <summary>
+	/// map the baked tiles within a square of half size fRadius * 2^l around xz at each level l,
+	/// unmap the others, returns the number of mapped tiles
+	/// </summary>
+	unsigned Page(float fX, float fY, float fRadius)
+	{
+		if (!m_pIndexView) return 0;
+		const HexBakeDesc& sD = m_sHeader.sDesc;
+		const HexBakeIndex* psIndex = Index();
+		m_abWanted.assign(m_sHeader.uTileN, 0);
+		for (uint32_t uL(0); uL < sD.uLevelN; uL++)
+		{
+			const float fSpan = TileSpan(uL), fR = fRadius * (float)(1u << uL);
+			const int32_t nNx = (int32_t)Tiles_X(uL), nNy = (int32_t)Tiles_Y(uL);
+			const int32_t nX0 = (std::max)((int32_t)std::floor((fX - fR - sD.fOriginX) / fSpan), 0);
+			const int32_t nX1 = (std::min)((int32_t)std::floor((fX + fR - sD.fOriginX) / fSpan), nNx - 1);
+			const int32_t nY0 = (std::max)((int32_t)std::floor((fY - fR - sD.fOriginY) / fSpan), 0);
+			const int32_t nY1 = (std::min)((int32_t)std::floor((fY + fR - sD.fOriginY) / fSpan), nNy - 1);
+			for (int32_t nY = nY0; nY <= nY1; nY++)
+				for (int32_t nX = nX0; nX <= nX1; nX++)
+					m_abWanted[m_auLevelFirst[uL] + (uint32_t)nY * (uint32_t)nNx + (uint32_t)nX] = 1;
+		}
+
+		// unmap, map
+		size_t uKeep = 0;
+		for (uint32_t uIx : m_auMapped)
+		{
+			if (m_abWanted[uIx]) { m_auMapped[uKeep++] = uIx; continue; }
+			HexBakeMapping::Unmap(m_apTile[uIx], s_uTileSz);
+			m_apTile[uIx] = nullptr;
+		}
+		m_auMapped.resize(uKeep);
+		for (uint32_t uIx(0); uIx < m_sHeader.uTileN; uIx++)
+		{
+			if (!m_abWanted[uIx] || m_apTile[uIx] || !psIndex[uIx].uBaked) continue;
+			m_apTile[uIx] = (const HexBakeTexel*)m_cFile.Map(psIndex[uIx].uOffset, s_uTileSz);
+			if (m_apTile[uIx]) m_auMapped.push_back(uIx);
+		}
+		return (unsigned)m_auMapped.size();
+	}
+
+	/// <summary>bilinear height and normal at xz on a level, false if outside or not mapped</summary>
+	bool Sample(float fX, float fY, unsigned uLevel, float& fHeight, float3& sNormal) const
+	{
+		if (uLevel >= m_sHeader.sDesc.uLevelN) return false;
+		const float fTexel = m_sHeader.sDesc.fTexel * (float)(1u << uLevel);
+		const float fU = (fX - m_sHeader.sDesc.fOriginX) / fTexel, fV = (fY - m_sHeader.sDesc.fOriginY) / fTexel;
+		if (!(fU >= 0.f) || !(fV >= 0.f)) return false;
+
+		// tile, texel, weights (last tile up to its edge texel)
+		constexpr uint32_t uCells = HEX_BAKE_TILE_S - 1;
+		const uint32_t uTx = (std::min)((uint32_t)(fU / (float)uCells), Tiles_X(uLevel) - 1);
+		const uint32_t uTy = (std::min)((uint32_t)(fV / (float)uCells), Tiles_Y(uLevel) - 1);
+		const float fLu = fU - (float)(uTx * uCells), fLv = fV - (float)(uTy * uCells);
+		if ((fLu > (float)uCells) || (fLv > (float)uCells)) return false;
+		const HexBakeTexel* psTile = m_apTile.empty() ? nullptr : m_apTile[m_auLevelFirst[uLevel] + uTy * Tiles_X(uLevel) + uTx];
+		if (!psTile) return false;
+		const uint32_t uI = (std::min)((uint32_t)fLu, uCells - 1), uJ = (std::min)((uint32_t)fLv, uCells - 1);
+		const float fFu = fLu - (float)uI, fFv = fLv - (float)uJ;
+
+		const HexBakeTexel* ps = &psTile[uJ * HEX_BAKE_TILE_S + uI];
+		const float afW[4] = { (1.f - fFu) * (1.f - fFv), fFu * (1.f - fFv), (1.f - fFu) * fFv, fFu * fFv };
+		const HexBakeTexel* aps[4] = { ps, ps + 1, ps + HEX_BAKE_TILE_S, ps + HEX_BAKE_TILE_S + 1 };
+		float fNx = 0.f, fNz = 0.f;
+		fHeight = 0.f;
+		for (unsigned uK(0); uK < 4; uK++)
+		{
+			fHeight += afW[uK] * aps[uK]->fHeight;
+			fNx += afW[uK] * (float)aps[uK]->nNx;
+			fNz += afW[uK] * (float)aps[uK]->nNz;
+		}
+		fNx *= 1.f / 32767.f;
+		fNz *= 1.f / 32767.f;
+		const float fNy = -std::sqrt((std::max)(1.f - fNx * fNx - fNz * fNz, 0.f));
+		const float fLenInv = 1.f / std::sqrt(fNx * fNx + fNy * fNy + fNz * fNz);
+		sNormal = float3{ fNx * fLenInv, fNy * fLenInv, fNz * fLenInv };
+		return true;
+	}
+
+	/// <summary>unmap all, close the file</summary>
+	void Close()
+	{
+		for (uint32_t uIx : m_auMapped) HexBakeMapping::Unmap(m_apTile[uIx], s_uTileSz);
+		m_auMapped.clear();
+		m_apTile.clear();
+		if (m_pIndexView) HexBakeMapping::Unmap(m_pIndexView, m_sHeader.uDataOffset);
+		if (m_pWrite) HexBakeMapping::Unmap(m_pWrite, m_sHeader.uFileSz);
+		m_pIndexView = m_pWrite = nullptr;
+		m_cFile.Close();
+	}
+
+	/// <summary>texels of a mapped tile (nullptr if not mapped)</summary>
+	const HexBakeTexel* Tile(unsigned uLevel, uint32_t uTx, uint32_t uTy) const
+	{
+		if ((uLevel >= m_sHeader.sDesc.uLevelN) || (uTx >= Tiles_X(uLevel)) || (uTy >= Tiles_Y(uLevel)) || m_apTile.empty()) return nullptr;
+		return m_apTile[m_auLevelFirst[uLevel] + uTy * Tiles_X(uLevel) + uTx];
+	}
+	/// <summary>header (description, size)</summary>
+	const HexBakeHeader& Header() const { return m_sHeader; }
+	/// <summary>tiles per side of a level, world span of a tile at a level</summary>
+	uint32_t Tiles_X(unsigned uLevel) const { return (std::max)((m_sHeader.sDesc.uTilesX + (1u << uLevel) - 1) >> uLevel, 1u); }
+	uint32_t Tiles_Y(unsigned uLevel) const { return (std::max)((m_sHeader.sDesc.uTilesY + (1u << uLevel) - 1) >> uLevel, 1u); }
+	float TileSpan(unsigned uLevel) const { return (float)(HEX_BAKE_TILE_S - 1) * m_sHeader.sDesc.fTexel * (float)(1u << uLevel); }
+	/// <summary>number of tiles, baked tiles, mapped tiles</summary>
+	uint32_t Tiles_N() const { return m_sHeader.uTileN; }
+	uint32_t Baked_N() const
+	{
+		if (!m_pWrite && !m_pIndexView) return 0;
+		uint32_t uN = 0;
+		for (uint32_t uI(0); uI < m_sHeader.uTileN; uI++) uN += Index()[uI].uBaked ? 1 : 0;
+		return uN;
+	}
+	uint32_t Mapped_N() const { return (uint32_t)m_auMapped.size(); }
+	/// <summary>bytes per tile</summary>
+	static constexpr uint64_t s_uTileSz = (uint64_t)HEX_BAKE_TILE_S * HEX_BAKE_TILE_S * sizeof(HexBakeTexel);
+
+private:
+	static_assert((s_uTileSz % HEX_BAKE_ALIGN) == 0, "HexBakePyramid : tiles must keep the view alignment");
+
+	/// <summary>header and level layout of a description</summary>
+	void Layout(const HexBakeDesc& sDesc)
+	{
+		std::memset(&m_sHeader, 0, sizeof(HexBakeHeader));
+		std::memcpy(m_sHeader.acMagic, "HEXBAKE", 8);
+		m_sHeader.uVersion = HEX_BAKE_VERSION;
+		m_sHeader.uTileS = HEX_BAKE_TILE_S;
+		m_sHeader.uHash = FBM_HASH_INTEGER;
+		m_sHeader.uOctaves = FBM_OCTAVES;
+		m_sHeader.sDesc = sDesc;
+		m_sHeader.sDesc.uLevelN = (std::max)((std::min)(sDesc.uLevelN, 16u), 1u);
+		m_auLevelFirst.clear();
+		uint32_t uN = 0;
+		for (uint32_t uL(0); uL < m_sHeader.sDesc.uLevelN; uL++)
+		{
+			m_auLevelFirst.push_back(uN);
+			uN += Tiles_X(uL) * Tiles_Y(uL);
+		}
+		m_auLevelFirst.push_back(uN);
+		m_sHeader.uTileN = uN;
+		m_sHeader.uDataOffset = (sizeof(HexBakeHeader) + (uint64_t)uN * sizeof(HexBakeIndex) + HEX_BAKE_ALIGN - 1) / HEX_BAKE_ALIGN * HEX_BAKE_ALIGN;
+		m_sHeader.uFileSz = m_sHeader.uDataOffset + (uint64_t)uN * s_uTileSz;
+	}
+
+	/// <summary>tile index : level, tile xy</summary>
+	uint32_t LevelOf(uint32_t uIx) const
+	{
+		uint32_t uL = 0;
+		while (uIx >= m_auLevelFirst[uL + 1]) uL++;
+		return uL;
+	}
+
+	/// <summary>tile index in the mapped header</summary>
+	HexBakeIndex* Index() const { return (HexBakeIndex*)((m_pWrite ? m_pWrite : m_pIndexView) + sizeof(HexBakeHeader)); }
+
+	/// <summary>bake a tile, texel rows in fbm_der batches</summary>
+	void BakeTile(uint32_t uIx, HexBakeTexel* psOut) const
+	{
+		const HexBakeDesc& sD = m_sHeader.sDesc;
+		const uint32_t uL = LevelOf(uIx), uLocal = uIx - m_auLevelFirst[uL];
+		const uint32_t uTx = uLocal % Tiles_X(uL), uTy = uLocal / Tiles_X(uL);
+		const float fTexel = sD.fTexel * (float)(1u << uL);
+		constexpr uint32_t uS = HEX_BAKE_TILE_S;
+		constexpr float fSquareHalf = .02f;
+
+		// level 0 one tap, above 3 x 3 tent taps at half texel
+		const float afW[3] = { .25f, .5f, .25f };
+		const int32_t nTapN = uL ? 3 : 1;
+		float afX[uS], afY[uS], afT[uS], afDx[uS], afDy[uS], afH[uS], afSx[uS], afSy[uS];
+		for (uint32_t uJ(0); uJ < uS; uJ++)
+		{
+			std::fill(afH, afH + uS, 0.f);
+			std::fill(afSx, afSx + uS, 0.f);
+			std::fill(afSy, afSy + uS, 0.f);
+			for (int32_t nTy(0); nTy < nTapN; nTy++)
+				for (int32_t nTx(0); nTx < nTapN; nTx++)
+				{
+					// global texel position (edge texels equal in both tiles)
+					const float fOx = uL ? (float)(nTx - 1) * .5f * fTexel : 0.f, fOy = uL ? (float)(nTy - 1) * .5f * fTexel : 0.f;
+					const float fW = uL ? afW[nTx] * afW[nTy] : 1.f;
+					const float fY = sD.fOriginY + (float)(uTy * (uS - 1) + uJ) * fTexel + fOy;
+					for (uint32_t uI(0); uI < uS; uI++)
+					{
+						afX[uI] = (sD.fOriginX + (float)(uTx * (uS - 1) + uI) * fTexel + fOx) * sD.fFbmScale;
+						afY[uI] = fY * sD.fFbmScale;
+					}
+					FbmDerBatch(afX, afY, uS, sD.fH, afT, afDx, afDy);
+					for (uint32_t uI(0); uI < uS; uI++)
+					{
+						afH[uI] += fW * afT[uI];
+						afSx[uI] += fW * afDx[uI];
+						afSy[uI] += fW * afDy[uI];
+					}
+				}
+
+			// normal as fbm_normal_der() : normalize(-s dx, -1, -s dy)
+			for (uint32_t uI(0); uI < uS; uI++)
+			{
+				const float fCx = -fSquareHalf * afSx[uI], fCz = -fSquareHalf * afSy[uI];
+				const float fLenInv = 1.f / std::sqrt(fCx * fCx + 1.f + fCz * fCz);
+				psOut[uJ * uS + uI] = HexBakeTexel{ afH[uI] * sD.fHeightScale,
+					(int16_t)std::lround(fCx * fLenInv * 32767.f), (int16_t)std::lround(fCz * fLenInv * 32767.f) };
+			}
+		}
+	}
+
+	/// <summary>file, header</summary>
+	HexBakeMapping m_cFile;
+	HexBakeHeader m_sHeader = {};
+	/// <summary>first tile index per level (+ total)</summary>
+	std::vector<uint32_t> m_auLevelFirst;
+	/// <summary>writable view of the whole file (baking), read only view of header and index (sampling)</summary>
+	uint8_t* m_pWrite = nullptr;
+	uint8_t* m_pIndexView = nullptr;
+	/// <summary>mapped tile views (nullptr : not mapped), mapped tile indices, tiles wanted by Page()</summary>
+	std::vector<const HexBakeTexel*> m_apTile;
+	std::vector<uint32_t> m_auMapped;
+	std::vector<uint8_t> m_abWanted;
+};
+
+#endif // _ZONE_BAKE
@@ -0,0 +1,108 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _ZONE_CAMERA
+#define _ZONE_CAMERA
+
+#include "app.h"
+#include <cmath>
+#include <cstdint>
+
+/// <summary>controller input, normalized (thumbs -1..1, triggers 0..1)</summary>
+struct CameraInput
+{
+	/// <summary>false if no controller is connected (camera keeps its orientation)</summary>
+	bool bConnected;
+	float fThumbLX, fThumbLY, fThumbRX, fThumbRY;
+	float fTriggerL, fTriggerR;
+	/// <summary>buttons (XInput layout)</summary>
+	uint16_t uButtons;
+};
+
+/// <summary>normalize controller input of a frame</summary>
+inline CameraInput CameraInputFrom(const InputFrame& sFrame)
+{
+	CameraInput sInput = {};
+	sInput.bConnected = (sFrame.uButtons & INPUT_CONNECTED) != 0;
+	sInput.fThumbLX = (float)sFrame.nThumbLX / 32767.f;
+	sInput.fThumbLY = (float)sFrame.nThumbLY / 32767.f;
+	sInput.fThumbRX = (float)sFrame.nThumbRX / 32767.f;
+	sInput.fThumbRY = (float)sFrame.nThumbRY / 32767.f;
+	sInput.fTriggerL = (float)sFrame.uTriggerL / 256.f;
+	sInput.fTriggerR = (float)sFrame.uTriggerR / 256.f;
+	sInput.uButtons = sFrame.uButtons;
+	return sInput;
+}
+
+/// <summary>free flight camera (position, velocity, yaw, pitch)</summary>
+struct Camera
+{
+	float3 sPos;
+	float3 sVelo;
+	float fYaw, fPitch;
+};
+
+/// <summary>
+/// Integrate the camera by elapsed time : accelerate by the input, move, clamp y,
+/// decelerate by drag (constant per frame)
+/// </summary>
+inline void CameraIntegrate(Camera& sCam, const CameraInput& sIn, float fTimeEl, float fAccelTran, float fAccelRot, float fDrag)
+{
+	if (sIn.bConnected)
+	{
+		// position xz
+		float fThX = sIn.fThumbLX * fTimeEl * fAccelTran;
+		float fThY = sIn.fThumbLY * fTimeEl * fAccelTran;
+		sCam.sVelo.x += fThX * std::cos(sCam.fYaw) - fThY * std::sin(sCam.fYaw);
+		sCam.sVelo.z += fThX * std::sin(sCam.fYaw) + fThY * std::cos(sCam.fYaw);
+
+		// height y
+		sCam.sVelo.y += sIn.fTriggerR * fTimeEl * fAccelTran;
+		sCam.sVelo.y -= sIn.fTriggerL * fTimeEl * fAccelTran;
+
+		// yaw, pitch
+		sCam.fYaw -= sIn.fThumbRX * fTimeEl * fAccelRot;
+		sCam.fYaw = std::fmod(sCam.fYaw, 6.283185307f);
+		sCam.fPitch = sIn.fThumbRY * 1.570796327f;
+	}
+
+	// add velo, clamp y, decelerate
+	sCam.sPos = float3{ sCam.sPos.x + sCam.sVelo.x, sCam.sPos.y + sCam.sVelo.y, sCam.sPos.z + sCam.sVelo.z };
+	if (sCam.sPos.y < 0.f) sCam.sPos.y = 0.f;
+	sCam.sVelo = float3{ sCam.sVelo.x * fDrag, sCam.sVelo.y * fDrag, sCam.sVelo.z * fDrag };
+}
+
+/// <summary>
+/// View projection of the camera, row vector convention, rows in afVP (as XMFLOAT4X4) : translate by -pos,
+/// rotate yaw (y axis), pitch (x axis), perspective left handed (equals the matrices in App_D3D12::UpdateConstants())
+/// </summary>
+inline void CameraViewProjection(const Camera& sCam, float fFovY, float fAspect, float fNear, float fFar, float afVP[16])
+{
+	const float fCy = std::cos(sCam.fYaw), fSy = std::sin(sCam.fYaw);
+	const float fCp = std::cos(sCam.fPitch), fSp = std::sin(sCam.fPitch);
+	const float fH = 1.f / std::tan(fFovY * .5f), fW = fH / fAspect, fQ = fFar / (fFar - fNear);
+
+	// view : rotation rows (yaw * pitch), translation row
+	const float afR[3][3] = {
+		{ fCy, fSy * fSp, -fSy * fCp },
+		{ 0.f, fCp, fSp },
+		{ fSy, -fCy * fSp, fCy * fCp } };
+	float afT[3] = {};
+	for (unsigned uC(0); uC < 3; uC++)
+		afT[uC] = -(sCam.sPos.x * afR[0][uC] + sCam.sPos.y * afR[1][uC] + sCam.sPos.z * afR[2][uC]);
+
+	// times projection (x * w, y * h, z * q + w * -near * q, w = z)
+	for (unsigned uRow(0); uRow < 4; uRow++)
+	{
+		const float* pfV = (uRow < 3) ? afR[uRow] : afT;
+		const float fTw = (uRow < 3) ? 0.f : 1.f;
+		afVP[uRow * 4 + 0] = pfV[0] * fW;
+		afVP[uRow * 4 + 1] = pfV[1] * fH;
+		afVP[uRow * 4 + 2] = pfV[2] * fQ - fTw * fNear * fQ;
+		afVP[uRow * 4 + 3] = pfV[2];
+	}
+}
+
+#endif // _ZONE_CAMERA
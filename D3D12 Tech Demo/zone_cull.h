@@ -0,0 +1,159 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _ZONE_CULL
+#define _ZONE_CULL
+
+#include "zone_tiles.h"
+#include <vector>
+#include <array>
+
+// Frustum culling of the hex tiles on CPU :
+//
+// planes        extracted from the world view projection (row vector convention, D3D clip space
+//               -w <= x, y <= w, 0 <= z <= w), normals point inside
+// tile bounds   axis aligned box : tile offset xz, extents of the tile corners (size 1 : sqrt(3)/2, 1),
+//               height by the known terrain bound (see FbmBound())
+// draw order    visible tiles sorted front to back by ring (hex distance to the center hex),
+//               counting sort, one contiguous range per ring
+
+/// <summary>frustum planes (xyz - normal, w - distance), left, right, bottom, top, near, far</summary>
+typedef std::array<float4, 6> HexCullFrustum;
+
+/// <summary>frustum planes of a world view projection (rows in afM, as XMFLOAT4X4)</summary>
+inline HexCullFrustum HexCullPlanes(const float afM[16])
+{
+	// column c of the matrix
+	auto fCol = [afM](unsigned uC) { return float4{ afM[uC], afM[4 + uC], afM[8 + uC], afM[12 + uC] }; };
+	auto fAdd = [](const float4& sA, const float4& sB, float fS) { return float4{ sA.x + fS * sB.x, sA.y + fS * sB.y, sA.z + fS * sB.z, sA.w + fS * sB.w }; };
+	const float4 sC0 = fCol(0), sC1 = fCol(1), sC2 = fCol(2), sC3 = fCol(3);
+	return HexCullFrustum{ {
+		fAdd(sC3, sC0, 1.f), fAdd(sC3, sC0, -1.f),
+		fAdd(sC3, sC1, 1.f), fAdd(sC3, sC1, -1.f),
+		sC2, fAdd(sC3, sC2, -1.f) } };
+}
+
+/// <summary>axis aligned box (center, extents) intersects or is inside the frustum (conservative)</summary>
+inline bool HexCullBox(const HexCullFrustum& asPlanes, const float3& sC, const float3& sE)
+{
+	for (const float4& sP : asPlanes)
+	{
+		const float fD = sP.x * sC.x + sP.y * sC.y + sP.z * sC.z + sP.w;
+		const float fR = std::abs(sP.x) * sE.x + std::abs(sP.y) * sE.y + std::abs(sP.z) * sE.z;
+		if (fD + fR < 0.f) return false;
+	}
+	return true;
+}
+
+/// <summary>
+/// all boxes (extents sE) with the center xz within fRadius around sC pass HexCullBox() : per plane the
+/// nearest center passes (with a slack for the float rounding of the per box test)
+/// </summary>
+inline bool HexCullBoxesInside(const HexCullFrustum& asPlanes, const float3& sC, float fRadius, const float3& sE)
+{
+	for (const float4& sP : asPlanes)
+	{
+		const float fD = sP.x * sC.x + sP.y * sC.y + sP.z * sC.z + sP.w;
+		const float fR = std::abs(sP.x) * sE.x + std::abs(sP.y) * sE.y + std::abs(sP.z) * sE.z;
+		const float fXZ = fRadius * std::sqrt(sP.x * sP.x + sP.z * sP.z);
+		if (fD + fR - fXZ < 1e-4f * (std::abs(fD) + fR + fXZ + std::abs(sP.w))) return false;
+	}
+	return true;
+}
+
+/// <summary>draw range of a ring in the visible tiles</summary>
+struct HexCullRange
+{
+	uint32_t uRing, uFirst, uN;
+};
+
+/// <summary>
+/// Tile culler : tests the tile boxes against the frustum each frame, provides the visible tile
+/// indices front to back (by ring) and the draw range per ring. Tile offsets as HexTilesLayout().
+/// </summary>
+class HexTilesCuller
+{
+public:
+	/// <summary>init by number of rings, tile size and terrain height range (world y)</summary>
+	void Init(unsigned uAmbitN, float fTileSz, float fHeightMin, float fHeightMax)
+	{
+		m_uAmbitN = uAmbitN;
+		m_fTileSz = fTileSz;
+		m_fY = (fHeightMax + fHeightMin) * .5f;
+		m_sExtents = float3{ HexConst<float>::fHalfSqrt3 * fTileSz, (fHeightMax - fHeightMin) * .5f, fTileSz };
+		m_auRingN.assign(uAmbitN + 1, 0);
+		m_auRing.clear();
+		m_auVisible.clear();
+		m_asRanges.clear();
+	}
+
+	/// <summary>
+	/// cull the tiles [0, uInstN) around the center hex against the world view projection afWVP,
+	/// returns the number of visible tiles
+	/// </summary>
+	template <typename T4>
+	unsigned Cull(const std::vector<T4>& asTilePos, unsigned uInstN, const HexCube& sCenter, const float afWVP[16])
+	{
+		const HexCullFrustum asPlanes = HexCullPlanes(afWVP);
+		uInstN = (unsigned)(std::min)((size_t)uInstN, asTilePos.size());
+		m_auRing.resize(uInstN);
+		std::fill(m_auRingN.begin(), m_auRingN.end(), 0);
+
+		// test, ring of the visible tiles (~0u : culled)
+		unsigned uVisibleN = 0;
+		for (unsigned uI(0); uI < uInstN; uI++)
+		{
+			const T4& sTile = asTilePos[uI];
+			if (!HexCullBox(asPlanes, float3{ sTile.x, m_fY, sTile.y }, m_sExtents)) { m_auRing[uI] = ~0u; continue; }
+			const uint32_t uRing = (std::min)((uint32_t)HexCubeDistance(HexCubeAt(sTile.x, sTile.y, m_fTileSz), sCenter), (uint32_t)m_uAmbitN);
+			m_auRing[uI] = uRing;
+			m_auRingN[uRing]++;
+			uVisibleN++;
+		}
+
+		// counting sort by ring, ranges
+		m_asRanges.clear();
+		uint32_t uFirst = 0;
+		for (uint32_t uRing(0); uRing <= m_uAmbitN; uRing++)
+		{
+			const uint32_t uN = m_auRingN[uRing];
+			if (uN) m_asRanges.push_back(HexCullRange{ uRing, uFirst, uN });
+			m_auRingN[uRing] = uFirst;
+			uFirst += uN;
+		}
+		m_auVisible.resize(uVisibleN);
+		for (uint32_t uI(0); uI < uInstN; uI++)
+			if (m_auRing[uI] != ~0u) m_auVisible[m_auRingN[m_auRing[uI]]++] = uI;
+		return uVisibleN;
+	}
+
+	/// <summary>visible tile indices, front to back by ring</summary>
+	const std::vector<uint32_t>& Visible() const { return m_auVisible; }
+	/// <summary>draw ranges in Visible(), one per ring with visible tiles, ascending</summary>
+	const std::vector<HexCullRange>& Ranges() const { return m_asRanges; }
+	/// <summary>ring of a tile in the last Cull() (~0u : culled)</summary>
+	uint32_t Ring(unsigned uIx) const { return m_auRing[uIx]; }
+	/// <summary>tile box center y and extents</summary>
+	float Center_Y() const { return m_fY; }
+	const float3& Extents() const { return m_sExtents; }
+
+private:
+	/// <summary>number of rings, tile size</summary>
+	unsigned m_uAmbitN = 0;
+	float m_fTileSz = 1.f;
+	/// <summary>tile box center y, extents</summary>
+	float m_fY = 0.f;
+	float3 m_sExtents = {};
+	/// <summary>visible tiles per ring (first index after the prefix sum)</summary>
+	std::vector<uint32_t> m_auRingN;
+	/// <summary>ring per tile</summary>
+	std::vector<uint32_t> m_auRing;
+	/// <summary>visible tiles sorted by ring</summary>
+	std::vector<uint32_t> m_auVisible;
+	/// <summary>draw range per ring</summary>
+	std::vector<HexCullRange> m_asRanges;
+};
+
+#endif // _ZONE_CULL
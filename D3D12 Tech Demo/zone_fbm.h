@@ -0,0 +1,740 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+// zone_fbm.h : C++ port of the terrain functions in Shaders/fbm.hlsli
+// based on https://www.shadertoy.com/view/XdXBRH
+//          https://www.shadertoy.com/view/Msf3WH
+// Copyright  2017 Inigo Quilez
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _ZONE_FBM
+#define _ZONE_FBM
+
+#include "app.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define FBM_SIMD_SSE2
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FBM_SIMD_AVX2
+#endif
+#if defined(__AVX512F__)
+#define FBM_SIMD_AVX512
+#endif
+
+#if defined(__clang__)
+#pragma float_control(push)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+// CPU port of the noise stack, one source for scalar (T = float) and SIMD (T = FbmV4, FbmV8, FbmV16) :
+//
+// hash           FBM_HASH_INTEGER (HASH_INTEGER in fbm.hlsli, keep both equal) selects the gradient hash :
+//                1 - xxhash32 of the integral lattice coordinates, 24 bit to [-1, 1), exact on CPU and GPU
+//                and stable up to |v| < 2^24, 0 - the original sin hash (below)
+// sin            the sin hash is frac(sin(v) * 43758.5453), so any sin error is amplified by ~10^5 : sin is
+//                evaluated in double and rounded to float (scalar std::sin, SIMD Cody-Waite reduction
+//                and degree 13/14 polynomials, error < 10^-13), scalar and SIMD results are bitwise equal
+//                for |v| < 1.6 * 10^6 (float ties aside, see App_Benchmark::FbmKernels)
+// shader         the GPU sin is an approximation (D3D : absolute error 0.0008), the shader noise
+//                equals this port only as far as the GPU sin rounds to the same float
+// widths         SSE2 (4), AVX2 (8), AVX-512 (16) by compile flags (/arch:AVX2, -mavx2, ...)
+// contraction    no FMA, scalar code must not be contracted either : turned off for this header (above)
+//                (GCC optimize, clang float_control, MSVC /fp:precise does not contract)
+// octaves        FbmN<N>(), FbmDerN<N>() : N octaves at compile time (unrolled), Fbm() = FbmN<FBM_OCTAVES>(),
+//                FbmOctaves() picks a fractional count by the pixel footprint (ray distance or tile ring),
+//                FbmLod() dispatches to the specialisation and fades its last octave in (no popping)
+
+/// <summary>number of fbm octaves (OCTAVES in fbm.hlsli)</summary>
+constexpr int FBM_OCTAVES = 6;
+
+/// <summary>gradient hash : 1 - integer hash, 0 - sin hash</summary>
+#ifndef FBM_HASH_INTEGER
+#define FBM_HASH_INTEGER 1
+#endif
+
+/// <summary>xxhash32 of two words (hash_xx32() in fbm.hlsli, Jarzynski, Olano : Hash Functions for GPU Rendering)</summary>
+inline uint32_t FbmXxHash32(uint32_t uX, uint32_t uY)
+{
+	uint32_t uH = uY + 374761393u + uX * 3266489917u;
+	uH = 668265263u * ((uH << 17) | (uH >> 15));
+	uH = 2246822519u * (uH ^ (uH >> 15));
+	uH = 3266489917u * (uH ^ (uH >> 13));
+	return uH ^ (uH >> 16);
+}
+
+/// <summary>scalar lane functions (vector types provide the same set)</summary>
+inline float FbmFloor(float fV) { return std::floor(fV); }
+inline float FbmSin(float fV) { return (float)std::sin((double)fV); }
+inline float FbmMax(float fA, float fB) { return (fA > fB) ? fA : fB; }
+inline float FbmSqrt(float fV) { return std::sqrt(fV); }
+/// <summary>hlsl step() : fX >= fEdge ? 1 : 0</summary>
+inline float FbmStep(float fEdge, float fX) { return (fX >= fEdge) ? 1.f : 0.f; }
+
+#ifdef FBM_SIMD_SSE2
+/// <summary>sin in double (2 lanes), Cody-Waite reduction by pi / 2, polynomials on [-pi / 4, pi / 4]</summary>
+inline __m128d FbmSinPd(__m128d sX)
+{
+	const __m128i sKi = _mm_cvtpd_epi32(_mm_mul_pd(sX, _mm_set1_pd(0.63661977236758134)));
+	const __m128d sK = _mm_cvtepi32_pd(sKi);
+	const __m128d sR = _mm_sub_pd(_mm_sub_pd(sX, _mm_mul_pd(sK, _mm_set1_pd(1.5707963267341256))), _mm_mul_pd(sK, _mm_set1_pd(6.077100506506192e-11)));
+	const __m128d sR2 = _mm_mul_pd(sR, sR);
+	__m128d sS = _mm_set1_pd(1. / 6227020800.), sC = _mm_set1_pd(-1. / 87178291200.);
+	for (double dS : { -1. / 39916800., 1. / 362880., -1. / 5040., 1. / 120., -1. / 6. })
+		sS = _mm_add_pd(_mm_mul_pd(sS, sR2), _mm_set1_pd(dS));
+	for (double dC : { 1. / 479001600., -1. / 3628800., 1. / 40320., -1. / 720., 1. / 24., -.5, 1. })
+		sC = _mm_add_pd(_mm_mul_pd(sC, sR2), _mm_set1_pd(dC));
+	sS = _mm_add_pd(sR, _mm_mul_pd(_mm_mul_pd(sR, sR2), sS));
+
+	// quadrant : odd - cos, bit 1 - negate (int lanes 0, 1 to 64 bit masks)
+	const __m128i sK64 = _mm_shuffle_epi32(sKi, _MM_SHUFFLE(1, 1, 0, 0));
+	const __m128d sOdd = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(sK64, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	const __m128d sNeg = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(sK64, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+	const __m128d sV = _mm_or_pd(_mm_and_pd(sOdd, sC), _mm_andnot_pd(sOdd, sS));
+	return _mm_xor_pd(sV, _mm_and_pd(sNeg, _mm_set1_pd(-0.)));
+}
+
+/// <summary>4 lanes (SSE2)</summary>
+struct FbmV4
+{
+	__m128 v;
+	FbmV4() = default;
+	FbmV4(__m128 sV) : v(sV) {}
+	FbmV4(float fV) : v(_mm_set1_ps(fV)) {}
+	static constexpr size_t N = 4;
+	static FbmV4 Load(const float* pf) { return _mm_loadu_ps(pf); }
+	void Store(float* pf) const { _mm_storeu_ps(pf, v); }
+};
+inline FbmV4 operator+(FbmV4 sA, FbmV4 sB) { return _mm_add_ps(sA.v, sB.v); }
+inline FbmV4 operator-(FbmV4 sA, FbmV4 sB) { return _mm_sub_ps(sA.v, sB.v); }
+inline FbmV4 operator*(FbmV4 sA, FbmV4 sB) { return _mm_mul_ps(sA.v, sB.v); }
+inline FbmV4 operator/(FbmV4 sA, FbmV4 sB) { return _mm_div_ps(sA.v, sB.v); }
+inline FbmV4 FbmFloor(FbmV4 sV)
+{
+	// truncate, correct negative (|v| < 2^31, as HexCubeAtBatch())
+	const __m128 sT = _mm_cvtepi32_ps(_mm_cvttps_epi32(sV.v));
+	return _mm_sub_ps(sT, _mm_and_ps(_mm_cmpgt_ps(sT, sV.v), _mm_set1_ps(1.f)));
+}
+inline FbmV4 FbmSin(FbmV4 sV)
+{
+	const __m128 sLo = _mm_cvtpd_ps(FbmSinPd(_mm_cvtps_pd(sV.v)));
+	const __m128 sHi = _mm_cvtpd_ps(FbmSinPd(_mm_cvtps_pd(_mm_movehl_ps(sV.v, sV.v))));
+	return _mm_movelh_ps(sLo, sHi);
+}
+inline FbmV4 FbmMax(FbmV4 sA, FbmV4 sB) { return _mm_max_ps(sA.v, sB.v); }
+inline FbmV4 FbmSqrt(FbmV4 sV) { return _mm_sqrt_ps(sV.v); }
+inline FbmV4 FbmStep(FbmV4 sEdge, FbmV4 sX) { return _mm_and_ps(_mm_cmpge_ps(sX.v, sEdge.v), _mm_set1_ps(1.f)); }
+/// <summary>32 bit multiply (low), SSE2 by two 32x32 -> 64 bit products</summary>
+inline __m128i FbmMulLo(__m128i sA, __m128i sB)
+{
+	const __m128i sEven = _mm_mul_epu32(sA, sB);
+	const __m128i sOdd = _mm_mul_epu32(_mm_srli_epi64(sA, 32), _mm_srli_epi64(sB, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(sEven, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(sOdd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+/// <summary>integer hash of integral lattice coordinates to [-1, 1), as FbmHashInt(float, float)</summary>
+inline FbmV4 FbmHashInt(FbmV4 sX, FbmV4 sY)
+{
+	auto fMul = [](__m128i sA, uint32_t uB) { return FbmMulLo(sA, _mm_set1_epi32((int)uB)); };
+	const __m128i sIx = _mm_cvttps_epi32(sX.v), sIy = _mm_cvttps_epi32(sY.v);
+	__m128i sH = _mm_add_epi32(_mm_add_epi32(sIy, _mm_set1_epi32(374761393)), fMul(sIx, 3266489917u));
+	sH = fMul(_mm_or_si128(_mm_slli_epi32(sH, 17), _mm_srli_epi32(sH, 15)), 668265263u);
+	sH = fMul(_mm_xor_si128(sH, _mm_srli_epi32(sH, 15)), 2246822519u);
+	sH = fMul(_mm_xor_si128(sH, _mm_srli_epi32(sH, 13)), 3266489917u);
+	sH = _mm_xor_si128(sH, _mm_srli_epi32(sH, 16));
+	const __m128 sU = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(sH, 8)), _mm_set1_ps(1.f / 16777216.f));
+	return _mm_add_ps(_mm_set1_ps(-1.f), _mm_mul_ps(_mm_set1_ps(2.f), sU));
+}
+#endif
+
+#ifdef FBM_SIMD_AVX2
+/// <summary>sin in double (4 lanes), as FbmSinPd(__m128d)</summary>
+inline __m256d FbmSinPd(__m256d sX)
+{
+	const __m256d sK = _mm256_round_pd(_mm256_mul_pd(sX, _mm256_set1_pd(0.63661977236758134)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	const __m256d sR = _mm256_sub_pd(_mm256_sub_pd(sX, _mm256_mul_pd(sK, _mm256_set1_pd(1.5707963267341256))), _mm256_mul_pd(sK, _mm256_set1_pd(6.077100506506192e-11)));
+	const __m256d sR2 = _mm256_mul_pd(sR, sR);
+	__m256d sS = _mm256_set1_pd(1. / 6227020800.), sC = _mm256_set1_pd(-1. / 87178291200.);
+	for (double dS : { -1. / 39916800., 1. / 362880., -1. / 5040., 1. / 120., -1. / 6. })
+		sS = _mm256_add_pd(_mm256_mul_pd(sS, sR2), _mm256_set1_pd(dS));
+	for (double dC : { 1. / 479001600., -1. / 3628800., 1. / 40320., -1. / 720., 1. / 24., -.5, 1. })
+		sC = _mm256_add_pd(_mm256_mul_pd(sC, sR2), _mm256_set1_pd(dC));
+	sS = _mm256_add_pd(sR, _mm256_mul_pd(_mm256_mul_pd(sR, sR2), sS));
+
+	const __m256i sK64 = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(sK));
+	const __m256d sOdd = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(sK64, _mm256_set1_epi64x(1)), _mm256_set1_epi64x(1)));
+	const __m256d sNeg = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(sK64, _mm256_set1_epi64x(2)), _mm256_set1_epi64x(2)));
+	return _mm256_xor_pd(_mm256_blendv_pd(sS, sC, sOdd), _mm256_and_pd(sNeg, _mm256_set1_pd(-0.)));
+}
+
+/// <summary>8 lanes (AVX2)</summary>
+struct FbmV8
+{
+	__m256 v;
+	FbmV8() = default;
+	FbmV8(__m256 sV) : v(sV) {}
+	FbmV8(float fV) : v(_mm256_set1_ps(fV)) {}
+	static constexpr size_t N = 8;
+	static FbmV8 Load(const float* pf) { return _mm256_loadu_ps(pf); }
+	void Store(float* pf) const { _mm256_storeu_ps(pf, v); }
+};
+inline FbmV8 operator+(FbmV8 sA, FbmV8 sB) { return _mm256_add_ps(sA.v, sB.v); }
+inline FbmV8 operator-(FbmV8 sA, FbmV8 sB) { return _mm256_sub_ps(sA.v, sB.v); }
+inline FbmV8 operator*(FbmV8 sA, FbmV8 sB) { return _mm256_mul_ps(sA.v, sB.v); }
+inline FbmV8 operator/(FbmV8 sA, FbmV8 sB) { return _mm256_div_ps(sA.v, sB.v); }
+inline FbmV8 FbmFloor(FbmV8 sV) { return _mm256_floor_ps(sV.v); }
+inline FbmV8 FbmSin(FbmV8 sV)
+{
+	const __m128 sLo = _mm256_cvtpd_ps(FbmSinPd(_mm256_cvtps_pd(_mm256_castps256_ps128(sV.v))));
+	const __m128 sHi = _mm256_cvtpd_ps(FbmSinPd(_mm256_cvtps_pd(_mm256_extractf128_ps(sV.v, 1))));
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(sLo), sHi, 1);
+}
+inline FbmV8 FbmMax(FbmV8 sA, FbmV8 sB) { return _mm256_max_ps(sA.v, sB.v); }
+inline FbmV8 FbmSqrt(FbmV8 sV) { return _mm256_sqrt_ps(sV.v); }
+inline FbmV8 FbmStep(FbmV8 sEdge, FbmV8 sX) { return _mm256_and_ps(_mm256_cmp_ps(sX.v, sEdge.v, _CMP_GE_OQ), _mm256_set1_ps(1.f)); }
+inline FbmV8 FbmHashInt(FbmV8 sX, FbmV8 sY)
+{
+	auto fMul = [](__m256i sA, uint32_t uB) { return _mm256_mullo_epi32(sA, _mm256_set1_epi32((int)uB)); };
+	const __m256i sIx = _mm256_cvttps_epi32(sX.v), sIy = _mm256_cvttps_epi32(sY.v);
+	__m256i sH = _mm256_add_epi32(_mm256_add_epi32(sIy, _mm256_set1_epi32(374761393)), fMul(sIx, 3266489917u));
+	sH = fMul(_mm256_or_si256(_mm256_slli_epi32(sH, 17), _mm256_srli_epi32(sH, 15)), 668265263u);
+	sH = fMul(_mm256_xor_si256(sH, _mm256_srli_epi32(sH, 15)), 2246822519u);
+	sH = fMul(_mm256_xor_si256(sH, _mm256_srli_epi32(sH, 13)), 3266489917u);
+	sH = _mm256_xor_si256(sH, _mm256_srli_epi32(sH, 16));
+	const __m256 sU = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(sH, 8)), _mm256_set1_ps(1.f / 16777216.f));
+	return _mm256_add_ps(_mm256_set1_ps(-1.f), _mm256_mul_ps(_mm256_set1_ps(2.f), sU));
+}
+#endif
+
+#ifdef FBM_SIMD_AVX512
+/// <summary>sin in double (8 lanes), as FbmSinPd(__m128d)</summary>
+inline __m512d FbmSinPd(__m512d sX)
+{
+	const __m512d sK = _mm512_roundscale_pd(_mm512_mul_pd(sX, _mm512_set1_pd(0.63661977236758134)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	const __m512d sR = _mm512_sub_pd(_mm512_sub_pd(sX, _mm512_mul_pd(sK, _mm512_set1_pd(1.5707963267341256))), _mm512_mul_pd(sK, _mm512_set1_pd(6.077100506506192e-11)));
+	const __m512d sR2 = _mm512_mul_pd(sR, sR);
+	__m512d sS = _mm512_set1_pd(1. / 6227020800.), sC = _mm512_set1_pd(-1. / 87178291200.);
+	for (double dS : { -1. / 39916800., 1. / 362880., -1. / 5040., 1. / 120., -1. / 6. })
+		sS = _mm512_add_pd(_mm512_mul_pd(sS, sR2), _mm512_set1_pd(dS));
+	for (double dC : { 1. / 479001600., -1. / 3628800., 1. / 40320., -1. / 720., 1. / 24., -.5, 1. })
+		sC = _mm512_add_pd(_mm512_mul_pd(sC, sR2), _mm512_set1_pd(dC));
+	sS = _mm512_add_pd(sR, _mm512_mul_pd(_mm512_mul_pd(sR, sR2), sS));
+
+	const __m512i sK64 = _mm512_cvtepi32_epi64(_mm512_cvtpd_epi32(sK));
+	const __mmask8 uOdd = _mm512_test_epi64_mask(sK64, _mm512_set1_epi64(1));
+	const __mmask8 uNeg = _mm512_test_epi64_mask(sK64, _mm512_set1_epi64(2));
+	const __m512d sV = _mm512_mask_blend_pd(uOdd, sS, sC);
+	return _mm512_mask_sub_pd(sV, uNeg, _mm512_setzero_pd(), sV);
+}
+
+/// <summary>16 lanes (AVX-512)</summary>
+struct FbmV16
+{
+	__m512 v;
+	FbmV16() = default;
+	FbmV16(__m512 sV) : v(sV) {}
+	FbmV16(float fV) : v(_mm512_set1_ps(fV)) {}
+	static constexpr size_t N = 16;
+	static FbmV16 Load(const float* pf) { return _mm512_loadu_ps(pf); }
+	void Store(float* pf) const { _mm512_storeu_ps(pf, v); }
+};
+inline FbmV16 operator+(FbmV16 sA, FbmV16 sB) { return _mm512_add_ps(sA.v, sB.v); }
+inline FbmV16 operator-(FbmV16 sA, FbmV16 sB) { return _mm512_sub_ps(sA.v, sB.v); }
+inline FbmV16 operator*(FbmV16 sA, FbmV16 sB) { return _mm512_mul_ps(sA.v, sB.v); }
+inline FbmV16 operator/(FbmV16 sA, FbmV16 sB) { return _mm512_div_ps(sA.v, sB.v); }
+inline FbmV16 FbmFloor(FbmV16 sV) { return _mm512_roundscale_ps(sV.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+inline FbmV16 FbmSin(FbmV16 sV)
+{
+	const __m256 sLo = _mm512_cvtpd_ps(FbmSinPd(_mm512_cvtps_pd(_mm512_castps512_ps256(sV.v))));
+	const __m256 sHi = _mm512_cvtpd_ps(FbmSinPd(_mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(sV.v), 1)))));
+	return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_castps_pd(sLo)), _mm256_castps_pd(sHi), 1));
+}
+inline FbmV16 FbmMax(FbmV16 sA, FbmV16 sB) { return _mm512_max_ps(sA.v, sB.v); }
+inline FbmV16 FbmSqrt(FbmV16 sV) { return _mm512_sqrt_ps(sV.v); }
+inline FbmV16 FbmStep(FbmV16 sEdge, FbmV16 sX) { return _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(sX.v, sEdge.v, _CMP_GE_OQ), _mm512_set1_ps(1.f)); }
+inline FbmV16 FbmHashInt(FbmV16 sX, FbmV16 sY)
+{
+	auto fMul = [](__m512i sA, uint32_t uB) { return _mm512_mullo_epi32(sA, _mm512_set1_epi32((int)uB)); };
+	const __m512i sIx = _mm512_cvttps_epi32(sX.v), sIy = _mm512_cvttps_epi32(sY.v);
+	__m512i sH = _mm512_add_epi32(_mm512_add_epi32(sIy, _mm512_set1_epi32(374761393)), fMul(sIx, 3266489917u));
+	sH = fMul(_mm512_rol_epi32(sH, 17), 668265263u);
+	sH = fMul(_mm512_xor_si512(sH, _mm512_srli_epi32(sH, 15)), 2246822519u);
+	sH = fMul(_mm512_xor_si512(sH, _mm512_srli_epi32(sH, 13)), 3266489917u);
+	sH = _mm512_xor_si512(sH, _mm512_srli_epi32(sH, 16));
+	const __m512 sU = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_srli_epi32(sH, 8)), _mm512_set1_ps(1.f / 16777216.f));
+	return _mm512_add_ps(_mm512_set1_ps(-1.f), _mm512_mul_ps(_mm512_set1_ps(2.f), sU));
+}
+#endif
+
+/// <summary>widest vector type of the build</summary>
+#if defined(FBM_SIMD_AVX512)
+typedef FbmV16 FbmVec;
+#elif defined(FBM_SIMD_AVX2)
+typedef FbmV8 FbmVec;
+#elif defined(FBM_SIMD_SSE2)
+typedef FbmV4 FbmVec;
+#else
+typedef float FbmVec;
+#endif
+
+/// <summary>hlsl frac()</summary>
+template <typename T>
+inline T FbmFrac(T fV) { return fV - FbmFloor(fV); }
+
+/// <summary>random value by sin (hash() in fbm.hlsli, HASH_INTEGER 0)</summary>
+template <typename T>
+inline T FbmHashSin(T fX, T fY)
+{
+	return T(-1.f) + T(2.f) * FbmFrac(FbmSin(fX * T(12.9898f) + fY * T(78.233f)) * T(43758.5453f));
+}
+
+/// <summary>random value by integer hash of integral lattice coordinates (hash() in fbm.hlsli, HASH_INTEGER 1)</summary>
+inline float FbmHashInt(float fX, float fY)
+{
+	const uint32_t uH = FbmXxHash32((uint32_t)(int32_t)fX, (uint32_t)(int32_t)fY);
+	return -1.f + 2.f * ((float)(uH >> 8) * (1.f / 16777216.f));
+}
+
+/// <summary>
+/// random value in [0, 1) of any point (hash12() in CS_demo02.hlsl) : integer hash of the float bits
+/// (asuint(), no precision loss at large coordinates, x hashed first) or the sin free hash by Dave Hoskins (FBM_HASH_INTEGER 0)
+/// </summary>
+inline float FbmHash12(float fX, float fY)
+{
+#if FBM_HASH_INTEGER
+	uint32_t uX, uY;
+	std::memcpy(&uX, &fX, sizeof(uX));
+	std::memcpy(&uY, &fY, sizeof(uY));
+	return (float)(FbmXxHash32(FbmXxHash32(uX, 0u), uY) >> 8) * (1.f / 16777216.f);
+#else
+	float fPx = FbmFrac(fX * .1031f), fPy = FbmFrac(fY * .1031f), fPz = fPx;
+	const float fD = fPx * (fPy + 33.33f) + fPy * (fPz + 33.33f) + fPz * (fPx + 33.33f);
+	fPx += fD; fPy += fD; fPz += fD;
+	return FbmFrac((fPx + fPy) * fPz);
+#endif
+}
+
+/// <summary>random value at a lattice point (hash() in fbm.hlsli, both components equal)</summary>
+template <typename T>
+inline T FbmHash(T fX, T fY)
+{
+#if FBM_HASH_INTEGER
+	return FbmHashInt(fX, fY);
+#else
+	return FbmHashSin(fX, fY);
+#endif
+}
+
+/// <summary>gradient noise, quintic interpolation (noised() in fbm.hlsli)</summary>
+template <typename T>
+inline T FbmNoised(T fX, T fY)
+{
+	const T fIx = FbmFloor(fX), fIy = FbmFloor(fY);
+	const T fFx = fX - fIx, fFy = fY - fIy;
+	const T fUx = fFx * fFx * fFx * (fFx * (fFx * T(6.f) - T(15.f)) + T(10.f));
+	const T fUy = fFy * fFy * fFy * (fFy * (fFy * T(6.f) - T(15.f)) + T(10.f));
+
+	// gradients of the quad corners (both components equal), dot with the corner vectors
+	const T fGa = FbmHash(fIx, fIy), fGb = FbmHash(fIx + T(1.f), fIy);
+	const T fGc = FbmHash(fIx, fIy + T(1.f)), fGd = FbmHash(fIx + T(1.f), fIy + T(1.f));
+	const T fVa = fGa * fFx + fGa * fFy;
+	const T fVb = fGb * (fFx - T(1.f)) + fGb * fFy;
+	const T fVc = fGc * fFx + fGc * (fFy - T(1.f));
+	const T fVd = fGd * (fFx - T(1.f)) + fGd * (fFy - T(1.f));
+
+	return fVa + fUx * (fVb - fVa) + fUy * (fVc - fVa) + fUx * fUy * (fVa - fVb - fVc + fVd);
+}
+
+/// <summary>gradient noise and its derivatives (noised_der() in fbm.hlsli)</summary>
+template <typename T>
+inline T FbmNoisedDer(T fX, T fY, T& fDx, T& fDy)
+{
+	const T fIx = FbmFloor(fX), fIy = FbmFloor(fY);
+	const T fFx = fX - fIx, fFy = fY - fIy;
+	const T fUx = fFx * fFx * fFx * (fFx * (fFx * T(6.f) - T(15.f)) + T(10.f));
+	const T fUy = fFy * fFy * fFy * (fFy * (fFy * T(6.f) - T(15.f)) + T(10.f));
+	const T fDux = T(30.f) * fFx * fFx * (fFx * (fFx - T(2.f)) + T(1.f));
+	const T fDuy = T(30.f) * fFy * fFy * (fFy * (fFy - T(2.f)) + T(1.f));
+
+	const T fGa = FbmHash(fIx, fIy), fGb = FbmHash(fIx + T(1.f), fIy);
+	const T fGc = FbmHash(fIx, fIy + T(1.f)), fGd = FbmHash(fIx + T(1.f), fIy + T(1.f));
+	const T fVa = fGa * fFx + fGa * fFy;
+	const T fVb = fGb * (fFx - T(1.f)) + fGb * fFy;
+	const T fVc = fGc * fFx + fGc * (fFy - T(1.f));
+	const T fVd = fGd * (fFx - T(1.f)) + fGd * (fFy - T(1.f));
+	const T fK = fVa - fVb - fVc + fVd;
+
+	// gradient blend (both components equal) + interpolation derivative
+	const T fG = fGa + fUx * (fGb - fGa) + fUy * (fGc - fGa) + fUx * fUy * (fGa - fGb - fGc + fGd);
+	fDx = fG + fDux * (fUy * fK + fVb - fVa);
+	fDy = fG + fDuy * (fUx * fK + fVc - fVa);
+	return fVa + fUx * (fVb - fVa) + fUy * (fVc - fVa) + fUx * fUy * fK;
+}
+
+/// <summary>
+/// Fractional Brownian Motion of OCT octaves, fH - the Hurst Exponent, last octave weighted by fLast
+/// (fbm_N() in fbm.hlsli)
+/// </summary>
+template <int OCT, typename T>
+inline T FbmN(T fX, T fY, float fH, float fLast = 1.f)
+{
+	static_assert(OCT >= 1 && OCT <= FBM_OCTAVES, "FbmN : octave count out of range");
+	const float fG = std::exp2(-fH);
+	float fF = 1.f, fA = 1.f;
+	T fT = T(0.f);
+	for (int nI = 0; nI < OCT; nI++)
+	{
+		const float fW = (nI == OCT - 1) ? fA * fLast : fA;
+		fT = fT + T(fW) * FbmNoised(T(fF) * fX, T(fF) * fY);
+		fF *= 2.f;
+		fA *= fG;
+	}
+	return fT;
+}
+
+/// <summary>Fractional Brownian Motion, fH - the Hurst Exponent (fbm() in fbm.hlsli)</summary>
+template <typename T>
+inline T Fbm(T fX, T fY, float fH) { return FbmN<FBM_OCTAVES>(fX, fY, fH); }
+
+/// <summary>fbm of OCT octaves and its analytic derivatives d/dx, d/dy (fbm_der_N() in fbm.hlsli), equals FbmN()</summary>
+template <int OCT, typename T>
+inline T FbmDerN(T fX, T fY, float fH, T& fDx, T& fDy, float fLast = 1.f)
+{
+	static_assert(OCT >= 1 && OCT <= FBM_OCTAVES, "FbmDerN : octave count out of range");
+	const float fG = std::exp2(-fH);
+	float fF = 1.f, fA = 1.f;
+	T fT = T(0.f);
+	fDx = fDy = T(0.f);
+	for (int nI = 0; nI < OCT; nI++)
+	{
+		// octave a * noise(f * x) : derivative a * f * noise'(f * x)
+		const float fW = (nI == OCT - 1) ? fA * fLast : fA;
+		T fNx, fNy;
+		const T fN = FbmNoisedDer(T(fF) * fX, T(fF) * fY, fNx, fNy);
+		fT = fT + T(fW) * fN;
+		fDx = fDx + T(fW * fF) * fNx;
+		fDy = fDy + T(fW * fF) * fNy;
+		fF *= 2.f;
+		fA *= fG;
+	}
+	return fT;
+}
+
+/// <summary>fbm and its analytic derivatives d/dx, d/dy (fbm_der() in fbm.hlsli), equals Fbm()</summary>
+template <typename T>
+inline T FbmDer(T fX, T fY, float fH, T& fDx, T& fDy) { return FbmDerN<FBM_OCTAVES>(fX, fY, fH, fDx, fDy); }
+
+/// <summary>pixel angle (pixel size at distance 1) of a vertical field of view and viewport height</summary>
+inline float FbmPixelAngle(float fFovY, float fViewportH) { return 2.f * std::tan(fFovY * .5f) / fViewportH; }
+
+/// <summary>
+/// octave count for a pixel footprint (world size of a pixel, distance * FbmPixelAngle()) at the fbm
+/// coordinate scale fFbmScale (fbm_octaves() in fbm.hlsli) : octave k has a lattice cell of
+/// 1 / (fFbmScale 2^k) world units and is kept while the cell spans fCellPixels pixels or more,
+/// fractional (the last octave fades in), clamped to [1, FBM_OCTAVES]
+/// </summary>
+inline float FbmOctaves(float fFootprint, float fFbmScale, float fCellPixels = 2.f)
+{
+	if (!(fFootprint > 0.f)) return (float)FBM_OCTAVES;
+	// 1 / (s 2^k) >= c w  <=>  k <= -log2(s c w)
+	const float fK = -std::log2(fFbmScale * fCellPixels * fFootprint);
+	return (std::min)((std::max)(fK + 1.f, 1.f), (float)FBM_OCTAVES);
+}
+
+/// <summary>octave count at a ray distance</summary>
+inline float FbmOctavesAt(float fDistance, float fPixelAngle, float fFbmScale, float fCellPixels = 2.f)
+{
+	return FbmOctaves(fDistance * fPixelAngle, fFbmScale, fCellPixels);
+}
+
+/// <summary>
+/// octave count of a tile ring (tile corner radius fTileSz) seen from the eye height fEyeY above the
+/// center tile : nearest distance of the ring, (ring - 1/2) sqrt(3) tile size horizontally
+/// </summary>
+inline float FbmOctavesRing(unsigned uRing, float fTileSz, float fEyeY, float fPixelAngle, float fFbmScale, float fCellPixels = 2.f)
+{
+	const float fR = (std::max)((float)uRing - .5f, 0.f) * 1.7320508f * fTileSz;
+	return FbmOctavesAt(std::sqrt(fR * fR + fEyeY * fEyeY), fPixelAngle, fFbmScale, fCellPixels);
+}
+
+/// <summary>
+/// split a fractional octave count to the specialisation (ceil, [1, FBM_OCTAVES]) and the weight
+/// of its last octave (fLast, 1 for integral counts)
+/// </summary>
+inline int FbmOctaveSplit(float fOctaves, float& fLast)
+{
+	const float fN = (std::min)((std::max)(std::ceil(fOctaves), 1.f), (float)FBM_OCTAVES);
+	fLast = (std::min)((std::max)(fOctaves - (fN - 1.f), 0.f), 1.f);
+	return (int)fN;
+}
+
+/// <summary>call fCall(std::integral_constant<int, N>) for the octave count nN (runtime to compile time)</summary>
+template <typename F>
+inline auto FbmOctaveSwitch(int nN, F&& fCall)
+{
+	static_assert(FBM_OCTAVES == 6, "FbmOctaveSwitch : one case per octave count");
+	switch (nN)
+	{
+	case 1: return fCall(std::integral_constant<int, 1>{});
+	case 2: return fCall(std::integral_constant<int, 2>{});
+	case 3: return fCall(std::integral_constant<int, 3>{});
+	case 4: return fCall(std::integral_constant<int, 4>{});
+	case 5: return fCall(std::integral_constant<int, 5>{});
+	default: return fCall(std::integral_constant<int, 6>{});
+	}
+}
+
+/// <summary>fbm of a fractional octave count (see FbmOctaves(), fbm_lod() in fbm.hlsli), equals Fbm() for FBM_OCTAVES</summary>
+template <typename T>
+inline T FbmLod(T fX, T fY, float fH, float fOctaves)
+{
+	float fLast;
+	const int nN = FbmOctaveSplit(fOctaves, fLast);
+	return FbmOctaveSwitch(nN, [&](auto sN) { return FbmN<decltype(sN)::value>(fX, fY, fH, fLast); });
+}
+
+/// <summary>fbm and derivatives of a fractional octave count (fbm_der_lod() in fbm.hlsli)</summary>
+template <typename T>
+inline T FbmDerLod(T fX, T fY, float fH, float fOctaves, T& fDx, T& fDy)
+{
+	float fLast;
+	const int nN = FbmOctaveSplit(fOctaves, fLast);
+	return FbmOctaveSwitch(nN, [&](auto sN) { return FbmDerN<decltype(sN)::value>(fX, fY, fH, fDx, fDy, fLast); });
+}
+
+/// <summary>
+/// bound of |Fbm()| : |noised| <= 2 (corner gradients in [-1, 1] dotted with corner vectors of length <= 2,
+/// blended convex), times the sum of the octave amplitudes
+/// </summary>
+inline float FbmBound(float fH)
+{
+	const float fG = std::exp2(-fH);
+	float fA = 1.f, fT = 0.f;
+	for (int nI = 0; nI < FBM_OCTAVES; nI++)
+	{
+		fT += fA;
+		fA *= fG;
+	}
+	return 2.f * fT;
+}
+
+/// <summary>heightmap height and normal by central differences (fbm_normal() in fbm.hlsli, 4 fbm calls)</summary>
+template <typename T>
+inline void FbmNormal(T fX, T fY, float fH, T& fTerrain, T& fNx, T& fNy, T& fNz, float fSquareHalf = .02f)
+{
+	const T fL = Fbm(fX + T(fSquareHalf), fY, fH);
+	const T fR = Fbm(fX - T(fSquareHalf), fY, fH);
+	const T fU = Fbm(fX, fY + T(fSquareHalf), fH);
+	const T fD = Fbm(fX, fY - T(fSquareHalf), fH);
+	fTerrain = (fL + fR + fU + fD) * T(.25f);
+
+	// normalize(cross(tangent (2, r - l, 0), bitangent (0, d - u, 2)))
+	const T fCx = T(2.f) * (fR - fL), fCy = T(-4.f), fCz = T(2.f) * (fD - fU);
+	const T fLenInv = T(1.f) / FbmSqrt(fCx * fCx + fCy * fCy + fCz * fCz);
+	fNx = fCx * fLenInv;
+	fNy = fCy * fLenInv;
+	fNz = fCz * fLenInv;
+}
+inline void FbmNormal(float fX, float fY, float fH, float& fTerrain, float3& sNormal, float fSquareHalf = .02f)
+{
+	FbmNormal(fX, fY, fH, fTerrain, sNormal.x, sNormal.y, sNormal.z, fSquareHalf);
+}
+
+/// <summary>
+/// heightmap height and normal by analytic derivatives, one fbm_der call (fbm_normal_der() in fbm.hlsli) :
+/// the normal of FbmNormal() for fSquareHalf -> 0 at the same scale (r - l = -2s dx, d - u = -2s dy),
+/// height Fbm() at the point, optional fractional octave count (see FbmOctaves())
+/// </summary>
+template <typename T>
+inline void FbmNormalDer(T fX, T fY, float fH, T& fTerrain, T& fNx, T& fNy, T& fNz, float fSquareHalf = .02f, float fOctaves = (float)FBM_OCTAVES)
+{
+	T fDx, fDy;
+	fTerrain = FbmDerLod(fX, fY, fH, fOctaves, fDx, fDy);
+
+	// normalize(-s dx, -1, -s dy)
+	const T fCx = T(-fSquareHalf) * fDx, fCz = T(-fSquareHalf) * fDy;
+	const T fLenInv = T(1.f) / FbmSqrt(fCx * fCx + T(1.f) + fCz * fCz);
+	fNx = fCx * fLenInv;
+	fNy = T(-1.f) * fLenInv;
+	fNz = fCz * fLenInv;
+}
+inline void FbmNormalDer(float fX, float fY, float fH, float& fTerrain, float3& sNormal, float fSquareHalf = .02f, float fOctaves = (float)FBM_OCTAVES)
+{
+	FbmNormalDer(fX, fY, fH, fTerrain, sNormal.x, sNormal.y, sNormal.z, fSquareHalf, fOctaves);
+}
+
+/// <summary>simplex noise (noise_simplex() in fbm.hlsli)</summary>
+template <typename T>
+inline T FbmSimplex(T fX, T fY)
+{
+	const T fK1 = T(0.366025404f), fK2 = T(0.211324865f);
+	const T fS = (fX + fY) * fK1;
+	const T fIx = FbmFloor(fX + fS), fIy = FbmFloor(fY + fS);
+	const T fT = (fIx + fIy) * fK2;
+	const T fAx = fX - fIx + fT, fAy = fY - fIy + fT;
+	const T fM = FbmStep(fAy, fAx);
+	const T fOx = fM, fOy = T(1.f) - fM;
+	const T fBx = fAx - fOx + fK2, fBy = fAy - fOy + fK2;
+	const T fCx = fAx - T(1.f) + T(2.f) * fK2, fCy = fAy - T(1.f) + T(2.f) * fK2;
+	const T fHa = FbmMax(T(.5f) - (fAx * fAx + fAy * fAy), T(0.f));
+	const T fHb = FbmMax(T(.5f) - (fBx * fBx + fBy * fBy), T(0.f));
+	const T fHc = FbmMax(T(.5f) - (fCx * fCx + fCy * fCy), T(0.f));
+	const T fGa = FbmHash(fIx, fIy), fGb = FbmHash(fIx + fOx, fIy + fOy), fGc = FbmHash(fIx + T(1.f), fIy + T(1.f));
+	const T fNa = fHa * fHa * fHa * fHa * (fAx * fGa + fAy * fGa);
+	const T fNb = fHb * fHb * fHb * fHb * (fBx * fGb + fBy * fGb);
+	const T fNc = fHc * fHc * fHc * fHc * (fCx * fGc + fCy * fGc);
+	return fNa * T(70.f) + fNb * T(70.f) + fNc * T(70.f);
+}
+
+/// <summary>fractal simplex noise, 4 octaves, rotated (frac_noise_simplex() in fbm.hlsli)</summary>
+template <typename T>
+inline T FbmFracSimplex(T fX, T fY)
+{
+	fX = fX * T(5.f);
+	fY = fY * T(5.f);
+	T fF = T(0.f);
+	for (float fA : { .5f, .25f, .125f, .0625f })
+	{
+		fF = fF + T(fA) * FbmSimplex(fX, fY);
+		const T fXr = fX * T(1.6f) + fY * T(-1.2f);
+		fY = fX * T(1.2f) + fY * T(1.6f);
+		fX = fXr;
+	}
+	return T(.5f) + T(.5f) * fF;
+}
+
+/// <summary>load, store lanes (scalar : one lane)</summary>
+template <typename V> struct FbmLanes
+{
+	static constexpr size_t N = V::N;
+	static V Load(const float* pf) { return V::Load(pf); }
+	static void Store(float* pf, const V& sV) { sV.Store(pf); }
+};
+template <> struct FbmLanes<float>
+{
+	static constexpr size_t N = 1;
+	static float Load(const float* pf) { return *pf; }
+	static void Store(float* pf, float fV) { *pf = fV; }
+};
+
+/// <summary>
+/// run fKernel(lanes, index) over [0, uN) : blocks of V, the rest by scalar lanes (same results),
+/// lanes is FbmLanes<V> or FbmLanes<float>
+/// </summary>
+template <typename V, typename F>
+inline void FbmBatchRun(size_t uN, F&& fKernel)
+{
+	if (!uN) return;
+
+	// bounded by the remaining count (uI + N would leave the trip count unknown to the compiler)
+	size_t uI = 0;
+	for (; uN - uI >= FbmLanes<V>::N; uI += FbmLanes<V>::N) fKernel(FbmLanes<V>{}, uI);
+	for (; uI < uN; uI++) fKernel(FbmLanes<float>{}, uI);
+}
+
+/// <summary>fbm of uN points (pfX, pfY) to pfOut</summary>
+template <typename V = FbmVec>
+inline void FbmBatch(const float* pfX, const float* pfY, size_t uN, float fH, float* pfOut)
+{
+	FbmBatchRun<V>(uN, [=](auto sL, size_t uI) { sL.Store(pfOut + uI, Fbm(sL.Load(pfX + uI), sL.Load(pfY + uI), fH)); });
+}
+
+/// <summary>fbm of a fractional octave count (one for all points) of uN points, specialised once per call</summary>
+template <typename V = FbmVec>
+inline void FbmLodBatch(const float* pfX, const float* pfY, size_t uN, float fH, float fOctaves, float* pfOut)
+{
+	// split first, the kernel captures fLast by value
+	float fLast;
+	const int nN = FbmOctaveSplit(fOctaves, fLast);
+	FbmOctaveSwitch(nN, [=](auto sN)
+		{
+			FbmBatchRun<V>(uN, [=](auto sL, size_t uI) { sL.Store(pfOut + uI, FbmN<decltype(sN)::value>(sL.Load(pfX + uI), sL.Load(pfY + uI), fH, fLast)); });
+		});
+}
+
+/// <summary>fbm and derivatives of uN points</summary>
+template <typename V = FbmVec>
+inline void FbmDerBatch(const float* pfX, const float* pfY, size_t uN, float fH, float* pfOut, float* pfDx, float* pfDy)
+{
+	FbmBatchRun<V>(uN, [=](auto sL, size_t uI)
+		{
+			decltype(sL.Load(pfX)) sDx, sDy;
+			sL.Store(pfOut + uI, FbmDer(sL.Load(pfX + uI), sL.Load(pfY + uI), fH, sDx, sDy));
+			sL.Store(pfDx + uI, sDx);
+			sL.Store(pfDy + uI, sDy);
+		});
+}
+
+/// <summary>heightmap height and normal of uN points</summary>
+template <typename V = FbmVec>
+inline void FbmNormalBatch(const float* pfX, const float* pfY, size_t uN, float fH, float* pfTerrain, float* pfNx, float* pfNy, float* pfNz, float fSquareHalf = .02f)
+{
+	FbmBatchRun<V>(uN, [=](auto sL, size_t uI)
+		{
+			decltype(sL.Load(pfX)) sT, sNx, sNy, sNz;
+			FbmNormal(sL.Load(pfX + uI), sL.Load(pfY + uI), fH, sT, sNx, sNy, sNz, fSquareHalf);
+			sL.Store(pfTerrain + uI, sT);
+			sL.Store(pfNx + uI, sNx);
+			sL.Store(pfNy + uI, sNy);
+			sL.Store(pfNz + uI, sNz);
+		});
+}
+
+/// <summary>heightmap height and normal of uN points by analytic derivatives</summary>
+template <typename V = FbmVec>
+inline void FbmNormalDerBatch(const float* pfX, const float* pfY, size_t uN, float fH, float* pfTerrain, float* pfNx, float* pfNy, float* pfNz, float fSquareHalf = .02f)
+{
+	FbmBatchRun<V>(uN, [=](auto sL, size_t uI)
+		{
+			decltype(sL.Load(pfX)) sT, sNx, sNy, sNz;
+			FbmNormalDer(sL.Load(pfX + uI), sL.Load(pfY + uI), fH, sT, sNx, sNy, sNz, fSquareHalf);
+			sL.Store(pfTerrain + uI, sT);
+			sL.Store(pfNx + uI, sNx);
+			sL.Store(pfNy + uI, sNy);
+			sL.Store(pfNz + uI, sNz);
+		});
+}
+
+/// <summary>sin hash, integer hash of uN lattice points (both hashes, independent of FBM_HASH_INTEGER)</summary>
+template <typename V = FbmVec>
+inline void FbmHashSinBatch(const float* pfX, const float* pfY, size_t uN, float* pfOut)
+{
+	FbmBatchRun<V>(uN, [=](auto sL, size_t uI) { sL.Store(pfOut + uI, FbmHashSin(sL.Load(pfX + uI), sL.Load(pfY + uI))); });
+}
+template <typename V = FbmVec>
+inline void FbmHashIntBatch(const float* pfX, const float* pfY, size_t uN, float* pfOut)
+{
+	FbmBatchRun<V>(uN, [=](auto sL, size_t uI) { sL.Store(pfOut + uI, FbmHashInt(sL.Load(pfX + uI), sL.Load(pfY + uI))); });
+}
+
+/// <summary>simplex noise, fractal simplex noise of uN points</summary>
+template <typename V = FbmVec>
+inline void FbmSimplexBatch(const float* pfX, const float* pfY, size_t uN, float* pfOut)
+{
+	FbmBatchRun<V>(uN, [=](auto sL, size_t uI) { sL.Store(pfOut + uI, FbmSimplex(sL.Load(pfX + uI), sL.Load(pfY + uI))); });
+}
+template <typename V = FbmVec>
+inline void FbmFracSimplexBatch(const float* pfX, const float* pfY, size_t uN, float* pfOut)
+{
+	FbmBatchRun<V>(uN, [=](auto sL, size_t uI) { sL.Store(pfOut + uI, FbmFracSimplex(sL.Load(pfX + uI), sL.Load(pfY + uI))); });
+}
+
+#if defined(__clang__)
+#pragma float_control(pop)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // _ZONE_FBM
@@ -0,0 +1,266 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _ZONE_INDEX
+#define _ZONE_INDEX
+
+#include "zone_cull.h"
+#include <vector>
+#include <unordered_map>
+
+// Hierarchical hex index (aperture 7) :
+//
+// super hex     a hex and its 6 neighbours, the super hex centers are the lattice (2, 1), (-1, 3) (axial),
+//               determinant 7, so the super hexes tile the plane and are a hex grid again (rotated,
+//               scaled by sqrt(7)) - the next level is built the same way
+// parent        lattice coordinates of a hex (M^-1 * qr, rounded : the offsets of the 6 neighbours are
+//               below .5 in lattice coordinates, the rounding is exact)
+// bounds        circle around the node center, radius of the tile centers r(0) = 0,
+//               r(k + 1) = r(k) + sqrt(3) * sqrt(7)^k (tile size 1), plus the tile corner radius
+// nodes         pool per level, child links per slot (center, neighbours) : leaves (level 1) link the tile
+//               indices, the levels above the nodes of the level below, number of tiles below. A hash map per
+//               level (axial key) finds the node of a hex on insert/remove only, queries follow the links
+
+/// <summary>maximum number of levels (tile level included)</summary>
+constexpr unsigned HEX_INDEX_LEVEL_MAX = 12;
+
+/// <summary>center (child level) of a super hex : lattice (2, 1), (-1, 3) in axial coordinates</summary>
+constexpr HexCube HexSuperCenter(const HexCube& sP)
+{
+	const int32_t nQ = 2 * sP.nQ - sP.nR, nR = sP.nQ + 3 * sP.nR;
+	return HexCube{ nQ, nR, -nQ - nR };
+}
+
+/// <summary>super hex containing a hex (exact, see above)</summary>
+constexpr HexCube HexSuperOf(const HexCube& sC)
+{
+	// floor((2 * n + 7) / 14) : round(n / 7), n / 7 is never half
+	auto fRound7 = [](int32_t nN) { const int32_t nT = 2 * nN + 7; return (nT >= 0) ? nT / 14 : -((13 - nT) / 14); };
+	const int32_t nQ = fRound7(3 * sC.nQ + sC.nR), nR = fRound7(-sC.nQ + 2 * sC.nR);
+	return HexCube{ nQ, nR, -nQ - nR };
+}
+
+/// <summary>
+/// Hierarchical tile index : tile containing a point (hashed), tiles within a radius and tiles intersecting
+/// a frustum (descent from the top level, logarithmic in the tile number plus the output), incremental
+/// update of moved tiles (recycler output). Tile offsets as HexTilesLayout().
+/// </summary>
+class HexTilesIndex
+{
+public:
+	/// <summary>init by the tile positions [0, uInstN), tile size</summary>
+	template <typename T4>
+	void Init(const std::vector<T4>& asTilePos, unsigned uInstN, float fTileSz = 1.f)
+	{
+		uInstN = (unsigned)(std::min)((size_t)uInstN, asTilePos.size());
+		m_fTileSz = fTileSz;
+
+		// levels : top level of a few nodes, at least the leaves (level 1)
+		m_uLevelN = 2;
+		for (uint64_t uN = 7; (uN < uInstN) && (m_uLevelN < HEX_INDEX_LEVEL_MAX); uN *= 7) m_uLevelN++;
+		float fStep = HexConst<float>::fSqrt3 * fTileSz;
+		m_afRadius[0] = 0.f;
+		for (unsigned uL(1); uL < m_uLevelN; uL++)
+		{
+			m_afRadius[uL] = m_afRadius[uL - 1] + fStep;
+			fStep *= 2.645751311f;
+		}
+
+		// nodes
+		for (unsigned uL(1), uN(uInstN / 7 + 8); uL < HEX_INDEX_LEVEL_MAX; uL++, uN = uN / 7 + 8)
+		{
+			m_acNode[uL].clear();
+			m_aasNode[uL].clear();
+			m_aauFree[uL].clear();
+			if (uL < m_uLevelN) { m_acNode[uL].reserve(uN); m_aasNode[uL].reserve(uN); }
+		}
+		m_asTile.assign(uInstN, HexCube{});
+		for (unsigned uI(0); uI < uInstN; uI++)
+			Insert(uI, HexCubeAt(asTilePos[uI].x, asTilePos[uI].y, m_fTileSz));
+	}
+
+	/// <summary>move the updated tiles (xy - offset, z - tile index) from index uFirst on</summary>
+	template <typename T4>
+	void Update(const std::vector<T4>& asUpdate, size_t uFirst = 0)
+	{
+		for (size_t uU(uFirst); uU < asUpdate.size(); uU++)
+		{
+			const unsigned uIx = (unsigned)asUpdate[uU].z;
+			if (uIx >= m_asTile.size()) continue;
+			const HexCube sC = HexCubeAt(asUpdate[uU].x, asUpdate[uU].y, m_fTileSz);
+			if (sC == m_asTile[uIx]) continue;
+			Remove(uIx);
+			Insert(uIx, sC);
+		}
+	}
+
+	/// <summary>tile containing a point (~0u : none)</summary>
+	unsigned At(float fX, float fY) const
+	{
+		const HexCube sC = HexCubeAt(fX, fY, m_fTileSz), sP = HexSuperOf(sC);
+		const auto sIt = m_acNode[1].find(HexCubeKey(sP));
+		return (sIt != m_acNode[1].end()) ? m_aasNode[1][sIt->second].auChild[Slot(sC, sP)] : ~0u;
+	}
+
+	/// <summary>tiles with the center within a radius around xy, appended to auOut</summary>
+	void Radius(float fX, float fY, float fRadius, std::vector<uint32_t>& auOut) const
+	{
+		Query([this, fX, fY, fRadius](unsigned uL, const HexVec<float>& sXY)
+			{
+				const float fDx = sXY.x - fX, fDy = sXY.y - fY, fD = std::sqrt(fDx * fDx + fDy * fDy);
+				if (fD > fRadius + m_afRadius[uL]) return 0;
+				return (fD + m_afRadius[uL] <= fRadius) ? 2 : 1;
+			}, auOut);
+	}
+
+	/// <summary>tiles intersecting the frustum (tile box : height center fY, extent fEy, as HexTilesCuller), appended to auOut</summary>
+	void Frustum(const HexCullFrustum& asPlanes, float fY, float fEy, std::vector<uint32_t>& auOut) const
+	{
+		const float3 sTile = { HexConst<float>::fHalfSqrt3 * m_fTileSz, fEy, m_fTileSz };
+		Query([&](unsigned uL, const HexVec<float>& sXY)
+			{
+				// node : outside by its box, inside if all tile boxes below pass (not the node box)
+				const float3 sC = { sXY.x, fY, sXY.y };
+				if (!uL) return HexCullBox(asPlanes, sC, sTile) ? 1 : 0;
+				if (!HexCullBox(asPlanes, sC, float3{ m_afRadius[uL] + m_fTileSz, fEy, m_afRadius[uL] + m_fTileSz })) return 0;
+				return HexCullBoxesInside(asPlanes, sC, m_afRadius[uL], sTile) ? 2 : 1;
+			}, auOut);
+	}
+
+	/// <summary>number of levels, nodes at a level</summary>
+	unsigned Levels_N() const { return m_uLevelN; }
+	size_t Nodes_N(unsigned uLevel) const { return uLevel ? m_acNode[uLevel].size() : m_asTile.size(); }
+
+private:
+	/// <summary>node : children (super hex center, neighbours 0..5, ~0u : empty), number of tiles below (0 : free), center xy</summary>
+	struct Node
+	{
+		std::array<uint32_t, 7> auChild;
+		uint32_t uTileN;
+		HexVec<float> sXY;
+	};
+
+	/// <summary>slot of a hex in its super hex sP</summary>
+	static unsigned Slot(const HexCube& sC, const HexCube& sP)
+	{
+		const HexCube sD = sC - HexSuperCenter(sP);
+		for (unsigned uD(0); uD < 6; uD++)
+			if (sD == s_asHexDirections[uD]) return uD + 1;
+		return 0;
+	}
+
+	/// <summary>add a tile to its leaf, count it on the levels above, new nodes are linked to their parent</summary>
+	void Insert(unsigned uIx, const HexCube& sC)
+	{
+		m_asTile[uIx] = sC;
+		HexCube sH = sC;
+		uint32_t uChild = uIx;
+		for (unsigned uL(1); uL < m_uLevelN; uL++)
+		{
+			const HexCube sP = HexSuperOf(sH);
+			const auto sIns = m_acNode[uL].try_emplace(HexCubeKey(sP), 0u);
+			if (sIns.second) sIns.first->second = NodeNew(uL, sP);
+			Node& sN = m_aasNode[uL][sIns.first->second];
+			sN.auChild[Slot(sH, sP)] = uChild;
+			sN.uTileN++;
+			uChild = sIns.first->second;
+			sH = sP;
+		}
+	}
+	/// <summary>remove a tile, nodes without tiles are unlinked and freed</summary>
+	void Remove(unsigned uIx)
+	{
+		HexCube sH = m_asTile[uIx];
+		bool bUnlink = true;
+		for (unsigned uL(1); uL < m_uLevelN; uL++)
+		{
+			const HexCube sP = HexSuperOf(sH);
+			const auto sIt = m_acNode[uL].find(HexCubeKey(sP));
+			if (sIt == m_acNode[uL].end()) return;
+			Node& sN = m_aasNode[uL][sIt->second];
+			const unsigned uSlot = Slot(sH, sP);
+			if ((uL == 1) && (sN.auChild[uSlot] != uIx)) return;
+			if (bUnlink) sN.auChild[uSlot] = ~0u;
+			bUnlink = !--sN.uTileN;
+			if (bUnlink)
+			{
+				m_aauFree[uL].push_back(sIt->second);
+				m_acNode[uL].erase(sIt);
+			}
+			sH = sP;
+		}
+	}
+	/// <summary>new node (free list first), children empty</summary>
+	uint32_t NodeNew(unsigned uLevel, const HexCube& sC)
+	{
+		const Node sN = { { ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u }, 0, HexCubeToXY<float>(Center(uLevel, sC), m_fTileSz) };
+		if (m_aauFree[uLevel].empty())
+		{
+			m_aasNode[uLevel].push_back(sN);
+			return (uint32_t)m_aasNode[uLevel].size() - 1;
+		}
+		const uint32_t uN = m_aauFree[uLevel].back();
+		m_aauFree[uLevel].pop_back();
+		m_aasNode[uLevel][uN] = sN;
+		return uN;
+	}
+
+	/// <summary>center of a node (level 0 coordinates)</summary>
+	static HexCube Center(unsigned uLevel, HexCube sC)
+	{
+		for (unsigned uL(0); uL < uLevel; uL++) sC = HexSuperCenter(sC);
+		return sC;
+	}
+
+	/// <summary>
+	/// descent from the top level along the child links, fTest(level, node center xy) : 0 - outside,
+	/// 1 - partial, 2 - inside (all tiles below are added without further tests)
+	/// </summary>
+	template <typename F>
+	void Query(F&& fTest, std::vector<uint32_t>& auOut) const
+	{
+		const unsigned uTop = m_uLevelN - 1;
+		for (const Node& sN : m_aasNode[uTop])
+			if (sN.uTileN) Visit(uTop, sN, fTest, auOut);
+	}
+	template <typename F>
+	void Visit(unsigned uLevel, const Node& sN, F& fTest, std::vector<uint32_t>& auOut) const
+	{
+		const int nR = fTest(uLevel, sN.sXY);
+		if (!nR) return;
+		if (nR == 2) { Emit(uLevel, sN, auOut); return; }
+
+		// partial : test the children
+		for (const uint32_t uC : sN.auChild)
+		{
+			if (uC == ~0u) continue;
+			if (uLevel > 1) Visit(uLevel - 1, m_aasNode[uLevel - 1][uC], fTest, auOut);
+			else if (fTest(0, HexCubeToXY<float>(m_asTile[uC], m_fTileSz))) auOut.push_back(uC);
+		}
+	}
+	/// <summary>add all tiles below a node</summary>
+	void Emit(unsigned uLevel, const Node& sN, std::vector<uint32_t>& auOut) const
+	{
+		for (const uint32_t uC : sN.auChild)
+		{
+			if (uC == ~0u) continue;
+			if (uLevel > 1) Emit(uLevel - 1, m_aasNode[uLevel - 1][uC], auOut);
+			else auOut.push_back(uC);
+		}
+	}
+
+	/// <summary>tile size, number of levels, node center radius per level</summary>
+	float m_fTileSz = 1.f;
+	unsigned m_uLevelN = 2;
+	std::array<float, HEX_INDEX_LEVEL_MAX> m_afRadius = {};
+	/// <summary>nodes per level (1 and above) : node pool, free nodes, node by hex key (insert/remove, At())</summary>
+	std::array<std::vector<Node>, HEX_INDEX_LEVEL_MAX> m_aasNode;
+	std::array<std::vector<uint32_t>, HEX_INDEX_LEVEL_MAX> m_aauFree;
+	std::array<std::unordered_map<uint64_t, uint32_t, HexKeyHash>, HEX_INDEX_LEVEL_MAX> m_acNode;
+	/// <summary>hex per tile</summary>
+	std::vector<HexCube> m_asTile;
+};
+
+#endif // _ZONE_INDEX
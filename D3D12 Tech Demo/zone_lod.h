@@ -0,0 +1,88 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _ZONE_LOD
+#define _ZONE_LOD
+
+#include "zone_mesh.h"
+#include <vector>
+#include <array>
+
+// Level of detail for the hex tile rings :
+//
+// tile level L   hexagon subdivided L times (HexMeshTile() in zone_mesh.h), n = 2^L triangles per side,
+//                3n^2 + 3n + 1 vertices, 6n^2 triangles (level 1 equals the demo base tile)
+// lod bands      rings [0, R) at level max, rings [R * 2^(k-1), R * 2^k) at level max - k,
+//                neighbour tiles differ by one level at most
+// skirts         each border edge gets a vertical quad (6n vertices, 12n triangles, HexMeshTile() skirt)
+//                to hide the T-junction cracks between levels
+//
+// The plan reports vertex and triangle counts per band, the demo draws one uniform level.
+
+/// <summary>lod plan for the hex tile rings</summary>
+struct HexLodPlan
+{
+	/// <summary>number of ambits (rings around the center tile)</summary>
+	unsigned uAmbitN;
+	/// <summary>level of the center band, number of rings in the center band (R)</summary>
+	unsigned uLevelMax, uRingsMax;
+	/// <summary>skirts on all tiles</summary>
+	bool bSkirt;
+};
+
+/// <summary>tile level of a ring</summary>
+inline unsigned HexLodLevel(const HexLodPlan& sPlan, unsigned uRing)
+{
+	unsigned uBand = 0;
+	for (uint64_t uR = sPlan.uRingsMax; uRing >= uR; uR *= 2) uBand++;
+	return sPlan.uLevelMax - (std::min)(uBand, sPlan.uLevelMax);
+}
+
+/// <summary>lod report : tiles, vertices, triangles per level and in total</summary>
+struct HexLodReport
+{
+	std::array<uint64_t, HEX_MESH_LEVEL_MAX + 1> auTileN, auVtcN, auTriN;
+	uint64_t uTileN, uVtcN, uTriN;
+};
+
+/// <summary>count tiles, vertices and triangles of a plan</summary>
+inline HexLodReport HexLodCount(const HexLodPlan& sPlan)
+{
+	HexLodReport sReport = {};
+	for (unsigned uRing(0); uRing <= sPlan.uAmbitN; uRing++)
+	{
+		const unsigned uLevel = HexLodLevel(sPlan, uRing);
+		const uint64_t uTileN = uRing ? 6ull * uRing : 1ull;
+		sReport.auTileN[uLevel] += uTileN;
+		sReport.auVtcN[uLevel] += uTileN * HexMeshVtcN(uLevel, sPlan.bSkirt);
+		sReport.auTriN[uLevel] += uTileN * HexMeshTriN(uLevel, sPlan.bSkirt);
+	}
+	for (unsigned uL(0); uL <= HEX_MESH_LEVEL_MAX; uL++)
+	{
+		sReport.uTileN += sReport.auTileN[uL];
+		sReport.uVtcN += sReport.auVtcN[uL];
+		sReport.uTriN += sReport.auTriN[uL];
+	}
+	return sReport;
+}
+
+/// <summary>
+/// Lod plan for a triangle budget : the widest center band (level uLevelMax) that keeps the
+/// total triangle count within uTriBudget (center band at least the center tile)
+/// </summary>
+inline HexLodPlan HexLodPlanFor(unsigned uAmbitN, unsigned uLevelMax, uint64_t uTriBudget, bool bSkirt)
+{
+	HexLodPlan sPlan = { uAmbitN, (std::min)(uLevelMax, HEX_MESH_LEVEL_MAX), 1, bSkirt };
+	for (unsigned uR = 2; uR <= uAmbitN + 1; uR++)
+	{
+		HexLodPlan sNext = sPlan;
+		sNext.uRingsMax = uR;
+		if (HexLodCount(sNext).uTriN > uTriBudget) break;
+		sPlan = sNext;
+	}
+	return sPlan;
+}
+
+#endif // _ZONE_LOD
@@ -0,0 +1,140 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _ZONE_MESH
+#define _ZONE_MESH
+
+#include "hex.h"
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include <unordered_map>
+
+// Hex tile mesh (corner radius 1, pointy top in xz) :
+//
+// base           center + 6 corners, 6 triangles (one per side), y - normalized distance to the
+//                center (0 center, 1 rim)
+// subdivision    each pass splits each triangle at its edge midpoints to 4 triangles, level L has
+//                6 * 4^L triangles and 3n^2 + 3n + 1 vertices (n = 2^L), level 1 is the demo base tile
+// welding        vertices are welded by a hash map keyed on the quantized position, indices
+//                are appended (no search, no front inserts)
+// skirt          optional, each rim edge gets a vertical quad down to y = -1 (6n vertices, 12n triangles)
+//                to hide the T-junction cracks between tiles of different levels (see zone_lod.h), the
+//                vertex codec (mesh_vertex.h) keeps the skirt flag, the vertex shader lowers it below the terrain
+
+/// <summary>maximum subdivision level (393216 triangles, 197377 vertices)</summary>
+constexpr unsigned HEX_MESH_LEVEL_MAX = 8;
+
+/// <summary>
+/// Vertex welder : provides the index of a position, adds the position if new.
+/// Positions are quantized to 2^-18 (21 bits per axis, range -4..4), the key packs the 3 axes.
+/// </summary>
+template <typename T3>
+class HexMeshWelder
+{
+public:
+	HexMeshWelder(std::vector<T3>& asVtc, size_t uVtcExpectedN) : m_asVtc(asVtc)
+	{
+		m_cIndex.reserve(uVtcExpectedN);
+		for (uint32_t uI(0); uI < (uint32_t)asVtc.size(); uI++)
+			m_cIndex.emplace(Key(asVtc[uI]), uI);
+	}
+
+	/// <summary>index of the position (added if new)</summary>
+	uint32_t Weld(const T3& sV)
+	{
+		auto sIt = m_cIndex.emplace(Key(sV), (uint32_t)m_asVtc.size());
+		if (sIt.second) m_asVtc.push_back(sV);
+		return sIt.first->second;
+	}
+
+	/// <summary>quantized position key</summary>
+	static uint64_t Key(const T3& sV)
+	{
+		auto fQ = [](float fV) { return (uint64_t)(int64_t)std::lround(((double)fV + 4.) * 262144.) & 0x1fffff; };
+		return (fQ(sV.x) << 42) | (fQ(sV.y) << 21) | fQ(sV.z);
+	}
+
+private:
+	std::vector<T3>& m_asVtc;
+	std::unordered_map<uint64_t, uint32_t, HexKeyHash> m_cIndex;
+};
+
+/// <summary>number of vertices, triangles of a hex tile mesh at a subdivision level (skirt optional)</summary>
+constexpr uint64_t HexMeshVtcN(unsigned uLevel, bool bSkirt = false) { return HexRingFirst((1ull << uLevel) + 1) + (bSkirt ? 6ull << uLevel : 0); }
+constexpr uint64_t HexMeshTriN(unsigned uLevel, bool bSkirt = false) { return (6ull << (2 * uLevel)) + (bSkirt ? 12ull << uLevel : 0); }
+
+/// <summary>
+/// Create a hex tile mesh subdivided uLevel times (clamped to HEX_MESH_LEVEL_MAX), vertices xz - position,
+/// y - normalized distance to the center, -1 for skirt vertices. Triangles are wound as the base hexagon, a split
+/// triangle (a, b, c) with edge midpoints ab, bc, ca gives (a, ab, ca), (ab, b, bc), (ca, bc, c), (ab, bc, ca).
+/// </summary>
+template <typename T3>
+void HexMeshTile(unsigned uLevel, std::vector<T3>& asVtc, std::vector<uint32_t>& auIdc, bool bSkirt = false)
+{
+	uLevel = (std::min)(uLevel, HEX_MESH_LEVEL_MAX);
+	const float fHalfW = HexConst<float>::fHalfSqrt3;
+	asVtc.assign({
+		T3{ 0.0f, 0.0f,  0.0f }, // center
+		T3{ 0.0f, 1.0f, -1.0f }, // top
+		T3{ fHalfW, 1.0f, -0.5f }, // top right
+		T3{ fHalfW, 1.0f,  0.5f }, // bottom right
+		T3{ 0.0f, 1.0f,  1.0f }, // bottom
+		T3{ -fHalfW, 1.0f,  0.5f }, // bottom left
+		T3{ -fHalfW, 1.0f, -0.5f }, // top left
+		});
+	auIdc.assign({ 1, 0, 2, 2, 0, 3, 3, 0, 4, 4, 0, 5, 5, 0, 6, 6, 0, 1 });
+	asVtc.reserve(HexMeshVtcN(uLevel, bSkirt));
+
+	HexMeshWelder<T3> cWelder(asVtc, HexMeshVtcN(uLevel));
+	std::vector<uint32_t> auNext;
+	for (unsigned uL(0); uL < uLevel; uL++)
+	{
+		auNext.clear();
+		auNext.reserve(auIdc.size() * 4);
+		for (size_t uT(0); uT < auIdc.size(); uT += 3)
+		{
+			const uint32_t uA = auIdc[uT], uB = auIdc[uT + 1], uC = auIdc[uT + 2];
+			auto fMid = [&](uint32_t uP, uint32_t uQ)
+			{
+				const T3 sP = asVtc[uP], sQ = asVtc[uQ];
+				return cWelder.Weld(T3{ .5f * (sP.x + sQ.x), .5f * (sP.y + sQ.y), .5f * (sP.z + sQ.z) });
+			};
+			const uint32_t uAB = fMid(uA, uB), uBC = fMid(uB, uC), uCA = fMid(uC, uA);
+			auNext.insert(auNext.end(), { uA, uAB, uCA, uAB, uB, uBC, uCA, uBC, uC, uAB, uBC, uCA });
+		}
+		auIdc.swap(auNext);
+	}
+
+	// skirt : rim edges (both ends at y = 1) belong to one triangle each, the quad is wound against
+	// the edge of its triangle (p, q) as the neighbour would be : (q, p, p'), (q, p', q')
+	if (bSkirt)
+	{
+		std::vector<uint32_t> auSkirt(asVtc.size(), ~0u);
+		auto fSkirt = [&](uint32_t uV)
+		{
+			if (auSkirt[uV] == ~0u)
+			{
+				const T3 sV = asVtc[uV];
+				auSkirt[uV] = (uint32_t)asVtc.size();
+				asVtc.push_back(T3{ sV.x, -1.f, sV.z });
+			}
+			return auSkirt[uV];
+		};
+		auIdc.reserve(HexMeshTriN(uLevel, true) * 3);
+		const size_t uIdcN = auIdc.size();
+		for (size_t uT(0); uT < uIdcN; uT += 3)
+			for (unsigned uE(0); uE < 3; uE++)
+			{
+				const uint32_t uP = auIdc[uT + uE], uQ = auIdc[uT + (uE + 1) % 3];
+				if ((asVtc[uP].y != 1.f) || (asVtc[uQ].y != 1.f)) continue;
+				const uint32_t uSp = fSkirt(uP), uSq = fSkirt(uQ);
+				auIdc.insert(auIdc.end(), { uQ, uP, uSp, uQ, uSp, uSq });
+			}
+	}
+}
+
+#endif // _ZONE_MESH
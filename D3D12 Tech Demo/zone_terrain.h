@@ -0,0 +1,174 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _ZONE_TERRAIN
+#define _ZONE_TERRAIN
+
+#include "zone_tiles.h"
+#include "zone_fbm.h"
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+
+/// <summary>
+/// Tile terrain on CPU : height and normal (float4 : height, normal xyz) per base tile vertex for
+/// each tile, generated when a tile is placed (fbm port, parallel on the job workers) and cached
+/// by the axial coordinate of the tile in an LRU, so revisited tiles are copied only.
+/// Same terrain as the vertex shader : fbm_normal_der(xz * fFbmScale, fH) * (1, fHeightScale).
+/// </summary>
+class HexTileTerrain
+{
+public:
+	/// <summary>
+	/// init by the base tile local positions xz (asBaseXZ), number of tiles and cache size in tiles
+	/// (at least uInstN, a far jump places all tiles at once)
+	/// </summary>
+	void Init(const std::vector<float2>& asBaseXZ, unsigned uInstN, unsigned uCacheN, float fFbmScale = .05f, float fHeightScale = 10.f, float fH = 1.f)
+	{
+		m_asBaseXZ = asBaseXZ;
+		m_uVtcN = (unsigned)asBaseXZ.size();
+		m_uInstN = uInstN;
+		m_uCacheN = (std::max)(uCacheN, uInstN);
+		m_fFbmScale = fFbmScale;
+		m_fHeightScale = fHeightScale;
+		m_fH = fH;
+
+		m_asTile.assign((size_t)m_uInstN * m_uVtcN, float4{ 0.f, 0.f, -1.f, 0.f });
+		m_asCache.assign((size_t)m_uCacheN * m_uVtcN, float4{});
+		m_auKey.assign(m_uCacheN, 0);
+		m_abUsed.assign(m_uCacheN, 0);
+		m_auPrev.resize(m_uCacheN);
+		m_auNext.resize(m_uCacheN);
+		for (unsigned uS(0); uS < m_uCacheN; uS++)
+		{
+			m_auPrev[uS] = uS ? uS - 1 : s_uNone;
+			m_auNext[uS] = (uS + 1 < m_uCacheN) ? uS + 1 : s_uNone;
+		}
+		m_uHead = 0;
+		m_uTail = m_uCacheN - 1;
+		m_cSlot.clear();
+		m_cSlot.reserve(m_uCacheN);
+		m_uFbmN = m_uHitN = m_uMissN = 0;
+	}
+
+	/// <summary>
+	/// Generate the terrain of the update tiles from uFirst on (xy - offset, z - tile index, as the
+	/// recyclers append), cached tiles are copied. Returns the number of generated (not cached) tiles.
+	/// </summary>
+	template <typename T4>
+	unsigned Update(const std::vector<T4>& asUpdate, App_Jobsystem& cJobs, size_t uFirst = 0)
+	{
+		// look up, assign least recently used slots to the misses
+		m_asJob.clear();
+		m_asMiss.clear();
+		for (size_t uU = uFirst; uU < asUpdate.size(); uU++)
+		{
+			const T4& sTile = asUpdate[uU];
+			const unsigned uIx = (unsigned)sTile.z;
+			if (uIx >= m_uInstN) continue;
+			const HexCube sC = HexCubeAt(sTile.x, sTile.y);
+			const uint64_t uKey = HexCubeKey(sC);
+			auto sIt = m_cSlot.find(uKey);
+			uint32_t uSlot;
+			if (sIt != m_cSlot.end())
+			{
+				uSlot = sIt->second;
+				m_uHitN++;
+			}
+			else
+			{
+				uSlot = m_uTail;
+				if (m_abUsed[uSlot]) m_cSlot.erase(m_auKey[uSlot]);
+				m_auKey[uSlot] = uKey;
+				m_abUsed[uSlot] = 1;
+				m_cSlot.emplace(uKey, uSlot);
+				m_asMiss.push_back(Miss{ uSlot, sTile.x, sTile.y });
+				m_uMissN++;
+			}
+			Touch(uSlot);
+			m_asJob.push_back(Job{ uIx, uSlot });
+		}
+
+		// generate the misses in parallel
+		cJobs.ParallelFor(0, m_asMiss.size(), 4, [&](size_t uB, size_t uE)
+			{
+				for (size_t uM = uB; uM < uE; uM++)
+					Generate(m_asMiss[uM].fX, m_asMiss[uM].fY, &m_asCache[(size_t)m_asMiss[uM].uSlot * m_uVtcN]);
+			});
+		m_uFbmN += (uint64_t)m_asMiss.size() * m_uVtcN;
+
+		// copy to the tiles
+		for (const Job& sJob : m_asJob)
+			std::memcpy(&m_asTile[(size_t)sJob.uTile * m_uVtcN], &m_asCache[(size_t)sJob.uSlot * m_uVtcN], m_uVtcN * sizeof(float4));
+		return (unsigned)m_asMiss.size();
+	}
+
+	/// <summary>generate the terrain of a tile at offset xy (uVtcN float4 to pasOut), in blocks of FbmNormalDerBatch()</summary>
+	void Generate(float fX, float fY, float4* pasOut) const
+	{
+		constexpr unsigned uBlockN = 64;
+		float afX[uBlockN], afY[uBlockN], afT[uBlockN], afNx[uBlockN], afNy[uBlockN], afNz[uBlockN];
+		for (unsigned uV0(0); uV0 < m_uVtcN; uV0 += uBlockN)
+		{
+			const unsigned uN = (std::min)(uBlockN, m_uVtcN - uV0);
+			for (unsigned uV(0); uV < uN; uV++)
+			{
+				afX[uV] = (fX + m_asBaseXZ[uV0 + uV].x) * m_fFbmScale;
+				afY[uV] = (fY + m_asBaseXZ[uV0 + uV].y) * m_fFbmScale;
+			}
+			FbmNormalDerBatch(afX, afY, uN, m_fH, afT, afNx, afNy, afNz);
+			for (unsigned uV(0); uV < uN; uV++)
+				pasOut[uV0 + uV] = float4{ afT[uV] * m_fHeightScale, afNx[uV], afNy[uV], afNz[uV] };
+		}
+	}
+
+	/// <summary>terrain of a tile (uVtcN float4), of all tiles</summary>
+	const float4* Tile(unsigned uIx) const { return &m_asTile[(size_t)uIx * m_uVtcN]; }
+	const std::vector<float4>& Tiles() const { return m_asTile; }
+	/// <summary>vertices per tile</summary>
+	unsigned Vertices_N() const { return m_uVtcN; }
+	/// <summary>statistics : fbm evaluations (fbm_der, one per vertex), cache hits and misses (tiles) since init</summary>
+	uint64_t Fbm_N() const { return m_uFbmN; }
+	uint64_t Hits_N() const { return m_uHitN; }
+	uint64_t Misses_N() const { return m_uMissN; }
+
+private:
+	/// <summary>move a slot to the front (most recently used)</summary>
+	void Touch(uint32_t uSlot)
+	{
+		if (uSlot == m_uHead) return;
+		m_auNext[m_auPrev[uSlot]] = m_auNext[uSlot];
+		if (m_auNext[uSlot] != s_uNone) m_auPrev[m_auNext[uSlot]] = m_auPrev[uSlot]; else m_uTail = m_auPrev[uSlot];
+		m_auPrev[uSlot] = s_uNone;
+		m_auNext[uSlot] = m_uHead;
+		m_auPrev[m_uHead] = uSlot;
+		m_uHead = uSlot;
+	}
+
+	struct Job { uint32_t uTile, uSlot; };
+	struct Miss { uint32_t uSlot; float fX, fY; };
+	static constexpr uint32_t s_uNone = 0xffffffff;
+
+	/// <summary>base tile positions, vertices per tile, number of tiles, cache size (tiles)</summary>
+	std::vector<float2> m_asBaseXZ;
+	unsigned m_uVtcN = 0, m_uInstN = 0, m_uCacheN = 0;
+	/// <summary>terrain parameters</summary>
+	float m_fFbmScale = .05f, m_fHeightScale = 10.f, m_fH = 1.f;
+	/// <summary>terrain by tile index, by cache slot</summary>
+	std::vector<float4> m_asTile, m_asCache;
+	/// <summary>lru : slot by axial key, key by slot, slot list (head most recent)</summary>
+	std::unordered_map<uint64_t, uint32_t, HexKeyHash> m_cSlot;
+	std::vector<uint64_t> m_auKey;
+	std::vector<uint8_t> m_abUsed;
+	std::vector<uint32_t> m_auPrev, m_auNext;
+	uint32_t m_uHead = 0, m_uTail = 0;
+	/// <summary>current update</summary>
+	std::vector<Job> m_asJob;
+	std::vector<Miss> m_asMiss;
+	/// <summary>statistics</summary>
+	uint64_t m_uFbmN = 0, m_uHitN = 0, m_uMissN = 0;
+};
+
+#endif // _ZONE_TERRAIN
@@ -0,0 +1,294 @@
+// D3D12 Tech Demo
+// Copyright  2022 by Denis Reischl
+// 
+// SPDX-License-Identifier: MIT
+
+#ifndef _ZONE_TILES
+#define _ZONE_TILES
+
+#include "app.h"
+#include "hex.h"
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+/// <summary>number of hex tiles for a number of ambits (or "circles") around the main hexagon</summary>
+constexpr unsigned HexTilesN(unsigned uAmbitN) { return 1 + 3 * uAmbitN * (uAmbitN + 1); }
+
+/// <summary>provide vector to neighbour tile (index 0..5, s_asHexNext in hex.h)</summary>
+inline float2 HexTilesNext(float fSize, unsigned uI) { return float2{ fSize * s_asHexNext<float>[uI % 6].x, fSize * s_asHexNext<float>[uI % 6].y }; }
+
+/// <summary>Cartesian to legacy hex coordinates (u, v) = (-s, r) of the fractional cube (HexCubeFromXY() in hex.h)</summary>
+inline float2 HexTilesUV(float fX, float fY)
+{
+	const HexFrac<float> sF = HexCubeFromXY(fX, fY);
+	return float2{ -sF.s, sF.r };
+}
+
+/// <summary>
+/// Cartesian center of the hex tile at position xy (cube rounding), provides the hex coordinates (uv)
+/// and the hex coordinates of the center (uvc)
+/// </summary>
+inline float2 HexTilesCenter(float fX, float fY, float2& sUV, float2& sUVc)
+{
+	const HexCube sC = HexCubeAt(fX, fY);
+	const HexVec<float> sUVi = HexCubeToUV<float>(sC), sXY = HexCubeToXY<float>(sC);
+	sUV = HexTilesUV(fX, fY);
+	sUVc = float2{ sUVi.x, sUVi.y };
+	return float2{ sXY.x, sXY.y };
+}
+
+/// <summary>xy offset of a tile by instance index (0 = main hexagon), closed form (see hex.h)</summary>
+inline float2 HexTileOffset(unsigned uInstIx, float fTileSz)
+{
+	const HexVec<float> sXY = HexCubeToXY(HexCubeFromIndex(uInstIx), fTileSz);
+	return float2{ sXY.x, sXY.y };
+}
+
+/// <summary>
+/// Create the tile offsets in parallel, xy - offset, z - tile index (as float for compute shader)
+/// tiles [uInstN, uAlignedN) are padding and keep zero offset
+/// </summary>
+template <typename T4>
+void HexTilesLayout(std::vector<T4>& asTilePos, unsigned uInstN, unsigned uAlignedN, float fTileSz, App_Jobsystem& cJobs)
+{
+	asTilePos.resize(uAlignedN);
+	cJobs.ParallelFor(0, uAlignedN, 1024, [&](size_t uB, size_t uE)
+		{
+			for (size_t uI = uB; uI < uE; uI++)
+			{
+				float2 sOffset = (uI < uInstN) ? HexTileOffset((unsigned)uI, fTileSz) : float2{ 0.f, 0.f };
+				asTilePos[uI] = T4{ sOffset.x, sOffset.y, (float)uI, 0.f };
+			}
+		});
+}
+
+/// <summary>
+/// Number of replicated tiles per draw (base vertex offset per batch) so that all indices of a batch,
+/// including the base tile, fit to 16 bit (uInstN if they do anyway)
+/// </summary>
+constexpr unsigned HexTilesBatchN(unsigned uBaseVtcN, unsigned uInstN)
+{
+	return (uBaseVtcN * (uInstN + 1ull) <= 0x10000) ? uInstN : (std::max)(0x10000u / uBaseVtcN, 2u) - 1;
+}
+
+/// <summary>
+/// Replicate the base tile (first uBaseVtcN vertices, uBaseIdcN indices) uInstN times in parallel,
+/// the vertices keep zero offset (set by compute shader), indices are offset by the instance.
+/// Indices are replicated for the first uIdcInstN tiles only (tile batches drawn with base vertex).
+/// </summary>
+template <typename T>
+void HexTilesReplicate(std::vector<T>& asVtc, std::vector<uint32_t>& auIdc, unsigned uBaseVtcN, unsigned uBaseIdcN, unsigned uInstN, App_Jobsystem& cJobs,
+	unsigned uIdcInstN = ~0u)
+{
+	uIdcInstN = (std::min)(uIdcInstN, uInstN);
+	asVtc.resize((size_t)uBaseVtcN * (uInstN + 1));
+	auIdc.resize((size_t)uBaseIdcN * (uIdcInstN + 1));
+	cJobs.ParallelFor(1, (size_t)uInstN + 1, 256, [&](size_t uB, size_t uE)
+		{
+			for (size_t uI = uB; uI < uE; uI++)
+			{
+				std::copy(asVtc.begin(), asVtc.begin() + uBaseVtcN, asVtc.begin() + uI * uBaseVtcN);
+				if (uI > uIdcInstN) continue;
+				for (size_t uJ(0); uJ < uBaseIdcN; uJ++)
+					auIdc[uI * uBaseIdcN + uJ] = auIdc[uJ] + (uint32_t)(uI * uBaseVtcN);
+			}
+		});
+}
+
+/// <summary>
+/// Move all tiles off rim (cube distance to the new center sXY > uAmbitN) to the opposite rim,
+/// mirrored at the old center sXYc (full scan, see HexTilesRecycler for the incremental update). Tiles are tested in parallel (batches of 64, SIMD cube rounding),
+/// the moved tiles are appended to asUpdate in index order (deterministic). Returns the number of moved tiles.
+/// </summary>
+template <typename T4>
+unsigned HexTilesRecycle(std::vector<T4>& asTilePos, std::vector<T4>& asUpdate, std::vector<uint8_t>& auRecycled,
+	float2 sXY, float2 sXYc, unsigned uAmbitN, unsigned uInstN, App_Jobsystem& cJobs)
+{
+	const size_t uN = (std::min)((size_t)uInstN, asTilePos.size());
+	auRecycled.resize(uN);
+
+	// test and move
+	unsigned uMovedN = cJobs.ParallelReduce(0, uN, 1024, 0u, [&](size_t uB, size_t uE)
+		{
+			constexpr size_t uBatchN = 64;
+			float afX[uBatchN], afY[uBatchN];
+			HexCube asCube[uBatchN];
+			unsigned uCnt = 0;
+			for (size_t uB0 = uB; uB0 < uE; uB0 += uBatchN)
+			{
+				// get tile cube coords relative to new center
+				const size_t uN = (std::min)(uBatchN, uE - uB0);
+				for (size_t uI(0); uI < uN; uI++)
+				{
+					afX[uI] = asTilePos[uB0 + uI].x - sXY.x;
+					afY[uI] = asTilePos[uB0 + uI].y - sXY.y;
+				}
+				HexCubeAtBatch(afX, afY, uN, asCube);
+
+				for (size_t uI(0); uI < uN; uI++)
+				{
+					// off rim ? negate offset to old center, add center movement
+					const size_t uIx = uB0 + uI;
+					auRecycled[uIx] = (HexCubeLength(asCube[uI]) > (int32_t)uAmbitN) ? 1 : 0;
+					if (auRecycled[uIx])
+					{
+						T4& sTile = asTilePos[uIx];
+						sTile.x = sXYc.x - (sTile.x - sXYc.x) + (sXY.x - sXYc.x);
+						sTile.y = sXYc.y - (sTile.y - sXYc.y) + (sXY.y - sXYc.y);
+						uCnt++;
+					}
+				}
+			}
+			return uCnt;
+		}, [](unsigned uA, unsigned uB) { return uA + uB; });
+
+	// add to update tiles
+	if (uMovedN)
+	{
+		asUpdate.reserve(asUpdate.size() + uMovedN);
+		for (size_t uIx(0); uIx < uN; uIx++)
+			if (auRecycled[uIx]) asUpdate.push_back(asTilePos[uIx]);
+	}
+	return uMovedN;
+}
+
+/// <summary>
+/// Runs of tile indices (z) in the update tiles (tile index order as appended by the recyclers),
+/// calls fRun(first index, number of tiles) per run, tiles >= uInstN are skipped. Runs closer than
+/// uGapN tiles are merged (the gap is copied along, source must mirror all tiles).
+/// Returns the number of runs.
+/// </summary>
+template <typename T4, typename F>
+unsigned HexTilesUpdateRuns(const std::vector<T4>& asUpdate, unsigned uInstN, unsigned uGapN, F&& fRun)
+{
+	unsigned uRunN = 0, uFirst = 0, uN = 0;
+	for (const T4& sTile : asUpdate)
+	{
+		const unsigned uIx = (unsigned)sTile.z;
+		if (uIx >= uInstN) continue;
+		if (uN && (uIx >= uFirst + uN) && (uIx <= uFirst + uN + uGapN)) { uN = uIx - uFirst + 1; continue; }
+		if (uN) { fRun(uFirst, uN); uRunN++; }
+		uFirst = uIx;
+		uN = 1;
+	}
+	if (uN) { fRun(uFirst, uN); uRunN++; }
+	return uRunN;
+}
+
+/// <summary>gpu memory of the tile meshes in bytes (vertex, index, tile offset and its upload buffer)</summary>
+struct HexTilesMemory
+{
+	uint64_t uVtxB, uIdxB, uOffsetB, uUploadB;
+	uint64_t Total() const { return uVtxB + uIdxB + uOffsetB + uUploadB; }
+};
+
+/// <summary>
+/// Memory of the tile meshes : replicated (base tile + uInstN copies) or instanced (base tile only),
+/// indices 32 bit for all tiles or 16 bit (per tile batch, see HexTilesBatchN()), offsets are float4
+/// per tile (16 bytes), buffers 256 byte aligned (as Align8Bit())
+/// </summary>
+inline HexTilesMemory HexTilesMemoryFor(unsigned uAmbitN, unsigned uBaseVtcN, unsigned uBaseIdcN, unsigned uVtxStride, bool bInstanced, bool bIdx16)
+{
+	auto fAlign = [](uint64_t uB) { return (uB + 255) & ~255ull; };
+	const uint64_t uInstN = HexTilesN(uAmbitN), uCopyN = bInstanced ? 1 : uInstN + 1;
+	const uint64_t uIdcCopyN = (bInstanced || !bIdx16) ? uCopyN : HexTilesBatchN(uBaseVtcN, (unsigned)uInstN) + 1ull;
+	const uint64_t uOffsetB = fAlign(uInstN * 16);
+	return HexTilesMemory{ fAlign(uCopyN * uBaseVtcN * uVtxStride), fAlign(uIdcCopyN * uBaseIdcN * (bIdx16 ? 2 : 4)), uOffsetB, uOffsetB };
+}
+
+/// <summary>
+/// Incremental tile recycler : keeps the tiles on the hexagon of uAmbitN rings around the center hex.
+/// The tile slot of a hex is found by its wrapped index (HexCubeWrap()), so a step to a neighbour
+/// hex rewrites the 2 * uAmbitN + 1 entering tiles (one ring segment) only, nothing if the center
+/// remains, far jumps place all tiles. Produces the same tile set as HexTilesRecycle() (tile size 1).
+/// </summary>
+class HexTilesRecycler
+{
+public:
+	/// <summary>init by the current tile positions (hexagon around sXYc, as HexTilesLayout())</summary>
+	template <typename T4>
+	void Init(const std::vector<T4>& asTilePos, float2 sXYc, unsigned uAmbitN, unsigned uInstN)
+	{
+		m_uAmbitN = uAmbitN;
+		m_sCenter = HexCubeAt(sXYc.x, sXYc.y);
+		m_auSlot.assign(HexTilesN(uAmbitN), 0);
+		m_auMoved.clear();
+		m_auMoved.reserve(HexTilesN(uAmbitN));
+		for (unsigned uI(0); uI < (std::min)((size_t)uInstN, asTilePos.size()); uI++)
+			m_auSlot[HexCubeWrap(HexCubeAt(asTilePos[uI].x, asTilePos[uI].y), uAmbitN)] = uI;
+	}
+
+	/// <summary>
+	/// Move the tiles to the hexagon around the new center sXY, moved tiles are appended to asUpdate
+	/// (unique). Returns the number of moved tiles.
+	/// </summary>
+	template <typename T4>
+	unsigned Recycle(std::vector<T4>& asTilePos, std::vector<T4>& asUpdate, float2 sXY)
+	{
+		const HexCube sTarget = HexCubeAt(sXY.x, sXY.y);
+		const int32_t nStepN = HexCubeDistance(m_sCenter, sTarget);
+		if (!nStepN) return 0;
+
+		m_auMoved.clear();
+		if ((uint64_t)nStepN * (2 * m_uAmbitN + 1) >= HexTilesN(m_uAmbitN))
+		{
+			// far jump, place all tiles
+			m_sCenter = sTarget;
+			for (uint64_t uIx(0); uIx < HexTilesN(m_uAmbitN); uIx++)
+				Place(asTilePos, m_sCenter + HexCubeFromIndex(uIx));
+		}
+		else
+		{
+			// step to the neighbour hexes, place the tiles entering at ring uAmbitN
+			while (m_sCenter != sTarget)
+			{
+				unsigned uDir = 0;
+				while (HexCubeDistance(HexCubeNext(m_sCenter, uDir), sTarget) >= HexCubeDistance(m_sCenter, sTarget)) uDir++;
+				const HexCube sOld = m_sCenter;
+				m_sCenter = HexCubeNext(m_sCenter, uDir);
+
+				// entering tiles are on ring uAmbitN from corner uDir - 1 to corner uDir + 1 (2 * uAmbitN + 1)
+				const int32_t nN = (int32_t)m_uAmbitN;
+				for (uint32_t uSide : { (uDir + 5) % 6, uDir, (uDir + 1) % 6 })
+					for (uint32_t uStep(0); uStep < m_uAmbitN; uStep++)
+					{
+						const HexCube sC = m_sCenter + HexCubeFromRing(HexRing{ m_uAmbitN, uSide, uStep });
+						if (HexCubeDistance(sC, sOld) > nN) Place(asTilePos, sC);
+					}
+			}
+		}
+
+		// add to update tiles, each tile once in index order
+		std::sort(m_auMoved.begin(), m_auMoved.end());
+		m_auMoved.erase(std::unique(m_auMoved.begin(), m_auMoved.end()), m_auMoved.end());
+		asUpdate.reserve(asUpdate.size() + m_auMoved.size());
+		for (uint32_t uIx : m_auMoved) asUpdate.push_back(asTilePos[uIx]);
+		return (unsigned)m_auMoved.size();
+	}
+
+	/// <summary>current center hex</summary>
+	const HexCube& Center() const { return m_sCenter; }
+
+private:
+	/// <summary>place the hex to its tile slot</summary>
+	template <typename T4>
+	void Place(std::vector<T4>& asTilePos, const HexCube& sC)
+	{
+		const uint32_t uIx = m_auSlot[HexCubeWrap(sC, m_uAmbitN)];
+		const HexVec<float> sXY = HexCubeToXY<float>(sC);
+		asTilePos[uIx].x = sXY.x;
+		asTilePos[uIx].y = sXY.y;
+		m_auMoved.push_back(uIx);
+	}
+
+	/// <summary>number of rings, center hex</summary>
+	unsigned m_uAmbitN = 0;
+	HexCube m_sCenter = {};
+	/// <summary>tile index by wrapped hex index</summary>
+	std::vector<uint32_t> m_auSlot;
+	/// <summary>tiles placed during the last update</summary>
+	std::vector<uint32_t> m_auMoved;
+};
+
+#endif // _ZONE_TILES